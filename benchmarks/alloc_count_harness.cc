@@ -0,0 +1,151 @@
+// Counts the heap allocations made by the calling thread of a steady state choose_rank and fails when the average
+// per decision goes over a budget. Only the calling thread is counted, the background batcher may allocate freely.
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include "api_status.h"
+#include "config_utility.h"
+#include "constants.h"
+#include "err_constants.h"
+#include "live_model.h"
+#include "ranking_response.h"
+
+#include "benchmarks_common.h"
+
+namespace r = reinforcement_learning;
+namespace u = reinforcement_learning::utility;
+namespace cfg = reinforcement_learning::utility::config;
+namespace po = boost::program_options;
+
+namespace {
+  thread_local bool counting = false;
+  thread_local size_t allocation_count = 0;
+}
+
+// operator new[] and the nothrow variants forward to this one
+void* operator new(std::size_t size) {
+  if (counting) {
+    ++allocation_count;
+  }
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+const auto JSON_CFG = R"(
+{
+  "ApplicationID": "rnc-123456-a",
+  "IsExplorationEnabled": true,
+  "InitialExplorationEpsilon": 1.0
+}
+)";
+
+const int BATCH_INTERVAL_MS = 10;
+
+po::variables_map process_cmd_line(const int argc, char** argv, bool& help) {
+  po::options_description desc("Options");
+  desc.add_options()
+    ("help", "produce help message")
+    ("model,m", po::value<std::string>(), "VW model file used to rank, explore only when not set")
+    ("warmup,w", po::value<size_t>()->default_value(1000), "Decisions made before counting")
+    ("decisions,n", po::value<size_t>()->default_value(1000), "Decisions counted")
+    ("actions,a", po::value<int>()->default_value(10), "Actions per decision")
+    ("max-allocs-per-decision", po::value<double>()->default_value(0.0),
+      "Fail when the average allocation count per decision is above this budget")
+    ;
+
+  po::variables_map vm;
+  store(parse_command_line(argc, argv, desc), vm);
+  help = vm.count("help") > 0;
+  if (help) {
+    std::cout << desc << std::endl;
+  }
+  return vm;
+}
+
+int run_decisions(r::live_model& model, const std::vector<std::string>& contexts, size_t count, r::ranking_response& response) {
+  r::api_status status;
+  for (size_t i = 0; i < count; ++i) {
+    if (model.choose_rank(contexts[i % contexts.size()].c_str(), response, &status) != r::error_code::success) {
+      std::cerr << "choose_rank failed: " << status.get_error_msg() << std::endl;
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  try {
+    bool help;
+    const auto vm = process_cmd_line(argc, argv, help);
+    if (help) return 0;
+
+    u::configuration config;
+    cfg::create_from_json(JSON_CFG, config);
+    config.set(r::name::PROTOCOL_VERSION, "2");
+    config.set(r::name::INTERACTION_SENDER_IMPLEMENTATION, r::value::INTERACTION_FILE_SENDER);
+    config.set(r::name::OBSERVATION_SENDER_IMPLEMENTATION, r::value::OBSERVATION_FILE_SENDER);
+    config.set(r::name::INTERACTION_FILE_NAME, "/dev/null");
+    config.set(r::name::OBSERVATION_FILE_NAME, "/dev/null");
+    config.set(r::name::INTERACTION_SEND_BATCH_INTERVAL_MS, std::to_string(BATCH_INTERVAL_MS).c_str());
+    config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+    config.set(r::name::QUEUE_MODE, r::value::QUEUE_MODE_BLOCK);
+    if (vm.count("model")) {
+      config.set(r::name::MODEL_SRC, r::value::FILE_MODEL_DATA);
+      config.set(r::name::MODEL_FILE_NAME, vm["model"].as<std::string>().c_str());
+      config.set(r::name::VW_POOL_INIT_SIZE, "1");
+    }
+    else {
+      config.set(r::name::MODEL_SRC, r::value::NO_MODEL_DATA);
+    }
+
+    const int actions = vm["actions"].as<int>();
+    cb_decision_gen gen(20, 10, actions, actions * 10, 0, false);
+    std::vector<std::string> contexts;
+    for (int i = 0; i < 100; ++i) {
+      contexts.push_back(gen.gen_example());
+    }
+
+    r::api_status status;
+    r::live_model model(config);
+    if (model.init(&status) != r::error_code::success) {
+      std::cerr << "live_model init failed: " << status.get_error_msg() << std::endl;
+      return -1;
+    }
+
+    r::ranking_response response;
+    if (run_decisions(model, contexts, vm["warmup"].as<size_t>(), response) != 0) return -1;
+    // let the batcher ship the warmup events so that their payload buffers go back to the pool
+    std::this_thread::sleep_for(std::chrono::milliseconds(20 * BATCH_INTERVAL_MS));
+
+    const size_t decisions = vm["decisions"].as<size_t>();
+    allocation_count = 0;
+    counting = true;
+    const int result = run_decisions(model, contexts, decisions, response);
+    counting = false;
+    if (result != 0) return -1;
+
+    const double per_decision = decisions == 0 ? 0. : static_cast<double>(allocation_count) / decisions;
+    const double budget = vm["max-allocs-per-decision"].as<double>();
+    std::cout << "allocations per decision: " << per_decision << " (budget " << budget << ")" << std::endl;
+    if (per_decision > budget) {
+      std::cerr << "allocation count regressed" << std::endl;
+      return 1;
+    }
+  }
+  catch (const std::exception& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    return -1;
+  }
+  return 0;
+}
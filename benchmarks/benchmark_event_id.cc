@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <boost/uuid/random_generator.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include "event_id_generators.h"
+
+namespace r = reinforcement_learning;
+
+// What the auto-id decision overloads used to do for every call: seed a generator from the OS entropy
+// source and format the id into a std::string.
+static void bench_event_id_boost_random_generator(benchmark::State& state) {
+  for (auto _ : state) {
+    const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
+    benchmark::DoNotOptimize(uuid.data());
+  }
+}
+
+static void bench_event_id_generator(benchmark::State& state, r::i_event_id_generator& generator) {
+  char buffer[r::EVENT_ID_MAX_SIZE];
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(generator.generate(buffer));
+    benchmark::ClobberMemory();
+  }
+}
+
+static void bench_event_id_uuid4(benchmark::State& state) {
+  static r::uuid4_event_id_generator generator;
+  bench_event_id_generator(state, generator);
+}
+
+static void bench_event_id_counter(benchmark::State& state) {
+  static r::counter_event_id_generator generator;
+  bench_event_id_generator(state, generator);
+}
+
+BENCHMARK(bench_event_id_boost_random_generator)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(bench_event_id_uuid4)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(bench_event_id_counter)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "configuration.h"
+#include "err_constants.h"
+#include "logger/file/async_file_logger.h"
+#include "logger/file/file_logger.h"
+
+namespace r = reinforcement_learning;
+namespace u = reinforcement_learning::utility;
+namespace f = reinforcement_learning::logger::file;
+
+namespace {
+  const char* const FILE_NAME = "benchmark_file_sender.fb.data";
+
+  std::vector<r::i_sender::buffer> make_batches(size_t count, size_t body_size) {
+    std::vector<r::i_sender::buffer> batches;
+    for (size_t i = 0; i < count; ++i) {
+      auto db = std::make_shared<u::data_buffer>(body_size);
+      std::fill(db->preamble_begin(), db->body_begin() + body_size, static_cast<unsigned char>(i));
+      db->set_body_endoffset(db->preamble_size() + body_size);
+      batches.push_back(db);
+    }
+    return batches;
+  }
+
+  // one iteration opens the file, sends range(1) batches of range(0) bytes and closes it, which waits for the
+  // async senders to be done writing
+  template <typename create_fn>
+  void bench_file_sender(benchmark::State& state, create_fn create) {
+    const auto batches = make_batches(static_cast<size_t>(state.range(1)), static_cast<size_t>(state.range(0)));
+    u::configuration config;
+    for (auto _ : state) {
+      std::unique_ptr<r::i_sender> sender(create());
+      if (sender->init(config, nullptr) != r::error_code::success) {
+        state.SkipWithError("cannot open the file");
+        break;
+      }
+      for (const auto& batch : batches) {
+        sender->send(batch);
+      }
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * state.range(0) * state.range(1));
+    std::remove(FILE_NAME);
+  }
+
+  void bench_async_file_sender(benchmark::State& state, r::file_durability_enum durability) {
+    u::file_sender_config sender_config;
+    sender_config.durability = durability;
+    sender_config.sync_interval_ms = 10;
+    bench_file_sender(state, [&sender_config] { return new f::async_file_logger(FILE_NAME, sender_config, nullptr, nullptr); });
+  }
+}
+
+static void bench_file_logger(benchmark::State& state) {
+  bench_file_sender(state, [] { return new f::file_logger(FILE_NAME, nullptr); });
+}
+
+static void bench_async_file_logger_no_sync(benchmark::State& state) {
+  bench_async_file_sender(state, r::file_durability_enum::NONE);
+}
+
+static void bench_async_file_logger_interval_sync(benchmark::State& state) {
+  bench_async_file_sender(state, r::file_durability_enum::INTERVAL);
+}
+
+static void bench_async_file_logger_batch_sync(benchmark::State& state) {
+  bench_async_file_sender(state, r::file_durability_enum::BATCH);
+}
+
+// batch body size, batches per file
+static void file_sender_args(benchmark::internal::Benchmark* b) {
+  b->Args({ 1024, 1024 })->Args({ 64 * 1024, 256 })->Args({ 1024 * 1024, 16 })->UseRealTime();
+}
+
+BENCHMARK(bench_file_logger)->Apply(file_sender_args);
+BENCHMARK(bench_async_file_logger_no_sync)->Apply(file_sender_args);
+BENCHMARK(bench_async_file_logger_interval_sync)->Apply(file_sender_args);
+BENCHMARK(bench_async_file_logger_batch_sync)->Apply(file_sender_args);
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "configuration.h"
+#include "constants.h"
+#include "err_constants.h"
+#include "logger/http_transport_client.h"
+#include "logger/preamble.h"
+#include "utility/header_authorization.h"
+#include "utility/timer_queue.h"
+
+namespace r = reinforcement_learning;
+namespace u = reinforcement_learning::utility;
+
+namespace {
+  using bench_clock = std::chrono::steady_clock;
+
+  // latencies in microseconds, recorded from any thread
+  class latency_recorder {
+  public:
+    void add(bench_clock::duration latency) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _samples.push_back(std::chrono::duration<double, std::micro>(latency).count());
+    }
+
+    void report(benchmark::State& state, const std::string& prefix) {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_samples.empty()) return;
+      std::sort(_samples.begin(), _samples.end());
+      state.counters[prefix + "_p50_us"] = _samples[_samples.size() / 2];
+      state.counters[prefix + "_p99_us"] = _samples[_samples.size() * 99 / 100];
+      state.counters[prefix + "_max_us"] = _samples.back();
+    }
+
+  private:
+    std::mutex _mutex;
+    std::vector<double> _samples;
+  };
+
+  // Stands in for the remote endpoint over an already open connection: every POST gets its 201 after a fixed
+  // latency. The body starts with the time the batch was handed to send, so the delivery latency counts the time
+  // spent queued behind the window too.
+  class delayed_http_client : public r::i_http_client {
+  public:
+    delayed_http_client(std::chrono::microseconds latency, latency_recorder& delivered)
+      : _latency(latency), _delivered(delivered) {}
+
+    const std::string& get_url() const override { return _url; }
+
+    response_t request(method_t method) override {
+      request_t req(method);
+      return request(req);
+    }
+
+    response_t request(request_t req) override {
+      const auto body = req.extract_vector().get();
+      bench_clock::rep sent = 0;
+      std::memcpy(&sent, body.data() + r::logger::preamble::size(), sizeof(sent));
+
+      pplx::task_completion_event<web::http::http_response> response;
+      auto& delivered = _delivered;
+      _timer.schedule(_latency, [response, sent, &delivered] {
+        delivered.add(bench_clock::now() - bench_clock::time_point(bench_clock::duration(sent)));
+        response.set(web::http::http_response(web::http::status_codes::Created));
+      });
+      return pplx::create_task(response);
+    }
+
+  private:
+    const std::string _url = "http://localhost/benchmark";
+    const std::chrono::microseconds _latency;
+    latency_recorder& _delivered;
+    u::timer_queue _timer;
+  };
+
+  std::shared_ptr<u::data_buffer> make_batch(size_t body_size) {
+    auto db = std::make_shared<u::data_buffer>(body_size);
+    std::fill(db->preamble_begin(), db->body_begin() + body_size, static_cast<unsigned char>(0));
+    db->set_body_endoffset(db->preamble_size() + body_size);
+    return db;
+  }
+}
+
+// sends range(2) batches of range(0) bytes per iteration to an endpoint answering after 2ms, with a window of
+// range(1) requests in flight; the client is destroyed at the end of the iteration, which waits for the responses
+static void bench_http_sender(benchmark::State& state) {
+  const size_t body_size = static_cast<size_t>(state.range(0));
+  const size_t window = static_cast<size_t>(state.range(1));
+  const size_t batches = static_cast<size_t>(state.range(2));
+
+  u::configuration config;
+  config.set(r::name::HTTP_API_KEY, "benchmark");
+
+  latency_recorder send_latency;
+  latency_recorder delivery_latency;
+  for (auto _ : state) {
+    auto* client = new delayed_http_client(std::chrono::microseconds(2000), delivery_latency);
+    r::http_transport_client<r::header_authorization> sender(client, window, 0, nullptr, nullptr);
+    if (sender.init(config, nullptr) != r::error_code::success) {
+      state.SkipWithError("cannot init the sender");
+      break;
+    }
+    for (size_t i = 0; i < batches; ++i) {
+      auto batch = make_batch(body_size);
+      const auto start = bench_clock::now();
+      const auto sent = start.time_since_epoch().count();
+      std::memcpy(batch->body_begin(), &sent, sizeof(sent));
+      sender.send(batch);
+      send_latency.add(bench_clock::now() - start);
+    }
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * body_size * batches));
+  send_latency.report(state, "send");
+  delivery_latency.report(state, "delivery");
+}
+
+// batch body size, requests in flight, batches per iteration
+BENCHMARK(bench_http_sender)
+  ->Args({ 16 * 1024, 1, 64 })
+  ->Args({ 16 * 1024, 4, 64 })
+  ->Args({ 16 * 1024, 16, 256 })
+  ->Args({ 256 * 1024, 16, 64 })
+  ->UseRealTime();
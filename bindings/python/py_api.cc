@@ -333,6 +333,8 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("MODEL_VW_INITIAL_COMMAND_LINE", [](py::object /*self*/) { return rl::name::MODEL_VW_INITIAL_COMMAND_LINE; })
     .def_property_readonly_static("VW_CMDLINE", [](py::object /*self*/) { return rl::name::VW_CMDLINE; })
     .def_property_readonly_static("VW_POOL_INIT_SIZE", [](py::object /*self*/) { return rl::name::VW_POOL_INIT_SIZE; })
+    .def_property_readonly_static("VW_POOL_SHARED_WEIGHTS", [](py::object /*self*/) { return rl::name::VW_POOL_SHARED_WEIGHTS; })
+    .def_property_readonly_static("VW_ACTION_CACHE_CAPACITY", [](py::object /*self*/) { return rl::name::VW_ACTION_CACHE_CAPACITY; })
     .def_property_readonly_static("INITIAL_EPSILON", [](py::object /*self*/) { return rl::name::INITIAL_EPSILON; })
     .def_property_readonly_static("LEARNING_MODE", [](py::object /*self*/) { return rl::name::LEARNING_MODE; })
     .def_property_readonly_static("PROTOCOL_VERSION", [](py::object /*self*/) { return rl::name::PROTOCOL_VERSION; })
@@ -344,9 +346,13 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("INTERACTION_EH_MAX_HTTP_RETRIES", [](py::object /*self*/) { return rl::name::INTERACTION_EH_MAX_HTTP_RETRIES; })
     .def_property_readonly_static("INTERACTION_SEND_HIGH_WATER_MARK", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_HIGH_WATER_MARK; })
     .def_property_readonly_static("INTERACTION_SEND_QUEUE_MAX_CAPACITY_KB", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_QUEUE_MAX_CAPACITY_KB; })
+    .def_property_readonly_static("INTERACTION_SEND_QUEUE_MAX_EVENTS", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_QUEUE_MAX_EVENTS; })
+    .def_property_readonly_static("INTERACTION_SEND_QUEUE_FLUSH_FRACTION", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_QUEUE_FLUSH_FRACTION; })
+    .def_property_readonly_static("INTERACTION_SEND_BATCHER_SHARDS", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_BATCHER_SHARDS; })
     .def_property_readonly_static("INTERACTION_SEND_BATCH_INTERVAL_MS", [](py::object /*self*/) { return rl::name::INTERACTION_SEND_BATCH_INTERVAL_MS; })
     .def_property_readonly_static("INTERACTION_SENDER_IMPLEMENTATION", [](py::object /*self*/) { return rl::name::INTERACTION_SENDER_IMPLEMENTATION; })
     .def_property_readonly_static("INTERACTION_USE_COMPRESSION", [](py::object /*self*/) { return rl::name::INTERACTION_USE_COMPRESSION; })
+    .def_property_readonly_static("INTERACTION_USE_BATCH_COMPRESSION", [](py::object /*self*/) { return rl::name::INTERACTION_USE_BATCH_COMPRESSION; })
     .def_property_readonly_static("INTERACTION_USE_DEDUP", [](py::object /*self*/) { return rl::name::INTERACTION_USE_DEDUP; })
     .def_property_readonly_static("INTERACTION_QUEUE_MODE", [](py::object /*self*/) { return rl::name::INTERACTION_QUEUE_MODE; })
     .def_property_readonly_static("OBSERVATION_EH_HOST", [](py::object /*self*/) { return rl::name::OBSERVATION_EH_HOST; })
@@ -357,16 +363,25 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("OBSERVATION_EH_MAX_HTTP_RETRIES", [](py::object /*self*/) { return rl::name::OBSERVATION_EH_MAX_HTTP_RETRIES; })
     .def_property_readonly_static("OBSERVATION_SEND_HIGH_WATER_MARK", [](py::object /*self*/) { return rl::name::OBSERVATION_SEND_HIGH_WATER_MARK; })
     .def_property_readonly_static("OBSERVATION_SEND_QUEUE_MAX_CAPACITY_KB", [](py::object /*self*/) { return rl::name::OBSERVATION_SEND_QUEUE_MAX_CAPACITY_KB; })
+    .def_property_readonly_static("OBSERVATION_SEND_QUEUE_MAX_EVENTS", [](py::object /*self*/) { return rl::name::OBSERVATION_SEND_QUEUE_MAX_EVENTS; })
+    .def_property_readonly_static("OBSERVATION_SEND_QUEUE_FLUSH_FRACTION", [](py::object /*self*/) { return rl::name::OBSERVATION_SEND_QUEUE_FLUSH_FRACTION; })
     .def_property_readonly_static("OBSERVATION_SEND_BATCH_INTERVAL_MS", [](py::object /*self*/) { return rl::name::OBSERVATION_SEND_BATCH_INTERVAL_MS; })
     .def_property_readonly_static("OBSERVATION_SENDER_IMPLEMENTATION", [](py::object /*self*/) { return rl::name::OBSERVATION_SENDER_IMPLEMENTATION; })
     .def_property_readonly_static("OBSERVATION_USE_COMPRESSION", [](py::object /*self*/) { return rl::name::OBSERVATION_USE_COMPRESSION; })
+    .def_property_readonly_static("OBSERVATION_USE_BATCH_COMPRESSION", [](py::object /*self*/) { return rl::name::OBSERVATION_USE_BATCH_COMPRESSION; })
     .def_property_readonly_static("OBSERVATION_QUEUE_MODE", [](py::object /*self*/) { return rl::name::OBSERVATION_QUEUE_MODE; })
     .def_property_readonly_static("SEND_HIGH_WATER_MARK", [](py::object /*self*/) { return rl::name::SEND_HIGH_WATER_MARK; })
     .def_property_readonly_static("SEND_QUEUE_MAX_CAPACITY_KB", [](py::object /*self*/) { return rl::name::SEND_QUEUE_MAX_CAPACITY_KB; })
+    .def_property_readonly_static("SEND_QUEUE_MAX_EVENTS", [](py::object /*self*/) { return rl::name::SEND_QUEUE_MAX_EVENTS; })
+    .def_property_readonly_static("SEND_QUEUE_FLUSH_FRACTION", [](py::object /*self*/) { return rl::name::SEND_QUEUE_FLUSH_FRACTION; })
+    .def_property_readonly_static("SEND_BATCHER_SHARDS", [](py::object /*self*/) { return rl::name::SEND_BATCHER_SHARDS; })
     .def_property_readonly_static("SEND_BATCH_INTERVAL_MS", [](py::object /*self*/) { return rl::name::SEND_BATCH_INTERVAL_MS; })
     .def_property_readonly_static("USE_COMPRESSION", [](py::object /*self*/) { return rl::name::USE_COMPRESSION; })
+    .def_property_readonly_static("USE_BATCH_COMPRESSION", [](py::object /*self*/) { return rl::name::USE_BATCH_COMPRESSION; })
     .def_property_readonly_static("USE_DEDUP", [](py::object /*self*/) { return rl::name::USE_DEDUP; })
     .def_property_readonly_static("QUEUE_MODE", [](py::object /*self*/) { return rl::name::QUEUE_MODE; })
+    .def_property_readonly_static("BUFFER_POOL_MAX_KB", [](py::object /*self*/) { return rl::name::BUFFER_POOL_MAX_KB; })
+    .def_property_readonly_static("BUFFER_POOL_IDLE_MS", [](py::object /*self*/) { return rl::name::BUFFER_POOL_IDLE_MS; })
     .def_property_readonly_static("EH_TEST", [](py::object /*self*/) { return rl::name::EH_TEST; })
     .def_property_readonly_static("TRACE_LOG_IMPLEMENTATION", [](py::object /*self*/) { return rl::name::TRACE_LOG_IMPLEMENTATION; })
     .def_property_readonly_static("INTERACTION_FILE_NAME", [](py::object /*self*/) { return rl::name::INTERACTION_FILE_NAME; })
@@ -374,9 +389,26 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("TIME_PROVIDER_IMPLEMENTATION", [](py::object /*self*/) { return rl::name::TIME_PROVIDER_IMPLEMENTATION; })
     .def_property_readonly_static("HTTP_CLIENT_DISABLE_CERT_VALIDATION", [](py::object /*self*/) { return rl::name::HTTP_CLIENT_DISABLE_CERT_VALIDATION; })
     .def_property_readonly_static("HTTP_CLIENT_TIMEOUT", [](py::object /*self*/) { return rl::name::HTTP_CLIENT_TIMEOUT; })
+    .def_property_readonly_static("HTTP_RETRY_MIN_DELAY_MS", [](py::object /*self*/) { return rl::name::HTTP_RETRY_MIN_DELAY_MS; })
+    .def_property_readonly_static("HTTP_RETRY_MAX_DELAY_MS", [](py::object /*self*/) { return rl::name::HTTP_RETRY_MAX_DELAY_MS; })
     .def_property_readonly_static("MODEL_FILE_NAME", [](py::object /*self*/) { return rl::name::MODEL_FILE_NAME; })
     .def_property_readonly_static("MODEL_FILE_MUST_EXIST", [](py::object /*self*/) { return rl::name::MODEL_FILE_MUST_EXIST; })
     .def_property_readonly_static("ZSTD_COMPRESSION_LEVEL", [](py::object /*self*/) { return rl::name::ZSTD_COMPRESSION_LEVEL; })
+    .def_property_readonly_static("ZSTD_DICTIONARY_FILE", [](py::object /*self*/) { return rl::name::ZSTD_DICTIONARY_FILE; })
+    .def_property_readonly_static("ZSTD_ADAPTIVE_LEVEL", [](py::object /*self*/) { return rl::name::ZSTD_ADAPTIVE_LEVEL; })
+    .def_property_readonly_static("ZSTD_MIN_COMPRESSION_LEVEL", [](py::object /*self*/) { return rl::name::ZSTD_MIN_COMPRESSION_LEVEL; })
+    .def_property_readonly_static("ZSTD_MAX_COMPRESSION_LEVEL", [](py::object /*self*/) { return rl::name::ZSTD_MAX_COMPRESSION_LEVEL; })
+    .def_property_readonly_static("SPOOL_DIRECTORY", [](py::object /*self*/) { return rl::name::SPOOL_DIRECTORY; })
+    .def_property_readonly_static("SPOOL_SEGMENT_SIZE_KB", [](py::object /*self*/) { return rl::name::SPOOL_SEGMENT_SIZE_KB; })
+    .def_property_readonly_static("SPOOL_MAX_DISK_MB", [](py::object /*self*/) { return rl::name::SPOOL_MAX_DISK_MB; })
+    .def_property_readonly_static("SPOOL_SEND_DEADLINE_MS", [](py::object /*self*/) { return rl::name::SPOOL_SEND_DEADLINE_MS; })
+    .def_property_readonly_static("SPOOL_MAX_PENDING_BATCHES", [](py::object /*self*/) { return rl::name::SPOOL_MAX_PENDING_BATCHES; })
+    .def_property_readonly_static("SPOOL_REPLAY_KB_PER_SEC", [](py::object /*self*/) { return rl::name::SPOOL_REPLAY_KB_PER_SEC; })
+    .def_property_readonly_static("FILE_DURABILITY", [](py::object /*self*/) { return rl::name::FILE_DURABILITY; })
+    .def_property_readonly_static("FILE_SYNC_INTERVAL_MS", [](py::object /*self*/) { return rl::name::FILE_SYNC_INTERVAL_MS; })
+    .def_property_readonly_static("FILE_ROTATE_SIZE_KB", [](py::object /*self*/) { return rl::name::FILE_ROTATE_SIZE_KB; })
+    .def_property_readonly_static("FILE_ROTATE_INTERVAL_MS", [](py::object /*self*/) { return rl::name::FILE_ROTATE_INTERVAL_MS; })
+    .def_property_readonly_static("FILE_MAX_PENDING_KB", [](py::object /*self*/) { return rl::name::FILE_MAX_PENDING_KB; })
     .def_property_readonly_static("AZURE_STORAGE_BLOB", [](py::object /*self*/) { return rl::value::AZURE_STORAGE_BLOB; })
     .def_property_readonly_static("NO_MODEL_DATA", [](py::object /*self*/) { return rl::value::NO_MODEL_DATA; })
     .def_property_readonly_static("FILE_MODEL_DATA", [](py::object /*self*/) { return rl::value::FILE_MODEL_DATA; })
@@ -386,6 +418,8 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("INTERACTION_EH_SENDER", [](py::object /*self*/) { return rl::value::INTERACTION_EH_SENDER; })
     .def_property_readonly_static("OBSERVATION_FILE_SENDER", [](py::object /*self*/) { return rl::value::OBSERVATION_FILE_SENDER; })
     .def_property_readonly_static("INTERACTION_FILE_SENDER", [](py::object /*self*/) { return rl::value::INTERACTION_FILE_SENDER; })
+    .def_property_readonly_static("OBSERVATION_ASYNC_FILE_SENDER", [](py::object /*self*/) { return rl::value::OBSERVATION_ASYNC_FILE_SENDER; })
+    .def_property_readonly_static("INTERACTION_ASYNC_FILE_SENDER", [](py::object /*self*/) { return rl::value::INTERACTION_ASYNC_FILE_SENDER; })
     .def_property_readonly_static("NULL_TRACE_LOGGER", [](py::object /*self*/) { return rl::value::NULL_TRACE_LOGGER; })
     .def_property_readonly_static("CONSOLE_TRACE_LOGGER", [](py::object /*self*/) { return rl::value::CONSOLE_TRACE_LOGGER; })
     .def_property_readonly_static("NULL_TIME_PROVIDER", [](py::object /*self*/) { return rl::value::NULL_TIME_PROVIDER; })
@@ -396,5 +430,8 @@ PYBIND11_MODULE(rl_client, m) {
     .def_property_readonly_static("CONTENT_ENCODING_IDENTITY", [](py::object /*self*/) { return rl::value::CONTENT_ENCODING_IDENTITY; })
     .def_property_readonly_static("CONTENT_ENCODING_DEDUP", [](py::object /*self*/) { return rl::value::CONTENT_ENCODING_DEDUP; })
     .def_property_readonly_static("QUEUE_MODE_DROP", [](py::object /*self*/) { return rl::value::QUEUE_MODE_DROP; })
-    .def_property_readonly_static("QUEUE_MODE_BLOCK", [](py::object /*self*/) { return rl::value::QUEUE_MODE_BLOCK; });
+    .def_property_readonly_static("QUEUE_MODE_BLOCK", [](py::object /*self*/) { return rl::value::QUEUE_MODE_BLOCK; })
+    .def_property_readonly_static("FILE_DURABILITY_NONE", [](py::object /*self*/) { return rl::value::FILE_DURABILITY_NONE; })
+    .def_property_readonly_static("FILE_DURABILITY_INTERVAL", [](py::object /*self*/) { return rl::value::FILE_DURABILITY_INTERVAL; })
+    .def_property_readonly_static("FILE_DURABILITY_BATCH", [](py::object /*self*/) { return rl::value::FILE_DURABILITY_BATCH; });
 }
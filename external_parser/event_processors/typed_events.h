@@ -7,6 +7,7 @@
 #include "joined_event.h"
 #include "loop.h"
 #include "zstd.h"
+#include "zstd_dictionaries.h"
 
 namespace v2 = reinforcement_learning::messages::flatbuff::v2;
 
@@ -222,6 +223,7 @@ template <typename T>
 bool process_compression(const uint8_t *data, size_t size,
                          const v2::Metadata &metadata, const T *&payload,
                          flatbuffers::DetachedBuffer &detached_buffer,
+                         zstd_dictionaries &dictionaries,
                          VW::io::logger &logger) {
 
   if (metadata.encoding() == v2::EventEncoding_Zstd) {
@@ -243,7 +245,21 @@ bool process_compression(const uint8_t *data, size_t size,
 
     std::unique_ptr<uint8_t[]> buff_data(
         flatbuffers::DefaultAllocator().allocate(buff_size));
-    size_t res = ZSTD_decompress(buff_data.get(), buff_size, data, size);
+    size_t res;
+    if (metadata.dictionary_id() != 0) {
+      const ZSTD_DDict *ddict = dictionaries.find(metadata.dictionary_id());
+      if (ddict == nullptr) {
+        logger.out_warn("No zstd dictionary with id [{}] was loaded to "
+                        "decompress event with id: [{}] of type: [{}]",
+                        metadata.dictionary_id(), metadata.id()->c_str(),
+                        metadata.payload_type());
+        return false;
+      }
+      res = ZSTD_decompress_usingDDict(dictionaries.context(), buff_data.get(),
+                                       buff_size, data, size, ddict);
+    } else {
+      res = ZSTD_decompress(buff_data.get(), buff_size, data, size);
+    }
 
     if (ZSTD_isError(res)) {
       logger.out_warn("Received [{}] error while decompressing event with id: "
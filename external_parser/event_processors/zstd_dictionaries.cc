@@ -0,0 +1,55 @@
+#include "zstd_dictionaries.h"
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace typed_event {
+zstd_dictionaries::zstd_dictionaries()
+    : _context(ZSTD_createDCtx(), &ZSTD_freeDCtx) {}
+
+bool zstd_dictionaries::load(const std::string &file, std::string &error) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    error = "Unable to open zstd dictionary file: " + file;
+    return false;
+  }
+  const std::vector<char> content((std::istreambuf_iterator<char>(in)),
+                                  std::istreambuf_iterator<char>());
+  if (in.bad()) {
+    error = "Unable to read zstd dictionary file: " + file;
+    return false;
+  }
+  if (!load(content.data(), content.size(), error)) {
+    error += " File: " + file;
+    return false;
+  }
+  return true;
+}
+
+bool zstd_dictionaries::load(const void *data, size_t size,
+                             std::string &error) {
+  const auto dictionary_id = ZSTD_getDictID_fromDict(data, size);
+  if (dictionary_id == 0) {
+    error = "Not a zstd dictionary.";
+    return false;
+  }
+  ddict_ptr ddict(ZSTD_createDDict(data, size), &ZSTD_freeDDict);
+  if (ddict == nullptr || _context == nullptr) {
+    error = "Could not load the zstd dictionary.";
+    return false;
+  }
+  auto it = _dictionaries.find(dictionary_id);
+  if (it != _dictionaries.end()) {
+    it->second = std::move(ddict);
+  } else {
+    _dictionaries.emplace(dictionary_id, std::move(ddict));
+  }
+  return true;
+}
+
+const ZSTD_DDict *zstd_dictionaries::find(uint32_t dictionary_id) const {
+  const auto it = _dictionaries.find(dictionary_id);
+  return it == _dictionaries.end() ? nullptr : it->second.get();
+}
+} // namespace typed_event
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "zstd.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace typed_event {
+/*
+zstd dictionaries by id
+Clients that compress with a trained dictionary record its id in the event
+metadata, the payloads of these events can only be decompressed once the same
+dictionary is loaded here.
+*/
+class zstd_dictionaries {
+public:
+  zstd_dictionaries();
+
+  // loads a dictionary file written by zstd_dict_trainer (or zstd --train),
+  // returns false and sets error when it can't be read or has no id
+  bool load(const std::string &file, std::string &error);
+  bool load(const void *data, size_t size, std::string &error);
+
+  // returns nullptr when no dictionary with that id was loaded
+  const ZSTD_DDict *find(uint32_t dictionary_id) const;
+
+  // decompression context reused for all the events decompressed with a
+  // dictionary
+  ZSTD_DCtx *context() { return _context.get(); }
+
+private:
+  using ddict_ptr = std::unique_ptr<ZSTD_DDict, size_t (*)(ZSTD_DDict *)>;
+  std::unordered_map<uint32_t, ddict_ptr> _dictionaries;
+  std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx *)> _context;
+};
+} // namespace typed_event
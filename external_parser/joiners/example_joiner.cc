@@ -1,5 +1,6 @@
 #include "joiners/example_joiner.h"
 #include "log_converter.h"
+#include "parse_example_external.h"
 
 #include "event_processors/typed_events.h"
 #include "generated/v2/DedupInfo_generated.h"
@@ -218,7 +219,7 @@ bool example_joiner::process_interaction(const v2::Event &event,
     const v2::CbEvent *cb = nullptr;
     if (!typed_event::process_compression<v2::CbEvent>(
             event.payload()->data(), event.payload()->size(), metadata, cb,
-            _detached_buffer, logger) ||
+            _detached_buffer, _zstd_dictionaries, logger) ||
         cb == nullptr) {
       return false;
     }
@@ -238,7 +239,7 @@ bool example_joiner::process_interaction(const v2::Event &event,
     const v2::MultiSlotEvent *multislot = nullptr;
     if (!typed_event::process_compression<v2::MultiSlotEvent>(
             event.payload()->data(), event.payload()->size(), metadata,
-            multislot, _detached_buffer, logger) ||
+            multislot, _detached_buffer, _zstd_dictionaries, logger) ||
         multislot == nullptr) {
       return false;
     }
@@ -260,7 +261,7 @@ bool example_joiner::process_interaction(const v2::Event &event,
     const v2::CaEvent *ca = nullptr;
     if (!typed_event::process_compression<v2::CaEvent>(
             event.payload()->data(), event.payload()->size(), metadata, ca,
-            _detached_buffer, logger) ||
+            _detached_buffer, _zstd_dictionaries, logger) ||
         ca == nullptr) {
       return false;
     }
@@ -328,7 +329,7 @@ bool example_joiner::process_outcome(const v2::Event &event,
   const v2::OutcomeEvent *outcome = nullptr;
   if (!typed_event::process_compression<v2::OutcomeEvent>(
           event.payload()->data(), event.payload()->size(), metadata, outcome,
-          _detached_buffer, logger) ||
+          _detached_buffer, _zstd_dictionaries, logger) ||
       outcome == nullptr) {
     // invalidate joined_event so that we don't learn from it
     invalidate_joined_event(metadata.id()->str());
@@ -366,7 +367,7 @@ bool example_joiner::process_dedup(const v2::Event &event,
   const v2::DedupInfo *dedup = nullptr;
   if (!typed_event::process_compression<v2::DedupInfo>(
           event.payload()->data(), event.payload()->size(), metadata, dedup,
-          _detached_buffer, logger) ||
+          _detached_buffer, _zstd_dictionaries, logger) ||
       dedup == nullptr) {
     return false;
   }
@@ -575,4 +576,13 @@ metrics::joiner_metrics example_joiner::get_metrics() {
   return _joiner_metrics;
 }
 
-void example_joiner::apply_cli_overrides(VW::workspace *, const input_options &) {}
+void example_joiner::apply_cli_overrides(VW::workspace *all, const input_options &parsed_options) {
+  if (all->options->was_supplied("zstd_dictionary")) {
+    for (const auto &file : parsed_options.ext_opts->zstd_dictionaries) {
+      std::string error;
+      if (!_zstd_dictionaries.load(file, error)) {
+        throw std::runtime_error(error);
+      }
+    }
+  }
+}
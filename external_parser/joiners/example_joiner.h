@@ -4,6 +4,7 @@
 
 #include "event_processors/joined_event.h"
 #include "event_processors/loop.h"
+#include "event_processors/zstd_dictionaries.h"
 #include "example.h"
 #include "joiners/i_joiner.h"
 #include "lru_dedup_cache.h"
@@ -125,6 +126,7 @@ private:
 
   VW::workspace *_vw;
   flatbuffers::DetachedBuffer _detached_buffer;
+  typed_event::zstd_dictionaries _zstd_dictionaries;
 
   loop::sticky_value<reward::RewardFunctionType> _reward_calculation;
   loop::loop_info _loop_info;
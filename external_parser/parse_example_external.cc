@@ -147,6 +147,9 @@ void parser::set_parse_args(VW::config::option_group_definition &in_options,
     .add(
       VW::config::make_option("learning_mode", parsed_options.ext_opts->learning_mode)
         .help("Override the learning mode from the file, valid values: Online, Apprentice, LoggingOnly"))
+    .add(
+      VW::config::make_option("zstd_dictionary", parsed_options.ext_opts->zstd_dictionaries)
+        .help("zstd dictionary file needed to decompress the events logged with it, can be repeated"))
     ;
 }
 
@@ -21,6 +21,7 @@ struct parser_options {
   std::string reward_function;
   std::string learning_mode;
   bool use_client_time;
+  std::vector<std::string> zstd_dictionaries;
 };
 
 int parse_examples(VW::workspace *all, io_buf &io_buf, v_array<example *> &examples);
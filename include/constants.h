@@ -10,6 +10,9 @@ namespace reinforcement_learning {  namespace name {
       const char *const  MODEL_VW_INITIAL_COMMAND_LINE = "model.vw.initial_command_line";
       const char *const  VW_CMDLINE              = "vw.commandline";
       const char *const  VW_POOL_INIT_SIZE       = "vw.pool.init.size";
+      const char *const  VW_POOL_SHARED_WEIGHTS  = "vw.pool.shared_weights";
+      const char *const  VW_ACTION_CACHE_CAPACITY = "vw.action_cache.capacity";
+      const char *const  ASYNC_EXECUTOR_THREAD_COUNT = "async.executor.thread_count";
       const char *const  INITIAL_EPSILON         = "initial_exploration.epsilon";
       const char *const  LEARNING_MODE           = "rank.learning.mode";
       const char* const  PROTOCOL_VERSION             = "protocol.version";
@@ -35,10 +38,14 @@ namespace reinforcement_learning {  namespace name {
       const char *const  INTERACTION_EH_MAX_HTTP_RETRIES = "interaction.eventhub.max_http_retries";
       const char *const  INTERACTION_SEND_HIGH_WATER_MARK     = "interaction.send.highwatermark";
       const char *const  INTERACTION_SEND_QUEUE_MAX_CAPACITY_KB    = "interaction.send.queue.maxcapacity.kb";
+      const char *const  INTERACTION_SEND_QUEUE_MAX_EVENTS    = "interaction.send.queue.maxevents";
+      const char *const  INTERACTION_SEND_QUEUE_FLUSH_FRACTION = "interaction.send.queue.flushfraction";
+      const char *const  INTERACTION_SEND_BATCHER_SHARDS      = "interaction.send.batcher.shards";
       const char *const  INTERACTION_SEND_BATCH_INTERVAL_MS   = "interaction.send.batchintervalms";
       const char *const  INTERACTION_SENDER_IMPLEMENTATION    = "interaction.sender.implementation";
       const char *const  INTERACTION_USE_COMPRESSION = "interaction.send.use_compression";
       const char *const  INTERACTION_USE_DEDUP = "interaction.send.use_dedup";
+      const char *const  INTERACTION_USE_BATCH_COMPRESSION = "interaction.send.use_batch_compression";
       const char *const  INTERACTION_QUEUE_MODE = "interaction.queue.mode";
       const char *const  INTERACTION_HTTP_API_HOST = "interaction.http.api.host";
       const char *const  INTERACTION_APIM_TASKS_LIMIT = "interaction.apim.tasks_limit";
@@ -54,9 +61,12 @@ namespace reinforcement_learning {  namespace name {
       const char *const  OBSERVATION_EH_MAX_HTTP_RETRIES = "observation.eventhub.max_http_retries";
       const char *const  OBSERVATION_SEND_HIGH_WATER_MARK     = "observation.send.highwatermark";
       const char *const  OBSERVATION_SEND_QUEUE_MAX_CAPACITY_KB    = "observation.send.queue.maxcapacity.kb";
+      const char *const  OBSERVATION_SEND_QUEUE_MAX_EVENTS    = "observation.send.queue.maxevents";
+      const char *const  OBSERVATION_SEND_QUEUE_FLUSH_FRACTION = "observation.send.queue.flushfraction";
       const char *const  OBSERVATION_SEND_BATCH_INTERVAL_MS   = "observation.send.batchintervalms";
       const char *const  OBSERVATION_SENDER_IMPLEMENTATION    = "observation.sender.implementation";
       const char *const  OBSERVATION_USE_COMPRESSION = "observation.send.use_compression";
+      const char *const  OBSERVATION_USE_BATCH_COMPRESSION = "observation.send.use_batch_compression";
       const char *const  OBSERVATION_QUEUE_MODE = "observation.queue.mode";
       const char *const  OBSERVATION_HTTP_API_HOST = "observation.http.api.host";
       const char *const  OBSERVATION_APIM_TASKS_LIMIT = "observation.apim.tasks_limit";
@@ -66,11 +76,17 @@ namespace reinforcement_learning {  namespace name {
       //global sender properties
       const char *const SEND_HIGH_WATER_MARK        = "send.highwatermark";
       const char *const SEND_QUEUE_MAX_CAPACITY_KB  = "send.queue.maxcapacity.kb";
+      const char *const SEND_QUEUE_MAX_EVENTS       = "send.queue.maxevents"; // slots of the queue ring, it is full once they are all taken even below its capacity (see api_config.dox)
+      const char *const SEND_QUEUE_FLUSH_FRACTION   = "send.queue.flushfraction"; // fraction of the queue capacity that triggers a flush before the batch interval, 0 = timer only
+      const char *const SEND_BATCHER_SHARDS         = "send.batcher.shards";      // number of parallel batchers of the interaction logger
       const char *const SEND_BATCH_INTERVAL_MS      = "send.batchintervalms";
       const char *const USE_COMPRESSION             = "send.use_compression";
       const char *const USE_DEDUP                   = "send.use_dedup";
+      const char *const USE_BATCH_COMPRESSION       = "send.use_batch_compression"; // zstd compress whole batches (protocol version 2)
       const char *const QUEUE_MODE                  = "queue.mode";
       const char *const SUBSAMPLE_RATE              = "subsample.rate";
+      const char *const BUFFER_POOL_MAX_KB          = "send.buffer_pool.max.kb"; // batch buffers kept for reuse, the others are freed
+      const char *const BUFFER_POOL_IDLE_MS         = "send.buffer_pool.idle_ms"; // pooled batch buffers unused that long are freed
 
       const char *const  EH_TEST                 = "eventhub.mock";
       const char *const  TRACE_LOG_IMPLEMENTATION = "trace.logger.implementation";
@@ -78,12 +94,34 @@ namespace reinforcement_learning {  namespace name {
       const char *const  INTERACTION_FILE_NAME = "interaction.file.name";
       const char *const  OBSERVATION_FILE_NAME = "observation.file.name";
       const char *const  TIME_PROVIDER_IMPLEMENTATION = "time_provider.implementation";
+      const char *const  EVENT_ID_GENERATOR_IMPLEMENTATION = "event_id.generator.implementation";
       const char *const  HTTP_CLIENT_DISABLE_CERT_VALIDATION  = "http.certvalidation.disable";
       const char *const  HTTP_CLIENT_TIMEOUT                  = "http.timeout"; // Timeout is in seconds, default is 30.
+      const char *const  HTTP_RETRY_MIN_DELAY_MS              = "http.retry.min_delay_ms"; // backoff before the first retry of a failed request
+      const char *const  HTTP_RETRY_MAX_DELAY_MS              = "http.retry.max_delay_ms"; // the backoff doubles with each retry up to that
       const char *const  MODEL_FILE_NAME                      = "model_file_loader.file_name";
       const char *const  MODEL_FILE_MUST_EXIST                = "model_file_loader.file_must_exist";
 
       const char *const ZSTD_COMPRESSION_LEVEL = "zstd.compression_level";
+      const char *const ZSTD_DICTIONARY_FILE = "zstd.dictionary_file"; // dictionary trained with zstd_dict_trainer, used when compression is enabled
+      const char *const ZSTD_ADAPTIVE_LEVEL = "zstd.adaptive_level"; // the batchers adjust the compression level to the queue pressure
+      const char *const ZSTD_MIN_COMPRESSION_LEVEL = "zstd.min_compression_level"; // bounds of the adaptive level
+      const char *const ZSTD_MAX_COMPRESSION_LEVEL = "zstd.max_compression_level";
+
+      // local spool of the batches the sender falls behind on (see spool_sender), per section or global
+      const char *const SPOOL_DIRECTORY = "spool.directory"; // not set = no spool
+      const char *const SPOOL_SEGMENT_SIZE_KB = "spool.segment_size.kb";
+      const char *const SPOOL_MAX_DISK_MB = "spool.max_disk.mb";
+      const char *const SPOOL_SEND_DEADLINE_MS = "spool.send_deadline_ms"; // a batch not sent after that long is spooled
+      const char *const SPOOL_MAX_PENDING_BATCHES = "spool.max_pending_batches"; // batches waiting for the sender before spooling
+      const char *const SPOOL_REPLAY_KB_PER_SEC = "spool.replay.kb_per_sec"; // 0 = as fast as the sender goes
+
+      // async file senders (see async_file_logger), per section or global
+      const char *const FILE_DURABILITY = "file.durability"; // NONE, INTERVAL or BATCH
+      const char *const FILE_SYNC_INTERVAL_MS = "file.sync_interval_ms";
+      const char *const FILE_ROTATE_SIZE_KB = "file.rotate.size.kb"; // not set = no size rotation
+      const char *const FILE_ROTATE_INTERVAL_MS = "file.rotate.interval_ms"; // not set = no time rotation
+      const char *const FILE_MAX_PENDING_KB = "file.max_pending.kb"; // send blocks beyond that
 }}
 
 namespace reinforcement_learning {  namespace value {
@@ -99,26 +137,56 @@ namespace reinforcement_learning {  namespace value {
       const char *const EPISODE_FILE_SENDER = "EPISODE_FILE_SENDER";
       const char *const OBSERVATION_FILE_SENDER = "OBSERVATION_FILE_SENDER";
       const char *const INTERACTION_FILE_SENDER = "INTERACTION_FILE_SENDER";
+      const char *const EPISODE_ASYNC_FILE_SENDER = "EPISODE_ASYNC_FILE_SENDER";
+      const char *const OBSERVATION_ASYNC_FILE_SENDER = "OBSERVATION_ASYNC_FILE_SENDER";
+      const char *const INTERACTION_ASYNC_FILE_SENDER = "INTERACTION_ASYNC_FILE_SENDER";
       const char* const OBSERVATION_HTTP_API_SENDER = "OBSERVATION_HTTP_API_SENDER";
       const char* const INTERACTION_HTTP_API_SENDER = "INTERACTION_HTTP_API_SENDER";
       const char *const NULL_TRACE_LOGGER = "NULL_TRACE_LOGGER";
       const char *const CONSOLE_TRACE_LOGGER = "CONSOLE_TRACE_LOGGER";
       const char *const NULL_TIME_PROVIDER = "NULL_TIME_PROVIDER";
       const char *const CLOCK_TIME_PROVIDER = "CLOCK_TIME_PROVIDER";
+      const char *const UUID4_EVENT_ID_GENERATOR = "UUID4_EVENT_ID_GENERATOR";
+      const char *const COUNTER_EVENT_ID_GENERATOR = "COUNTER_EVENT_ID_GENERATOR";
       const char *const LEARNING_MODE_ONLINE = "ONLINE";
       const char *const LEARNING_MODE_APPRENTICE = "APPRENTICE";
       const char *const LEARNING_MODE_LOGGINGONLY = "LOGGINGONLY";
       const char *const CONTENT_ENCODING_IDENTITY = "IDENTITY";
       const char *const CONTENT_ENCODING_DEDUP = "DEDUP";
+      const char *const BATCH_COMPRESSION_ZSTD = "ZSTD";
       const char* const HTTP_API_DEFAULT_HEADER_KEY_NAME = "Ocp-Apim-Subscription-Key";
       
 
       const char *const QUEUE_MODE_DROP = "DROP";
       const char *const QUEUE_MODE_BLOCK = "BLOCK";
 
+      const char *const FILE_DURABILITY_NONE = "NONE";
+      const char *const FILE_DURABILITY_INTERVAL = "INTERVAL";
+      const char *const FILE_DURABILITY_BATCH = "BATCH";
+
       const bool DEFAULT_MODEL_BACKGROUND_REFRESH = true;
       const int DEFAULT_VW_POOL_INIT_SIZE = 4;
+      const bool DEFAULT_VW_POOL_SHARED_WEIGHTS = false;
+      const int DEFAULT_VW_ACTION_CACHE_CAPACITY = 0;
+      const int DEFAULT_ASYNC_EXECUTOR_THREAD_COUNT = 0; // one thread per core
       const int DEFAULT_PROTOCOL_VERSION = 1;
+      const int DEFAULT_SEND_QUEUE_MAX_EVENTS = 8192;
+      const float DEFAULT_SEND_QUEUE_FLUSH_FRACTION = 1.f; // the flush threshold is the high water mark
+      const int DEFAULT_SEND_BATCHER_SHARDS = 1;
+      const int DEFAULT_ZSTD_COMPRESSION_LEVEL = 1;
+      const int DEFAULT_ZSTD_MIN_COMPRESSION_LEVEL = 1;
+      const int DEFAULT_ZSTD_MAX_COMPRESSION_LEVEL = 9;
+      const int DEFAULT_SPOOL_SEGMENT_SIZE_KB = 16 * 1024;
+      const int DEFAULT_SPOOL_MAX_DISK_MB = 1024;
+      const int DEFAULT_SPOOL_SEND_DEADLINE_MS = 2000;
+      const int DEFAULT_SPOOL_MAX_PENDING_BATCHES = 8;
+      const int DEFAULT_SPOOL_REPLAY_KB_PER_SEC = 1024;
+      const int DEFAULT_FILE_SYNC_INTERVAL_MS = 1000;
+      const int DEFAULT_FILE_MAX_PENDING_KB = 16 * 1024;
+      const int DEFAULT_HTTP_RETRY_MIN_DELAY_MS = 50;
+      const int DEFAULT_HTTP_RETRY_MAX_DELAY_MS = 5000;
+      const int DEFAULT_BUFFER_POOL_MAX_KB = 8 * 1024;
+      const int DEFAULT_BUFFER_POOL_IDLE_MS = 30000;
 
       const char *get_default_episode_sender();
       const char *get_default_observation_sender();
@@ -128,6 +196,16 @@ namespace reinforcement_learning {  namespace value {
 }}
 
 namespace reinforcement_learning {  namespace constants {
-      // subsampling uses drop_pass of -1 to avoid collision with the queue's pruning function
+      // subsampling and the DROP queue mode use different drop passes so that their samples are independent
       constexpr int SUBSAMPLE_RATE_DROP_PASS = -1;
+      constexpr int QUEUE_DROP_PASS = -2;
+      // in DROP queue mode events are kept with a probability going from 1 at this fill of the queue to 0 when full
+      constexpr float QUEUE_DROP_START_FILL = 0.8f;
+      // a batch buffer is reserved for the summed size estimates of its events times an overhead learned from the
+      // previous batches, starting at INITIAL_BATCH_OVERHEAD, plus room for the batch structure
+      constexpr float INITIAL_BATCH_OVERHEAD = 1.5f;
+      constexpr float MAX_BATCH_OVERHEAD = 4.f;
+      constexpr float BATCH_OVERHEAD_DECAY = 0.1f; // share of a lower overhead taken in per batch
+      constexpr int BATCH_RESERVE_PER_EVENT = 8;
+      constexpr int BATCH_RESERVE_HEADER = 256;
 }}
@@ -54,6 +54,9 @@ public:
   // Clear the contents of the buffer
   void reset();
 
+  // Bytes allocated for the buffer, which neither reset() nor a smaller body region give back
+  size_t capacity() const;
+
   // Get the beginning of the raw buffer
   value_type *raw_begin();
 
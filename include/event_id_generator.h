@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+
+namespace reinforcement_learning {
+  //! Size of the buffer handed to i_event_id_generator::generate(), including the terminating null character.
+  const size_t EVENT_ID_MAX_SIZE = 64;
+
+  /**
+   * @brief Generates the event ids of the decision calls that do not receive one from the caller.
+   * Advanced extension point:  Register another implementation with event_id_generator_factory and select it
+   * with the event_id.generator.implementation configuration.
+   */
+  class i_event_id_generator {
+  public:
+    virtual ~i_event_id_generator() = default;
+
+    /**
+     * @brief Writes a null terminated event id into buffer.  It is called concurrently by every thread making
+     * decisions, so implementations must be thread safe and should not allocate.
+     * @param buffer Destination buffer of EVENT_ID_MAX_SIZE bytes
+     * @return size_t Length of the event id, excluding the terminating null character
+     */
+    virtual size_t generate(char* buffer) = 0;
+  };
+}
@@ -13,6 +13,7 @@ namespace reinforcement_learning  {
   }
   class i_sender;
   class i_time_provider;
+  class i_event_id_generator;
   class error_callback_fn;
 
   /**
@@ -46,12 +47,19 @@ namespace reinforcement_learning  {
    * provide the mechanism used to set timestamps
    */
   using time_provider_factory_t = utility::object_factory<i_time_provider, const utility::configuration&>;
+  /**
+   * @brief Factory to create the generator of auto-generated event ids.
+   * Advanced extension point:  Register another implementation of i_event_id_generator to
+   * provide the event ids of the decision calls that do not receive one.
+   */
+  using event_id_generator_factory_t = utility::object_factory<i_event_id_generator, const utility::configuration&>;
 
   extern data_transport_factory_t& data_transport_factory;
   extern model_factory_t& model_factory;
   extern sender_factory_t& sender_factory;
   extern trace_logger_factory_t& trace_logger_factory;
   extern time_provider_factory_t& time_provider_factory;
+  extern event_id_generator_factory_t& event_id_generator_factory;
 
   // For proper static intialization
   // Check https://en.wikibooks.org/wiki/More_C++_Idioms/Nifty_Counter for explanation
@@ -19,7 +19,9 @@
 
 #include "multistep.h"
 
+#include <functional>
 #include <memory>
+#include <vector>
 
 namespace reinforcement_learning {
 
@@ -144,6 +146,52 @@ namespace reinforcement_learning {
     */
     int choose_rank(const char * context_json, unsigned int flags, ranking_response& resp, api_status* status = nullptr); //event_id is auto-generated
 
+    /**
+    * @brief Choose an action for each context of a batch. All decisions of the batch are served by the same
+    * model instance and are handed to the interaction logger in a single queue operation.
+    * @param event_ids  The unique identifiers for each interaction, one per context.  The same event_id should be used when
+    *                   reporting the outcome for the corresponding action.
+    * @param contexts_json Contains action, action features and context features in json format, one per decision
+    * @param flags Action flags (see action_flags.h), applied to every decision of the batch
+    * @param resps Ranking responses, one per context, in the same order as contexts_json
+    * @param status  Optional field with detailed string description if there is an error
+    * @return int Return error code.  This will also be returned in the api_status object
+    */
+    int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<ranking_response>& resps, api_status* status = nullptr);
+
+    /**
+    * @brief Choose an action for each context of a batch.  A unique event_id will be generated for each decision
+    * and returned in the corresponding ranking_response.
+    * @param contexts_json Contains action, action features and context features in json format, one per decision
+    * @param flags Action flags (see action_flags.h), applied to every decision of the batch
+    * @param resps Ranking responses, one per context, in the same order as contexts_json
+    * @param status  Optional field with detailed string description if there is an error
+    * @return int Return error code.  This will also be returned in the api_status object
+    */
+    int choose_rank_batch(const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<ranking_response>& resps, api_status* status = nullptr); //event_ids are auto-generated
+
+    /**
+    * @brief Completion callback of choose_rank_async().
+    * It is invoked on an internal executor thread with the result code of the decision, the ranking response and
+    * the detailed status.  The response may be moved out of the callback.
+    */
+    using choose_rank_callback_fn = std::function<void(int result, ranking_response& response, const api_status& status)>;
+
+    /**
+    * @brief Asynchronous version of choose_rank().  The arguments are copied and the call returns once the decision
+    * is queued.  Parsing, inference and logging run on an internal executor sized by the async.executor.thread_count
+    * configuration, which is started on the first asynchronous call.
+    * @param event_id  The unique identifier for this interaction.  The same event_id should be used when
+    *                  reporting the outcome for this action.
+    * @param context_json Contains action, action features and context features in json format
+    * @param flags Action flags (see action_flags.h)
+    * @param callback Completion callback, invoked exactly once if the decision was queued
+    * @param status  Optional field with detailed string description if the decision could not be queued
+    * @return int Return error code.  This will also be returned in the api_status object
+    */
+    int choose_rank_async(const char* event_id, const char* context_json, unsigned int flags, choose_rank_callback_fn callback, api_status* status = nullptr);
+    int choose_rank_async(const char* context_json, unsigned int flags, choose_rank_callback_fn callback, api_status* status = nullptr); //event_id is auto-generated
+
     /**
     * @brief (DEPRECATED) Choose an action from a continuous range, given a list of context features
     * The inference library chooses an action by sampling the probability density function produced per continuous action range.
@@ -265,6 +313,37 @@ namespace reinforcement_learning {
     RL_DEPRECATED("New unified example builder interface is coming")
     int request_multi_slot_decision(const char * event_id, const char * context_json, unsigned int flags, multi_slot_response_detailed& resp, const int* baseline_actions, size_t baseline_actions_size, api_status* status = nullptr);
 
+    /**
+    * @brief Choose an action per slot for each context of a batch. All decisions of the batch are served by the same
+    * model instance and are handed to the interaction logger in a single queue operation.
+    * @param event_ids  The unique identifiers for each interaction, one per context.
+    * @param contexts_json Contains slots, slot_features, slot ids, actions, action features and context features in json format, one per decision
+    * @param flags Action flags (see action_flags.h), applied to every decision of the batch
+    * @param resps Multi-slot responses, one per context, in the same order as contexts_json
+    * @param status  Optional field with detailed string description if there is an error
+    * @return int Return error code.  This will also be returned in the api_status object
+    */
+    int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<multi_slot_response>& resps, api_status* status = nullptr);
+    int request_multi_slot_decision_batch(const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<multi_slot_response>& resps, api_status* status = nullptr); //event_ids are auto-generated
+
+    /**
+    * @brief Completion callback of request_multi_slot_decision_async(), invoked on an internal executor thread.
+    */
+    using multi_slot_callback_fn = std::function<void(int result, multi_slot_response& response, const api_status& status)>;
+
+    /**
+    * @brief Asynchronous version of request_multi_slot_decision().  The arguments are copied and the call returns once
+    * the decision is queued on the internal executor (see choose_rank_async()).
+    * @param event_id  The unique identifier for this interaction.
+    * @param context_json Contains slots, slot_features, slot ids, actions, action features and context features in json format
+    * @param flags Action flags (see action_flags.h)
+    * @param callback Completion callback, invoked exactly once if the decision was queued
+    * @param status  Optional field with detailed string description if the decision could not be queued
+    * @return int Return error code.  This will also be returned in the api_status object
+    */
+    int request_multi_slot_decision_async(const char* event_id, const char* context_json, unsigned int flags, multi_slot_callback_fn callback, api_status* status = nullptr);
+    int request_multi_slot_decision_async(const char* context_json, unsigned int flags, multi_slot_callback_fn callback, api_status* status = nullptr); //event_id is auto-generated
+
     //multistep
     int request_episodic_decision(const char *event_id, const char *previous_id, const char *context_json, ranking_response &resp, episode_state &episode, api_status *status = nullptr);
     int request_episodic_decision(const char *event_id, const char *previous_id, const char *context_json, unsigned int flags, ranking_response &resp, episode_state &episode, api_status *status = nullptr);
@@ -84,6 +84,9 @@ namespace reinforcement_learning { namespace model_management {
       virtual int request_decision(const std::vector<const char*>& event_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) = 0;
       virtual int request_multi_slot_decision(const char* event_id, const std::vector<std::string>& slot_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) = 0;
       virtual int choose_rank_multistep(uint64_t rnd_seed, const char* features, const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version, api_status* status = nullptr) = 0;
+      //! Batched variants: every decision in the batch is served by the same model instance, so all of them report the same model_version.
+      virtual int choose_rank_batch(const std::vector<uint64_t>& rnd_seeds, const std::vector<const char*>& features, std::vector<std::vector<int>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) = 0;
+      virtual int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<std::vector<std::string>>& slot_ids, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, api_status* status = nullptr) = 0;
       virtual model_type_t model_type() const = 0;
       virtual ~i_model() = default;
     };
@@ -22,6 +22,18 @@ namespace reinforcement_learning {
   int observation_api_sender_create(i_sender** retval, const u::configuration& cfg, error_callback_fn* error_cb, i_trace* trace_logger, api_status* status);
   int interaction_api_sender_create(i_sender** retval, const u::configuration& cfg, error_callback_fn* error_cb, i_trace* trace_logger, api_status* status);
 
+  template <typename TAuthorization>
+  i_sender* create_http_transport_client(i_http_client* client, const u::configuration& cfg, int tasks_limit, int max_http_retries, i_trace* trace_logger, error_callback_fn* error_cb) {
+    return new http_transport_client<TAuthorization>(
+      client,
+      tasks_limit,
+      max_http_retries,
+      trace_logger,
+      error_cb,
+      std::chrono::milliseconds(cfg.get_int(name::HTTP_RETRY_MIN_DELAY_MS, value::DEFAULT_HTTP_RETRY_MIN_DELAY_MS)),
+      std::chrono::milliseconds(cfg.get_int(name::HTTP_RETRY_MAX_DELAY_MS, value::DEFAULT_HTTP_RETRY_MAX_DELAY_MS)));
+  }
+
   void register_azure_factories() {
     data_transport_factory.register_type(value::AZURE_STORAGE_BLOB, restapi_data_transport_create);
     data_transport_factory.register_type(value::HTTP_MODEL_DATA, authenticated_restapi_data_transport_create);
@@ -68,8 +80,9 @@ namespace reinforcement_learning {
     const auto eh_url = build_eh_url(eh_host, eh_name);
     i_http_client* client;
     RETURN_IF_FAIL(create_http_client(eh_url.c_str(), cfg, &client, status));
-    *retval = new http_transport_client<eventhub_http_authorization>(
+    *retval = create_http_transport_client<eventhub_http_authorization>(
         client,
+        cfg,
         cfg.get_int(name::EPISODE_EH_TASKS_LIMIT, 16),
         cfg.get_int(name::EPISODE_EH_MAX_HTTP_RETRIES, 4),
         trace_logger,
@@ -81,8 +94,9 @@ namespace reinforcement_learning {
   {
     i_http_client* client;
     RETURN_IF_FAIL(create_http_client(api_host, cfg, &client, status));
-    *retval = new http_transport_client<header_authorization>(
+    *retval = create_http_transport_client<header_authorization>(
       client,
+      cfg,
       tasks_limit,
       max_http_retries,
       trace_logger,
@@ -109,8 +123,9 @@ namespace reinforcement_learning {
     const auto eh_url = build_eh_url(eh_host, eh_name);
     i_http_client* client;
     RETURN_IF_FAIL(create_http_client(eh_url.c_str(), cfg, &client, status));
-    *retval = new http_transport_client<eventhub_http_authorization>(
+    *retval = create_http_transport_client<eventhub_http_authorization>(
       client,
+      cfg,
       cfg.get_int(name::OBSERVATION_EH_TASKS_LIMIT, 16),
       cfg.get_int(name::OBSERVATION_EH_MAX_HTTP_RETRIES, 4),
       trace_logger,
@@ -125,8 +140,9 @@ namespace reinforcement_learning {
     const auto eh_url = build_eh_url(eh_host, eh_name);
     i_http_client* client;
     RETURN_IF_FAIL(create_http_client(eh_url.c_str(), cfg, &client, status));
-    *retval = new http_transport_client<eventhub_http_authorization>(
+    *retval = create_http_transport_client<eventhub_http_authorization>(
       client,
+      cfg,
       cfg.get_int(name::INTERACTION_EH_TASKS_LIMIT, 16),
       cfg.get_int(name::INTERACTION_EH_MAX_HTTP_RETRIES, 4),
       trace_logger,
@@ -3,8 +3,11 @@
 #include "serialization/payload_serializer.h"
 #include "utility/context_helper.h"
 #include "utility/config_helper.h"
+#include "logger/sharded_async_batcher.h"
 
 #include "zstd.h"
+#include <fstream>
+#include <iterator>
 #include <sstream>
 
 namespace reinforcement_learning
@@ -96,14 +99,126 @@ size_t dedup_dict::size() const
 }
 
 
+// the dictionary (de)compression contexts are kept by each thread instead of being created for every payload
+static ZSTD_CCtx* thread_compression_context()
+{
+  static thread_local std::unique_ptr<ZSTD_CCtx, size_t(*)(ZSTD_CCtx*)> context(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+  return context.get();
+}
+
+static ZSTD_DCtx* thread_decompression_context()
+{
+  static thread_local std::unique_ptr<ZSTD_DCtx, size_t(*)(ZSTD_DCtx*)> context(ZSTD_createDCtx(), &ZSTD_freeDCtx);
+  return context.get();
+}
+
+static int dictionary_level(int level)
+{
+  return std::min(std::max(level, 1), ZSTD_maxCLevel());
+}
+
 zstd_compressor::zstd_compressor(int level): _level(level) {}
 
+zstd_compressor::~zstd_compressor()
+{
+  free_cdicts();
+  ZSTD_freeDDict(_ddict);
+}
+
+void zstd_compressor::free_cdicts()
+{
+  if(_cdicts == nullptr)
+    return;
+  for(int level = 0; level <= ZSTD_maxCLevel(); ++level)
+    ZSTD_freeCDict(_cdicts[level].load());
+  _cdicts.reset();
+}
+
+int zstd_compressor::load_dictionary(const void* data, size_t size, api_status* status)
+{
+  const auto dictionary_id = ZSTD_getDictID_fromDict(data, size);
+  if(dictionary_id == 0)
+    RETURN_ERROR_ARG(nullptr, status, compression_error, "Not a zstd dictionary.");
+
+  ZSTD_DDict* ddict = ZSTD_createDDict(data, size);
+  if(ddict == nullptr)
+    RETURN_ERROR_ARG(nullptr, status, compression_error, "Could not load the zstd dictionary.");
+
+  free_cdicts();
+  ZSTD_freeDDict(_ddict);
+  const auto* bytes = static_cast<const char*>(data);
+  _dictionary.assign(bytes, bytes + size);
+  _cdicts.reset(new std::atomic<ZSTD_CDict*>[ZSTD_maxCLevel() + 1]);
+  for(int level = 0; level <= ZSTD_maxCLevel(); ++level)
+    _cdicts[level].store(nullptr);
+  _ddict = ddict;
+  _dictionary_id = dictionary_id;
+
+  //digest it right away for the configured level
+  if(get_cdict(_level) == nullptr)
+    RETURN_ERROR_ARG(nullptr, status, compression_error, "Could not load the zstd dictionary.");
+  return error_code::success;
+}
+
+const ZSTD_CDict* zstd_compressor::get_cdict(int level) const
+{
+  auto& cdict = _cdicts[dictionary_level(level)];
+  ZSTD_CDict* res = cdict.load(std::memory_order_acquire);
+  if(res == nullptr) {
+    std::unique_lock<std::mutex> mlock(_cdicts_mutex);
+    res = cdict.load(std::memory_order_relaxed);
+    if(res == nullptr) {
+      res = ZSTD_createCDict(_dictionary.data(), _dictionary.size(), dictionary_level(level));
+      cdict.store(res, std::memory_order_release);
+    }
+  }
+  return res;
+}
+
+int zstd_compressor::load_dictionary(const char* file, api_status* status)
+{
+  std::ifstream in(file, std::ios::binary);
+  if(!in)
+    RETURN_ERROR_LS(nullptr, status, file_open_error) << " File:" << file;
+
+  const std::vector<char> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if(in.bad())
+    RETURN_ERROR_LS(nullptr, status, file_read_error) << " File:" << file;
+
+  return load_dictionary(content.data(), content.size(), status);
+}
+
+uint32_t zstd_compressor::get_dictionary_id() const
+{
+  return _dictionary_id;
+}
+
+int zstd_compressor::get_level() const
+{
+  return _level;
+}
+
 int zstd_compressor::compress(generic_event::payload_buffer_t& input, api_status* status) const
+{
+  return compress(input, _level, status);
+}
+
+int zstd_compressor::compress(generic_event::payload_buffer_t& input, int level, api_status* status) const
 {
   size_t buff_size = ZSTD_compressBound(input.size());
 
   std::unique_ptr<uint8_t[]> data(fb::DefaultAllocator().allocate(buff_size));
-  size_t res = ZSTD_compress(data.get(), buff_size, input.data(), input.size(), _level);
+  size_t res;
+  if(_cdicts != nullptr) {
+    auto* context = thread_compression_context();
+    const auto* cdict = get_cdict(level);
+    if(context == nullptr || cdict == nullptr)
+      RETURN_ERROR_ARG(nullptr, status, compression_error, "Could not create the compression context.");
+    res = ZSTD_compress_usingCDict(context, data.get(), buff_size, input.data(), input.size(), cdict);
+  }
+  else {
+    res = ZSTD_compress(data.get(), buff_size, input.data(), input.size(), level);
+  }
 
   if(ZSTD_isError(res))
     RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res));
@@ -122,7 +237,16 @@ int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status
     RETURN_ERROR_ARG(nullptr, status, compression_error, "Unknown compressed size.");
 
   std::unique_ptr<uint8_t[]> data(fb::DefaultAllocator().allocate(buff_size));
-  size_t res = ZSTD_decompress(data.get(), buff_size, buf.data(), buf.size());
+  size_t res;
+  if(_ddict != nullptr && ZSTD_getDictID_fromFrame(buf.data(), buf.size()) == _dictionary_id) {
+    auto* context = thread_decompression_context();
+    if(context == nullptr)
+      RETURN_ERROR_ARG(nullptr, status, compression_error, "Could not create the decompression context.");
+    res = ZSTD_decompress_usingDDict(context, data.get(), buff_size, buf.data(), buf.size(), _ddict);
+  }
+  else {
+    res = ZSTD_decompress(data.get(), buff_size, buf.data(), buf.size());
+  }
 
   if(ZSTD_isError(res))
     RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res));
@@ -133,12 +257,16 @@ int zstd_compressor::decompress(generic_event::payload_buffer_t& buf, api_status
 }
 
 
-dedup_state::dedup_state(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider):
+dedup_state::dedup_state(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider, int shards):
   _compressor(c.get_int(name::ZSTD_COMPRESSION_LEVEL, zstd_compressor::ZSTD_DEFAULT_COMPRESSION_LEVEL))
+  , _shards(std::max(shards, 1))
+  , _levels(new std::atomic<int>[_shards])
   , _time_provider(time_provider)
   , _use_compression(use_compression)
   , _use_dedup(use_dedup)
 {
+  for(size_t i = 0; i < _shards; ++i)
+    _levels[i].store(_compressor.get_level(), std::memory_order_relaxed);
 }
 
 string_view dedup_state::get_object(generic_event::object_id_t aid) {
@@ -157,14 +285,40 @@ void dedup_state::update_ewma(float value)
 }
 
 int dedup_state::compress(generic_event::payload_buffer_t& input, event_content_type& content_type, api_status* status) const {
+  const int level = _shards == 1 ? _levels[0].load(std::memory_order_relaxed)
+    : _levels[l::thread_shard(_shards)].load(std::memory_order_relaxed);
+  return compress(input, content_type, level, status);
+}
+
+int dedup_state::compress(generic_event::payload_buffer_t& input, event_content_type& content_type, int level, api_status* status) const {
   if(_use_compression) {
     content_type = event_content_type::ZSTD;
-    return _compressor.compress(input, status);
+    return _compressor.compress(input, level, status);
   }
   content_type = event_content_type::IDENTITY;
   return error_code::success;
 }
 
+int dedup_state::load_compression_dictionary(const char* file, api_status* status) {
+  return _compressor.load_dictionary(file, status);
+}
+
+uint32_t dedup_state::get_compression_dictionary_id() const {
+  return _compressor.get_dictionary_id();
+}
+
+bool dedup_state::is_compression_enabled() const {
+  return _use_compression;
+}
+
+int dedup_state::get_compression_level() const {
+  return _compressor.get_level();
+}
+
+void dedup_state::set_compression_level(int shard, int level) {
+  _levels[static_cast<size_t>(shard) % _shards].store(level, std::memory_order_relaxed);
+}
+
 int dedup_state::transform_payload_and_add_objects(const char* payload, std::string& edited_payload, generic_event::object_list_t& object_ids, api_status* status){
   if(!_use_dedup) {
     edited_payload = payload;
@@ -175,9 +329,10 @@ int dedup_state::transform_payload_and_add_objects(const char* payload, std::str
   }
 }
 
-action_dict_builder::action_dict_builder(dedup_state& state):
+action_dict_builder::action_dict_builder(dedup_state& state, const logger::compression_level_controller* level_controller):
   _size_estimate(0)
-  , _state(state) {}
+  , _state(state)
+  , _level_controller(level_controller) {}
 
 int action_dict_builder::add(const generic_event::object_list_t& object_ids, api_status* status)
 {
@@ -221,7 +376,9 @@ int action_dict_builder::finalize(generic_event& evt, api_status* status)
   //compress the payload
   event_content_type content_type;
   size_t old_size = payload.size();
-  RETURN_IF_FAIL(_state.compress(payload, content_type, status));    
+  //on the batcher thread, with the level of its batcher
+  const int level = _level_controller != nullptr ? _level_controller->level() : _state.get_compression_level();
+  RETURN_IF_FAIL(_state.compress(payload, content_type, level, status));
   size_t new_size = payload.size();
 
   //update compression ratio estimator
@@ -234,6 +391,8 @@ int action_dict_builder::finalize(generic_event& evt, api_status* status)
     std::move(payload),
     content_type, 
     evt.get_app_id());
+  if(content_type == event_content_type::ZSTD)
+    evt.set_dictionary_id(_state.get_compression_dictionary_id());
 
   return error_code::success;
 }
@@ -247,8 +406,9 @@ struct dedup_collection_serializer
 
   static int message_id() { return logger::message_type::fb_generic_event_collection; }
 
-  dedup_collection_serializer(buffer_t& buffer, const char* content_encoding, shared_state_t& state)
-      : _dummy(0), _ser(buffer, content_encoding, _dummy), _state(state), _builder(state) {}
+  dedup_collection_serializer(buffer_t& buffer, const char* content_encoding, shared_state_t& state, logger::batch_compressor* compressor,
+    const logger::compression_level_controller* level_controller)
+      : _dummy(0), _ser(buffer, content_encoding, _dummy, compressor, level_controller), _state(state), _builder(state, level_controller) {}
 
   int add(event_t& evt, api_status* status = nullptr)
   {
@@ -275,34 +435,56 @@ struct dedup_collection_serializer
   logger::fb_collection_serializer<event_t> _ser;
 };
 
+//plain batches of events compressed one by one, the shared state gives the batcher access to the per event compression
+template <typename event_t>
+struct compressed_collection_serializer : logger::fb_collection_serializer<event_t>
+{
+  using shared_state_t = dedup_state;
+
+  compressed_collection_serializer(utility::data_buffer& buffer, const char* content_encoding, shared_state_t& /*state*/,
+    logger::batch_compressor* compressor, const logger::compression_level_controller* level_controller)
+      : logger::fb_collection_serializer<event_t>(buffer, content_encoding, 0, compressor, level_controller) {}
+};
+
 class dedup_extensions : public logger::i_logger_extensions
 {
 public:
-	dedup_extensions(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider) :
-    logger::i_logger_extensions(c), _dedup_state(c, use_compression, use_dedup, time_provider), _use_dedup(use_dedup), _use_compression(use_compression) {}
+	dedup_extensions(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider, int shards) :
+    logger::i_logger_extensions(c), _dedup_state(c, use_compression, use_dedup, time_provider, shards), _use_dedup(use_dedup), _use_compression(use_compression) {}
 
 	logger::i_async_batcher<generic_event>* create_batcher(logger::i_message_sender* sender, utility::watchdog& watchdog,
 																									error_callback_fn* perror_cb, const char* section) override {
 		auto config = utility::get_batcher_config(_config, section);
 
-    if(_use_dedup) {
-      return new logger::async_batcher<generic_event, dedup_collection_serializer>(
-          sender,
-          watchdog,
-          _dedup_state,
-          perror_cb,
-          config);
-    } else {
-      return new logger::async_batcher<generic_event, logger::fb_collection_serializer>(
-          sender,
-          watchdog,
-          _dummy_state,
-          perror_cb,
-          config);
-    }
+    // the shards share the dedup dictionary, which is reference counted and locked
+    return logger::create_sharded_batcher<generic_event>(sender, config,
+      [&](logger::i_message_sender* shard_sender, const utility::async_batcher_config& shard_config) -> logger::i_async_batcher<generic_event>* {
+        if(_use_dedup) {
+          return new logger::async_batcher<generic_event, dedup_collection_serializer>(
+              shard_sender,
+              watchdog,
+              _dedup_state,
+              perror_cb,
+              shard_config);
+        }
+        return new logger::async_batcher<generic_event, compressed_collection_serializer>(
+            shard_sender,
+            watchdog,
+            _dedup_state,
+            perror_cb,
+            shard_config);
+      });
 
 	}
 
+  int init(api_status* status) override {
+    const char* dictionary_file = _config.get(name::ZSTD_DICTIONARY_FILE, "");
+    if(_use_compression && dictionary_file[0] != '\0') {
+      return _dedup_state.load_compression_dictionary(dictionary_file, status);
+    }
+    return error_code::success;
+  }
+
   bool is_object_extraction_enabled() const override { return _use_dedup; }
   bool is_serialization_transform_enabled() const override { return _use_compression; }
 
@@ -313,9 +495,10 @@ public:
   int transform_serialized_payload(generic_event::payload_buffer_t& input, event_content_type& content_type, api_status* status) const override {
 		return _dedup_state.compress(input, content_type, status);
 	}
+
+  uint32_t get_compression_dictionary_id() const override { return _dedup_state.get_compression_dictionary_id(); }
 private:
 	dedup_state _dedup_state;
-  int _dummy_state = 0;
   bool _use_compression;
   bool _use_dedup;
 };
@@ -330,7 +513,7 @@ logger::i_logger_extensions* create_dedup_logger_extension(const utility::config
   if(!use_compression && !use_dedup)
     return nullptr;
 
-  return new dedup_extensions(config, use_compression, use_dedup, time_provider);
+  return new dedup_extensions(config, use_compression, use_dedup, time_provider, utility::get_batcher_config(config, section).batcher_shards);
 }
 
 }
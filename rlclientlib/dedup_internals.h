@@ -1,9 +1,12 @@
 #pragma once
 #include "dedup.h"
 #include "api_status.h"
+#include "constants.h"
 #include "rl_string_view.h"
+#include "logger/compression_level_controller.h"
 #include "zstd.h"
 
+#include <atomic>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
@@ -57,18 +60,43 @@ namespace reinforcement_learning
 
   class zstd_compressor {
   public:
-    const static int ZSTD_DEFAULT_COMPRESSION_LEVEL = 1;
+    const static int ZSTD_DEFAULT_COMPRESSION_LEVEL = value::DEFAULT_ZSTD_COMPRESSION_LEVEL;
 
     explicit zstd_compressor(int level);
+    ~zstd_compressor();
+
+    zstd_compressor(const zstd_compressor&) = delete;
+    zstd_compressor& operator=(const zstd_compressor&) = delete;
+
+    //! Compresses with the dictionary from then on. It must be a trained zstd dictionary, raw content has no id
+    int load_dictionary(const void* data, size_t size, api_status* status);
+    int load_dictionary(const char* file, api_status* status);
+    //! Returns the id of the loaded dictionary, 0 when there is none
+    uint32_t get_dictionary_id() const;
+
+    int get_level() const;
+
+    //! Compresses with the configured level, or the given one. With a dictionary the level is clamped to [1, ZSTD_maxCLevel()]
     int compress(generic_event::payload_buffer_t& input, api_status* status) const;
+    int compress(generic_event::payload_buffer_t& input, int level, api_status* status) const;
     int decompress(generic_event::payload_buffer_t& buf, api_status* status) const;
   private:
+    //! The dictionary is digested for a given level, this is done the first time a level is used
+    const ZSTD_CDict* get_cdict(int level) const;
+    void free_cdicts();
+
     const int _level;
+    std::vector<char> _dictionary;
+    mutable std::unique_ptr<std::atomic<ZSTD_CDict*>[]> _cdicts; //by level, null without dictionary
+    mutable std::mutex _cdicts_mutex;
+    ZSTD_DDict* _ddict = nullptr;
+    uint32_t _dictionary_id = 0;
   };
 
   class dedup_state {
   public:
-    dedup_state(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider);
+    //! shards: number of batchers sharing the state, each drives the compression level of the events of its threads
+    dedup_state(const utility::configuration& c, bool use_compression, bool use_dedup, i_time_provider* time_provider, int shards = 1);
 
     string_view get_object(generic_event::object_id_t aid);
     float get_ewma_value() const;
@@ -80,7 +108,14 @@ namespace reinforcement_learning
     int remove_all_values(I start, I end, api_status* status);
 
     void update_ewma(float value);
+    //! compresses with the level of the shard the calling thread logs to
     int compress(generic_event::payload_buffer_t& input, event_content_type& content_type, api_status* status) const;
+    int compress(generic_event::payload_buffer_t& input, event_content_type& content_type, int level, api_status* status) const;
+    int load_compression_dictionary(const char* file, api_status* status);
+    uint32_t get_compression_dictionary_id() const;
+    bool is_compression_enabled() const;
+    int get_compression_level() const;
+    void set_compression_level(int shard, int level);
     int transform_payload_and_add_objects(const char* payload, std::string& edited_payload, generic_event::object_list_t& object_ids, api_status* status);
 
     i_time_provider* get_time_provider() { return _time_provider.get(); }
@@ -92,23 +127,37 @@ namespace reinforcement_learning
     ewma _ewma;
     dedup_dict _dict;
     zstd_compressor _compressor;
+    const size_t _shards;
+    std::unique_ptr<std::atomic<int>[]> _levels; //by shard
     std::mutex _mutex;
     std::unique_ptr<i_time_provider> _time_provider;
     bool _use_compression;
     bool _use_dedup;
   };
 
+  namespace logger {
+    //the adaptive level of the dedup batchers also applies to the per event compression, its ratio is the dedup_state ewma
+    template<>
+    struct shared_state_compression<dedup_state> {
+      static bool enabled(const dedup_state& state) { return state.is_compression_enabled(); }
+      static float ratio(const dedup_state& state) { return state.get_ewma_value(); }
+      static void set_level(dedup_state& state, int shard, int level) { state.set_compression_level(shard, level); }
+    };
+  }
+
   static const char* DEDUP_DICT_EVENT_ID = "3defd95a-0122-4aac-9068-0b9ac30b66d8";
   class action_dict_builder {
   public:
 
-    explicit action_dict_builder(dedup_state& state);
+    //! the dictionary event is compressed with the level of level_controller when there is one
+    explicit action_dict_builder(dedup_state& state, const logger::compression_level_controller* level_controller = nullptr);
 
     int add(const generic_event::object_list_t& object_ids, api_status* status);
     size_t size() const;
     int finalize(generic_event& evt, api_status* status);
   private:
     dedup_state& _state;
+    const logger::compression_level_controller* _level_controller;
     size_t _size_estimate;
     std::unordered_map<generic_event::object_id_t, size_t> _used_objects;
   };
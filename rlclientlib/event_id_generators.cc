@@ -0,0 +1,64 @@
+#include "event_id_generators.h"
+
+#include <random>
+#include <thread>
+
+namespace reinforcement_learning {
+  namespace {
+    std::mt19937_64& thread_rng() {
+      static thread_local std::mt19937_64 rng([] {
+        std::random_device rd;
+        std::seed_seq seq{ rd(), rd(), rd(), rd(),
+          static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) };
+        return std::mt19937_64(seq);
+      }());
+      return rng;
+    }
+
+    char* write_hex(uint64_t value, int digits, char* out) {
+      static const char hex[] = "0123456789abcdef";
+      for (int i = digits - 1; i >= 0; --i) {
+        out[i] = hex[value & 0xf];
+        value >>= 4;
+      }
+      return out + digits;
+    }
+  }
+
+  size_t format_uuid(uint64_t hi, uint64_t lo, char* buffer) {
+    char* out = buffer;
+    out = write_hex(hi >> 32, 8, out);
+    *out++ = '-';
+    out = write_hex(hi >> 16, 4, out);
+    *out++ = '-';
+    out = write_hex(hi, 4, out);
+    *out++ = '-';
+    out = write_hex(lo >> 48, 4, out);
+    *out++ = '-';
+    out = write_hex(lo, 12, out);
+    *out = '\0';
+    return out - buffer;
+  }
+
+  size_t uuid4_event_id_generator::generate(char* buffer) {
+    auto& rng = thread_rng();
+    uint64_t hi = rng();
+    uint64_t lo = rng();
+    // version 4, variant 1 (RFC 4122)
+    hi = (hi & 0xffffffffffff0fffULL) | 0x0000000000004000ULL;
+    lo = (lo & 0x3fffffffffffffffULL) | 0x8000000000000000ULL;
+    return format_uuid(hi, lo, buffer);
+  }
+
+  counter_event_id_generator::counter_event_id_generator()
+    : _node_id(thread_rng()())
+  {}
+
+  counter_event_id_generator::counter_event_id_generator(uint64_t node_id)
+    : _node_id(node_id)
+  {}
+
+  size_t counter_event_id_generator::generate(char* buffer) {
+    return format_uuid(_node_id, _counter.fetch_add(1, std::memory_order_relaxed), buffer);
+  }
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include "event_id_generator.h"
+
+#include <atomic>
+#include <cstdint>
+
+namespace reinforcement_learning {
+  // Random (version 4) UUIDs drawn from a per-thread generator that is seeded once per thread, instead of
+  // reading the OS entropy source for every id.
+  class uuid4_event_id_generator : public i_event_id_generator {
+  public:
+    size_t generate(char* buffer) override;
+  };
+
+  // 128 bit ids made of a random per-instance node id followed by a monotonic counter, formatted like a UUID.
+  // Cheapest strategy, ids are unique as long as node ids do not collide.
+  class counter_event_id_generator : public i_event_id_generator {
+  public:
+    counter_event_id_generator();
+    explicit counter_event_id_generator(uint64_t node_id);
+    size_t generate(char* buffer) override;
+
+  private:
+    const uint64_t _node_id;
+    std::atomic<uint64_t> _counter{ 0 };
+  };
+
+  // Writes the 8-4-4-4-12 hexadecimal representation of the 128 bit value (hi, lo), returns its length.
+  size_t format_uuid(uint64_t hi, uint64_t lo, char* buffer);
+}
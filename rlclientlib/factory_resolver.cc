@@ -15,8 +15,12 @@
 
 #include <type_traits>
 #include "console_tracer.h"
+#include "event_id_generators.h"
 #include "error_callback_fn.h"
 #include "logger/file/file_logger.h"
+#include "logger/file/async_file_logger.h"
+#include "internal_constants.h"
+#include "utility/config_helper.h"
 #include "model_mgmt/file_model_loader.h"
 
 namespace reinforcement_learning {
@@ -35,6 +39,7 @@ namespace reinforcement_learning {
   static natural_align<sender_factory_t>::type senderfactory_buf;
   static natural_align<trace_logger_factory_t>::type traceloggerfactory_buf;
   static natural_align<time_provider_factory_t>::type time_provider_factory_buf;
+  static natural_align<event_id_generator_factory_t>::type event_id_generator_factory_buf;
 
   // Reference should point to the allocated memory to be initialized by placement new in factory_initializer::factory_initializer()
   data_transport_factory_t& data_transport_factory = (data_transport_factory_t&)( dtfactory_buf );
@@ -42,6 +47,7 @@ namespace reinforcement_learning {
   sender_factory_t& sender_factory = (sender_factory_t&)( senderfactory_buf );
   trace_logger_factory_t& trace_logger_factory = (trace_logger_factory_t&)( traceloggerfactory_buf );
   time_provider_factory_t& time_provider_factory = (time_provider_factory_t&)(time_provider_factory_buf);
+  event_id_generator_factory_t& event_id_generator_factory = (event_id_generator_factory_t&)(event_id_generator_factory_buf);
 
   factory_initializer::factory_initializer() {
     if ( init_guard++ == 0 ) {
@@ -50,6 +56,7 @@ namespace reinforcement_learning {
       new ( &sender_factory ) sender_factory_t();
       new (&trace_logger_factory) trace_logger_factory_t();
       new (&time_provider_factory) time_provider_factory_t();
+      new (&event_id_generator_factory) event_id_generator_factory_t();
 
       register_default_factories();
     }
@@ -62,6 +69,7 @@ namespace reinforcement_learning {
       ( &sender_factory )->~sender_factory_t();
       ( &trace_logger_factory )->~trace_logger_factory_t();
       ( &time_provider_factory )->~time_provider_factory_t();
+      ( &event_id_generator_factory )->~event_id_generator_factory_t();
     }
   }
 
@@ -84,6 +92,15 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
+  int async_file_sender_create(
+    i_sender** retval, const u::configuration& cfg,
+    const char * file_name, const char* section,
+    error_callback_fn* error_cb, i_trace* trace_logger, api_status* status)
+  {
+    *retval = new logger::file::async_file_logger(file_name, u::get_file_sender_config(cfg, section), trace_logger, error_cb);
+    return error_code::success;
+  }
+
   int empty_data_transport_create(m::i_data_transport** retval, const u::configuration& config, i_trace* trace_logger, api_status* status)
   {
     TRACE_INFO(trace_logger, "Empty data transport created.");
@@ -123,6 +140,13 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
+  template <typename generator_t>
+  int event_id_generator_create(i_event_id_generator** retval, const u::configuration& config, i_trace* trace_logger, api_status* status)
+  {
+    *retval = new generator_t();
+    return error_code::success;
+  }
+
   void factory_initializer::register_default_factories() {
 #ifdef USE_AZURE_FACTORIES
     register_azure_factories();
@@ -140,6 +164,9 @@ namespace reinforcement_learning {
     time_provider_factory.register_type(value::NULL_TIME_PROVIDER, null_time_provider_create);
     time_provider_factory.register_type(value::CLOCK_TIME_PROVIDER, clock_time_provider_create);
 
+    event_id_generator_factory.register_type(value::UUID4_EVENT_ID_GENERATOR, event_id_generator_create<uuid4_event_id_generator>);
+    event_id_generator_factory.register_type(value::COUNTER_EVENT_ID_GENERATOR, event_id_generator_create<counter_event_id_generator>);
+
     // Register File loggers
     sender_factory.register_type(value::EPISODE_FILE_SENDER,
       [](i_sender** retval, const u::configuration& c, error_callback_fn* cb, i_trace* trace_logger, api_status* status){
@@ -162,6 +189,29 @@ namespace reinforcement_learning {
         file_name,
         cb, trace_logger, status);
     });
+
+    // Register async File loggers
+    sender_factory.register_type(value::EPISODE_ASYNC_FILE_SENDER,
+      [](i_sender** retval, const u::configuration& c, error_callback_fn* cb, i_trace* trace_logger, api_status* status) {
+      const char* file_name = c.get(name::EPISODE_FILE_NAME, "episode.fb.data");
+      return async_file_sender_create(retval, c,
+        file_name, config_constants::EPISODE,
+        cb, trace_logger, status);
+    });
+    sender_factory.register_type(value::OBSERVATION_ASYNC_FILE_SENDER,
+      [](i_sender** retval, const u::configuration& c, error_callback_fn* cb, i_trace* trace_logger, api_status* status) {
+      const char* file_name = c.get(name::OBSERVATION_FILE_NAME, "observation.fb.data");
+      return async_file_sender_create(retval, c,
+        file_name, config_constants::OBSERVATION,
+        cb, trace_logger, status);
+    });
+    sender_factory.register_type(value::INTERACTION_ASYNC_FILE_SENDER,
+      [](i_sender** retval, const u::configuration& c, error_callback_fn* cb, i_trace* trace_logger, api_status* status) {
+      const char* file_name = c.get(name::INTERACTION_FILE_NAME, "interaction.fb.data");
+      return async_file_sender_create(retval, c,
+        file_name, config_constants::INTERACTION,
+        cb, trace_logger, status);
+    });
   }
 
   int null_tracer_create(i_trace** retval, const u::configuration& cfg, i_trace* trace_logger, api_status* status) {
@@ -3,35 +3,51 @@
 #include "explore_internal.h"
 #include "hash.h"
 
+#include <cstring>
+
 using namespace std;
 namespace reinforcement_learning {
   generic_event::generic_event(const char* id, const timestamp& ts, payload_type_t type, flatbuffers::DetachedBuffer&& payload, event_content_type content_type, object_list_t &&objects, const char* app_id, float pass_prob)
-    : _id(id)
-    , _client_time_gmt(ts)
+    : _client_time_gmt(ts)
     , _payload_type(type)
     , _payload(std::move(payload))
     , _objects(std::move(objects))
     , _pass_prob(pass_prob)
     , _content_type(content_type) 
-    , _app_id(app_id) {}
+    , _app_id(app_id) {
+    set_id(id);
+  }
 
   generic_event::generic_event(const char* id, const timestamp& ts, payload_type_t type, flatbuffers::DetachedBuffer&& payload, event_content_type content_type, const char* app_id, float pass_prob)
-    : _id(id)
-    , _client_time_gmt(ts)
+    : _client_time_gmt(ts)
     , _payload_type(type)
     , _payload(std::move(payload))
     , _pass_prob(pass_prob)
     , _content_type(content_type) 
-    , _app_id(app_id) {}
+    , _app_id(app_id) {
+    set_id(id);
+  }
+
+  void generic_event::set_id(const char* id) {
+    const size_t len = strlen(id);
+    if (len < EVENT_ID_MAX_SIZE) {
+      memcpy(_id, id, len + 1);
+      _long_id.clear();
+    }
+    else {
+      _id[0] = '\0';
+      _long_id.assign(id, len);
+    }
+  }
 
   bool generic_event::try_drop(float pass_prob, int drop_pass) {
     _pass_prob *= pass_prob;
     return prg(drop_pass) > pass_prob;
   }
 
-  const char* generic_event::get_id() const { return _id.c_str(); }
+  const char* generic_event::get_id() const { return _long_id.empty() ? _id : _long_id.c_str(); }
 
-  const char* generic_event::get_app_id() const { return _app_id.c_str(); }  
+  const char* generic_event::get_app_id() const { return _app_id; }
 
   float generic_event::get_pass_prob() const { return _pass_prob; }
   const generic_event::object_list_t& generic_event::get_object_list() const { return _objects; }
@@ -39,7 +55,7 @@ namespace reinforcement_learning {
   timestamp generic_event::get_client_time_gmt() const { return _client_time_gmt; }
 
   float generic_event::prg(int drop_pass) const {
-    const auto seed_str = _id + std::to_string(drop_pass);
+    const auto seed_str = std::string(get_id()) + std::to_string(drop_pass);
     const auto seed = uniform_hash(seed_str.c_str(), seed_str.length(), 0);
     return exploration::uniform_random_merand48(seed);
   }
@@ -61,4 +77,8 @@ namespace reinforcement_learning {
         return encoding_type_t::EventEncoding_Identity;
     }
   }
+
+  uint32_t generic_event::get_dictionary_id() const { return _dictionary_id; }
+
+  void generic_event::set_dictionary_id(uint32_t dictionary_id) { _dictionary_id = dictionary_id; }
 }
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include "time_helper.h"
+#include "event_id_generator.h"
 #include "generated/v2/Event_generated.h"
 #include <flatbuffers/flatbuffers.h>
 
@@ -45,17 +46,25 @@ namespace reinforcement_learning {
     const payload_buffer_t& get_payload() const;
 
     encoding_type_t get_encoding() const;
+
+    uint32_t get_dictionary_id() const;
+    void set_dictionary_id(uint32_t dictionary_id);
   protected:
     float prg(int drop_pass) const;
+    void set_id(const char* id);
 
   protected:
-    std::string _id;
+    // ids shorter than EVENT_ID_MAX_SIZE (all the generated ones) are stored inline, longer ones in _long_id
+    char _id[EVENT_ID_MAX_SIZE] = {};
+    std::string _long_id;
     timestamp _client_time_gmt;
     payload_type_t _payload_type;
     payload_buffer_t _payload;
     object_list_t _objects;
     float _pass_prob = 1.0;
     event_content_type _content_type;
-    std::string _app_id;
+    uint32_t _dictionary_id = 0;
+    // not owned: points to the logger's app id, which outlives its queued events
+    const char* _app_id = "";
   };
 }
@@ -87,6 +87,30 @@ namespace reinforcement_learning
     return _pimpl->choose_rank(context_json, flags, response, status);
   }
 
+  int live_model::choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<ranking_response>& resps, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->choose_rank_batch(event_ids, contexts_json, flags, resps, status);
+  }
+
+  int live_model::choose_rank_batch(const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<ranking_response>& resps, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->choose_rank_batch(contexts_json, flags, resps, status);
+  }
+
+  int live_model::choose_rank_async(const char* event_id, const char* context_json, unsigned int flags, choose_rank_callback_fn callback, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->choose_rank_async(event_id, context_json, flags, std::move(callback), status);
+  }
+
+  int live_model::choose_rank_async(const char* context_json, unsigned int flags, choose_rank_callback_fn callback, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->choose_rank_async(context_json, flags, std::move(callback), status);
+  }
+
   int live_model::request_continuous_action(const char * event_id, const char * context_json, unsigned int flags, continuous_action_response& response, api_status* status)
   {
     INIT_CHECK();
@@ -237,6 +261,30 @@ namespace reinforcement_learning
     return _pimpl->refresh_model(status);
   }
 
+  int live_model::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<multi_slot_response>& resps, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->request_multi_slot_decision_batch(event_ids, contexts_json, flags, resps, live_model::default_baseline_vector, status);
+  }
+
+  int live_model::request_multi_slot_decision_batch(const std::vector<const char*>& contexts_json, unsigned int flags, std::vector<multi_slot_response>& resps, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->request_multi_slot_decision_batch(contexts_json, flags, resps, live_model::default_baseline_vector, status);
+  }
+
+  int live_model::request_multi_slot_decision_async(const char* event_id, const char* context_json, unsigned int flags, multi_slot_callback_fn callback, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->request_multi_slot_decision_async(event_id, context_json, flags, std::move(callback), live_model::default_baseline_vector, status);
+  }
+
+  int live_model::request_multi_slot_decision_async(const char* context_json, unsigned int flags, multi_slot_callback_fn callback, api_status* status)
+  {
+    INIT_CHECK();
+    return _pimpl->request_multi_slot_decision_async(context_json, flags, std::move(callback), live_model::default_baseline_vector, status);
+  }
+
   int live_model::request_episodic_decision(const char* event_id, const char* previous_id, const char* context_json, ranking_response& resp, episode_state& episode, api_status* status) {
     INIT_CHECK();
     return _pimpl->request_episodic_decision(event_id, previous_id, context_json, action_flags::DEFAULT, resp, episode, status);
@@ -1,6 +1,3 @@
-#include <boost/uuid/uuid_io.hpp>
-#include <boost/uuid/random_generator.hpp>
-
 #include "utility/context_helper.h"
 #include "sender.h"
 #include "api_status.h"
@@ -17,8 +14,10 @@
 #include "hash.h"
 #include "factory_resolver.h"
 #include "logger/preamble_sender.h"
+#include "logger/spool/spool_sender.h"
 #include "sampling.h"
 
+#include <array>
 #include <cstring>
 
 // Some namespace changes for more concise code
@@ -38,7 +37,7 @@ namespace reinforcement_learning {
   int check_null_or_empty(const char* arg1, const char* arg2, i_trace* trace, api_status* status);
   int check_null_or_empty(const char* arg1, i_trace* trace, api_status* status);
   int reset_action_order(ranking_response& response);
-  void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift);
+  void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift, i_event_id_generator& generator);
   int reset_chosen_action_multi_slot(multi_slot_response& response, const std::vector<int>& baseline_actions = std::vector<int>());
   int reset_chosen_action_multi_slot(multi_slot_response_detailed& response, const std::vector<int>& baseline_actions = std::vector<int>());
 
@@ -49,6 +48,7 @@ namespace reinforcement_learning {
 
   int live_model_impl::init(api_status* status) {
     RETURN_IF_FAIL(init_trace(status));
+    RETURN_IF_FAIL(init_event_id_generator(status));
     RETURN_IF_FAIL(init_model(status));
     RETURN_IF_FAIL(init_model_mgmt(status));
     RETURN_IF_FAIL(init_loggers(status));
@@ -108,11 +108,133 @@ namespace reinforcement_learning {
 
   //here the event_id is auto-generated
   int live_model_impl::choose_rank(const char* context, unsigned int flags, ranking_response& response, api_status* status) {
-    const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-    return choose_rank(uuid.c_str(), context, flags, response,
+    char uuid[EVENT_ID_MAX_SIZE];
+    _event_id_generator->generate(uuid);
+    return choose_rank(uuid, context, flags, response,
       status);
   }
 
+  int live_model_impl::choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, std::vector<ranking_response>& responses,
+    api_status* status) {
+    responses.clear();
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    if (event_ids.size() != contexts.size()) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "event_ids and contexts must have the same size";
+    }
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      RETURN_IF_FAIL(check_null_or_empty(event_ids[i], contexts[i], _trace_logger.get(), status));
+    }
+
+    responses.resize(contexts.size());
+    if (!_model_ready) {
+      for (size_t i = 0; i < contexts.size(); ++i) {
+        RETURN_IF_FAIL(explore_only(event_ids[i], contexts[i], responses[i], status));
+        responses[i].set_model_id("N/A");
+      }
+    }
+    else {
+      // The seed used is composed of uniform_hash(app_id) + uniform_hash(event_id)
+      std::vector<uint64_t> seeds(contexts.size());
+      for (size_t i = 0; i < contexts.size(); ++i) {
+        seeds[i] = uniform_hash(event_ids[i], strlen(event_ids[i]), 0) + _seed_shift;
+      }
+
+      std::vector<std::vector<int>> action_ids;
+      std::vector<std::vector<float>> action_pdfs;
+      std::string model_version;
+
+      // The whole batch is ranked by a single model instance
+      RETURN_IF_FAIL(_model->choose_rank_batch(seeds, contexts, action_ids, action_pdfs, model_version, status));
+
+      for (size_t i = 0; i < contexts.size(); ++i) {
+        RETURN_IF_FAIL(sample_and_populate_response(seeds[i], action_ids[i], action_pdfs[i], model_version, responses[i], _trace_logger.get(), status));
+      }
+    }
+
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      responses[i].set_event_id(event_ids[i]);
+
+      if (_learning_mode == LOGGINGONLY)
+      {
+        // Reset the ranked action order before logging
+        RETURN_IF_FAIL(reset_action_order(responses[i]));
+      }
+    }
+
+    RETURN_IF_FAIL(_interaction_logger->log_batch(contexts, flags, responses, status, _learning_mode));
+
+    if (_learning_mode == APPRENTICE)
+    {
+      // Reset the ranked action order after logging
+      for (auto& response : responses) {
+        RETURN_IF_FAIL(reset_action_order(response));
+      }
+    }
+
+    // Check watchdog for any background errors. Do this at the end of function so that the work is still done.
+    if (_watchdog.has_background_error_been_reported()) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, unhandled_background_error_occurred);
+    }
+
+    return error_code::success;
+  }
+
+  //here the event_ids are auto-generated
+  int live_model_impl::choose_rank_batch(const std::vector<const char*>& contexts, unsigned int flags, std::vector<ranking_response>& responses, api_status* status) {
+    std::vector<std::array<char, EVENT_ID_MAX_SIZE>> uuids(contexts.size());
+    std::vector<const char*> event_ids(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      _event_id_generator->generate(uuids[i].data());
+      event_ids[i] = uuids[i].data();
+    }
+    return choose_rank_batch(event_ids, contexts, flags, responses, status);
+  }
+
+  int live_model_impl::choose_rank_async(const char* event_id, const char* context, unsigned int flags, choose_rank_callback_fn callback, api_status* status) {
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    RETURN_IF_FAIL(check_null_or_empty(event_id, context, _trace_logger.get(), status));
+    if (!callback) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "callback is empty";
+    }
+
+    // the caller's buffers may be gone by the time the decision runs
+    const std::string event_id_copy(event_id);
+    const std::string context_copy(context);
+    get_executor().submit([this, event_id_copy, context_copy, flags, callback]() {
+      ranking_response response;
+      api_status task_status;
+      const int result = choose_rank(event_id_copy.c_str(), context_copy.c_str(), flags, response, &task_status);
+      callback(result, response, task_status);
+    });
+    return error_code::success;
+  }
+
+  int live_model_impl::choose_rank_async(const char* context, unsigned int flags, choose_rank_callback_fn callback, api_status* status) {
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    RETURN_IF_FAIL(check_null_or_empty(context, _trace_logger.get(), status));
+    if (!callback) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "callback is empty";
+    }
+
+    const std::string context_copy(context);
+    get_executor().submit([this, context_copy, flags, callback]() {
+      ranking_response response;
+      api_status task_status;
+      const int result = choose_rank(context_copy.c_str(), flags, response, &task_status);
+      callback(result, response, task_status);
+    });
+    return error_code::success;
+  }
+
   int live_model_impl::request_continuous_action(const char* event_id, const char* context, unsigned int flags, continuous_action_response& response, api_status* status)
   {
     response.clear();
@@ -139,8 +261,9 @@ namespace reinforcement_learning {
 
   int live_model_impl::request_continuous_action(const char* context, unsigned int flags, continuous_action_response& response, api_status* status)
   {
-    const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-    return request_continuous_action(uuid.c_str(), context, flags, response, status);
+    char uuid[EVENT_ID_MAX_SIZE];
+    _event_id_generator->generate(uuid);
+    return request_continuous_action(uuid, context, flags, response, status);
   }
 
   int live_model_impl::request_decision(const char* context_json, unsigned int flags, decision_response& resp, api_status* status)
@@ -173,10 +296,7 @@ namespace reinforcement_learning {
 
     std::vector<std::string> event_ids_str(num_decisions);
     std::vector<const char*> event_ids(num_decisions, nullptr);
-    std::map<size_t, std::string> found_ids;
-    RETURN_IF_FAIL(utility::get_event_ids(context_json, found_ids, _trace_logger.get(), status));
-
-    autogenerate_missing_uuids(found_ids, event_ids_str, _seed_shift);
+    autogenerate_missing_uuids(context_info.slot_ids, event_ids_str, _seed_shift, *_event_id_generator);
 
     for (int i = 0; i < event_ids.size(); i++)
     {
@@ -204,7 +324,14 @@ namespace reinforcement_learning {
     //check arguments
     RETURN_IF_FAIL(check_null_or_empty(event_id, _trace_logger.get(), status));
     RETURN_IF_FAIL(check_null_or_empty(context_json, _trace_logger.get(), status));
+    RETURN_IF_FAIL(get_multi_slot_ids(context_json, slot_ids, status));
 
+    RETURN_IF_FAIL(_model->request_multi_slot_decision(event_id, slot_ids, context_json, action_ids, action_pdfs, model_version, status));
+    return error_code::success;
+  }
+
+  int live_model_impl::get_multi_slot_ids(const char* context_json, std::vector<std::string>& slot_ids, api_status* status)
+  {
     utility::ContextInfo context_info;
     RETURN_IF_FAIL(utility::get_context_info(context_json, context_info, _trace_logger.get(), status));
 
@@ -214,18 +341,15 @@ namespace reinforcement_learning {
     }
 
     slot_ids.resize(context_info.slots.size());
-    std::map<size_t, std::string> found_ids;
-    RETURN_IF_FAIL(utility::get_slot_ids(context_json, context_info.slots, found_ids, _trace_logger.get(), status));
-    autogenerate_missing_uuids(found_ids, slot_ids, _seed_shift);
-
-    RETURN_IF_FAIL(_model->request_multi_slot_decision(event_id, slot_ids, context_json, action_ids, action_pdfs, model_version, status));
+    autogenerate_missing_uuids(context_info.slot_ids, slot_ids, _seed_shift, *_event_id_generator);
     return error_code::success;
   }
 
   int live_model_impl::request_multi_slot_decision(const char * context_json, unsigned int flags, multi_slot_response& resp, const std::vector<int>& baseline_actions, api_status* status)
   {
-    const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-    return request_multi_slot_decision(uuid.c_str(), context_json, flags, resp, baseline_actions, status);
+    char uuid[EVENT_ID_MAX_SIZE];
+    _event_id_generator->generate(uuid);
+    return request_multi_slot_decision(uuid, context_json, flags, resp, baseline_actions, status);
   }
 
   int live_model_impl::request_multi_slot_decision(const char * event_id, const char * context_json, unsigned int flags, multi_slot_response& resp, const std::vector<int>& baseline_actions, api_status* status)
@@ -262,8 +386,9 @@ namespace reinforcement_learning {
 
   int live_model_impl::request_multi_slot_decision(const char * context_json, unsigned int flags, multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status)
   {
-    const auto uuid = boost::uuids::to_string(boost::uuids::random_generator()());
-    return request_multi_slot_decision(uuid.c_str(), context_json, flags, resp, baseline_actions, status);
+    char uuid[EVENT_ID_MAX_SIZE];
+    _event_id_generator->generate(uuid);
+    return request_multi_slot_decision(uuid, context_json, flags, resp, baseline_actions, status);
   }
 
   int live_model_impl::request_multi_slot_decision(const char * event_id, const char * context_json, unsigned int flags, multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status)
@@ -302,6 +427,124 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
+  int live_model_impl::request_multi_slot_decision_batch(const std::vector<const char*>& contexts, unsigned int flags, std::vector<multi_slot_response>& resps, const std::vector<int>& baseline_actions, api_status* status)
+  {
+    std::vector<std::array<char, EVENT_ID_MAX_SIZE>> uuids(contexts.size());
+    std::vector<const char*> event_ids(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      _event_id_generator->generate(uuids[i].data());
+      event_ids[i] = uuids[i].data();
+    }
+    return request_multi_slot_decision_batch(event_ids, contexts, flags, resps, baseline_actions, status);
+  }
+
+  int live_model_impl::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, std::vector<multi_slot_response>& resps, const std::vector<int>& baseline_actions, api_status* status)
+  {
+    resps.clear();
+
+    if (_learning_mode == APPRENTICE && baseline_actions.empty())
+    {
+      return error_code::baseline_actions_not_defined;
+    }
+
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    if (event_ids.size() != contexts.size()) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "event_ids and contexts must have the same size";
+    }
+
+    std::vector<std::vector<std::string>> slot_ids(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      RETURN_IF_FAIL(check_null_or_empty(event_ids[i], _trace_logger.get(), status));
+      RETURN_IF_FAIL(check_null_or_empty(contexts[i], _trace_logger.get(), status));
+      RETURN_IF_FAIL(get_multi_slot_ids(contexts[i], slot_ids[i], status));
+    }
+
+    std::vector<std::vector<std::vector<uint32_t>>> action_ids;
+    std::vector<std::vector<std::vector<float>>> action_pdfs;
+    std::string model_version;
+
+    // The whole batch is ranked by a single model instance
+    RETURN_IF_FAIL(_model->request_multi_slot_decision_batch(event_ids, slot_ids, contexts, action_ids, action_pdfs, model_version, status));
+
+    resps.resize(contexts.size());
+    for (size_t i = 0; i < contexts.size(); ++i) {
+      RETURN_IF_FAIL(populate_multi_slot_response(action_ids[i], action_pdfs[i], std::string(event_ids[i]), std::string(model_version), slot_ids[i], resps[i], _trace_logger.get(), status));
+    }
+
+    RETURN_IF_FAIL(_interaction_logger->log_decision_batch(event_ids, contexts, flags, action_ids, action_pdfs, model_version, slot_ids, status, baseline_actions, _learning_mode));
+
+    if (_learning_mode == APPRENTICE || _learning_mode == LOGGINGONLY)
+    {
+      // Reset the chosenAction.
+      // In CCB it does not make sense to reset the action order because the list of actions available for each slot is not deterministic.
+      for (auto& resp : resps) {
+        RETURN_IF_FAIL(reset_chosen_action_multi_slot(resp, baseline_actions));
+      }
+    }
+
+    // Check watchdog for any background errors. Do this at the end of function so that the work is still done.
+    if (_watchdog.has_background_error_been_reported()) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, unhandled_background_error_occurred);
+    }
+    return error_code::success;
+  }
+
+  int live_model_impl::request_multi_slot_decision_async(const char* event_id, const char* context_json, unsigned int flags, multi_slot_callback_fn callback, const std::vector<int>& baseline_actions, api_status* status)
+  {
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    RETURN_IF_FAIL(check_null_or_empty(event_id, context_json, _trace_logger.get(), status));
+    if (!callback) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "callback is empty";
+    }
+
+    const std::string event_id_copy(event_id);
+    const std::string context_copy(context_json);
+    const std::vector<int> baseline_copy(baseline_actions);
+    get_executor().submit([this, event_id_copy, context_copy, flags, callback, baseline_copy]() {
+      multi_slot_response response;
+      api_status task_status;
+      const int result = request_multi_slot_decision(event_id_copy.c_str(), context_copy.c_str(), flags, response, baseline_copy, &task_status);
+      callback(result, response, task_status);
+    });
+    return error_code::success;
+  }
+
+  int live_model_impl::request_multi_slot_decision_async(const char* context_json, unsigned int flags, multi_slot_callback_fn callback, const std::vector<int>& baseline_actions, api_status* status)
+  {
+    //clear previous errors if any
+    api_status::try_clear(status);
+
+    //check arguments
+    RETURN_IF_FAIL(check_null_or_empty(context_json, _trace_logger.get(), status));
+    if (!callback) {
+      RETURN_ERROR_LS(_trace_logger.get(), status, invalid_argument) << "callback is empty";
+    }
+
+    const std::string context_copy(context_json);
+    const std::vector<int> baseline_copy(baseline_actions);
+    get_executor().submit([this, context_copy, flags, callback, baseline_copy]() {
+      multi_slot_response response;
+      api_status task_status;
+      const int result = request_multi_slot_decision(context_copy.c_str(), flags, response, baseline_copy, &task_status);
+      callback(result, response, task_status);
+    });
+    return error_code::success;
+  }
+
+  utility::executor& live_model_impl::get_executor() {
+    std::call_once(_executor_once, [this]() {
+      const int thread_count = _configuration.get_int(name::ASYNC_EXECUTOR_THREAD_COUNT, value::DEFAULT_ASYNC_EXECUTOR_THREAD_COUNT);
+      _executor.reset(new utility::executor(thread_count > 0 ? thread_count : 0));
+    });
+    return *_executor;
+  }
+
   int live_model_impl::report_action_taken(const char* event_id, api_status* status) {
     // Clear previous errors if any
     api_status::try_clear(status);
@@ -415,6 +658,14 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
+  int live_model_impl::init_event_id_generator(api_status* status) {
+    const auto generator_impl = _configuration.get(name::EVENT_ID_GENERATOR_IMPLEMENTATION, value::UUID4_EVENT_ID_GENERATOR);
+    i_event_id_generator* pgenerator;
+    RETURN_IF_FAIL(event_id_generator_factory.create(&pgenerator, generator_impl, _configuration, _trace_logger.get(), status));
+    _event_id_generator.reset(pgenerator);
+    return error_code::success;
+  }
+
   int live_model_impl::init_model(api_status* status) {
     const auto model_impl = _configuration.get(name::MODEL_IMPLEMENTATION, value::VW);
     m::i_model* pmodel;
@@ -432,6 +683,7 @@ namespace reinforcement_learning {
     _configuration.set(config_constants::CONFIG_SECTION, config_constants::INTERACTION);
     RETURN_IF_FAIL(_sender_factory->create(&ranking_data_sender, ranking_sender_impl, _configuration, &_error_cb, _trace_logger.get(), status));
     RETURN_IF_FAIL(ranking_data_sender->init(_configuration, status));
+    RETURN_IF_FAIL(init_spool(ranking_data_sender, config_constants::INTERACTION, status));
 
     // Create a message sender that will prepend the message with a preamble and send the raw data using the
     // factory created raw data sender
@@ -446,6 +698,7 @@ namespace reinforcement_learning {
 
     // Create the logger extension
     _logger_extensions.reset(logger::i_logger_extensions::get_extensions(_configuration, logger_extensions_time_provider));
+    RETURN_IF_FAIL(_logger_extensions->init(status));
 
     i_time_provider* ranking_time_provider;
     RETURN_IF_FAIL(_time_provider_factory->create(&ranking_time_provider, time_provider_impl, _configuration, _trace_logger.get(), status));
@@ -462,6 +715,7 @@ namespace reinforcement_learning {
     _configuration.set(config_constants::CONFIG_SECTION, config_constants::OBSERVATION);
     RETURN_IF_FAIL(_sender_factory->create(&outcome_sender, outcome_sender_impl, _configuration, &_error_cb, _trace_logger.get(), status));
     RETURN_IF_FAIL(outcome_sender->init(_configuration, status));
+    RETURN_IF_FAIL(init_spool(outcome_sender, config_constants::OBSERVATION, status));
 
     // Create a message sender that will prepend the message with a preamble and send the raw data using the
     // factory created raw data sender
@@ -486,6 +740,7 @@ namespace reinforcement_learning {
       _configuration.set(config_constants::CONFIG_SECTION, config_constants::EPISODE);
       RETURN_IF_FAIL(_sender_factory->create(&episode_sender, episode_sender_impl, _configuration, &_error_cb, _trace_logger.get(), status));
       RETURN_IF_FAIL(episode_sender->init(_configuration, status));
+      RETURN_IF_FAIL(init_spool(episode_sender, config_constants::EPISODE, status));
 
       // Create a message sender that will prepend the message with a preamble and send the raw data using the
       // factory created raw data sender
@@ -504,6 +759,16 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
+  int live_model_impl::init_spool(i_sender*& sender, const char* section, api_status* status) {
+    const auto config = utility::get_spool_config(_configuration, section);
+    if (config.directory.empty()) {
+      return error_code::success;
+    }
+    // the batches the sender can't take in time are spilled to local disk and replayed later
+    sender = new logger::spool::spool_sender(sender, config, section, _trace_logger.get(), &_error_cb);
+    return sender->init(_configuration, status);
+  }
+
   void inline live_model_impl::_handle_model_update(const m::model_data& data, live_model_impl* ctxt) {
     ctxt->handle_model_update(data);
   }
@@ -529,7 +794,9 @@ namespace reinforcement_learning {
     api_status* status) const {
 
     // Generate egreedy pdf
-    utility::ContextInfo context_info;
+    // per-thread scratch: the vectors keep their capacity so a warmed up thread does not allocate
+    static thread_local utility::ContextInfo context_info;
+    static thread_local vector<float> pdf;
     RETURN_IF_FAIL(utility::get_context_info(context, context_info, _trace_logger.get(), status));
 
     size_t action_count = context_info.actions.size();
@@ -537,7 +804,7 @@ namespace reinforcement_learning {
         RETURN_ERROR_LS(_trace_logger.get(), status, json_no_actions_found) << "Context must have at least one action";
     }
 
-    vector<float> pdf(action_count);
+    pdf.assign(action_count, 0.f);
     // Generate a pdf with epsilon distributed between all action.
     // The top action gets the remaining (1 - epsilon)
     // Assume that the user's top choice for action is at index 0
@@ -591,13 +858,17 @@ namespace reinforcement_learning {
     // The seed used is composed of uniform_hash(app_id) + uniform_hash(event_id)
     const uint64_t seed = uniform_hash(event_id, strlen(event_id), 0) + _seed_shift;
 
-    std::vector<int> action_ids;
-    std::vector<float> action_pdf;
-    std::string model_version;
+    // per-thread scratch reused across decisions: clear() keeps the capacity
+    static thread_local std::vector<int> action_ids;
+    static thread_local std::vector<float> action_pdf;
+    static thread_local std::string model_version;
+    action_ids.clear();
+    action_pdf.clear();
+    model_version.clear();
 
     RETURN_IF_FAIL(_model->choose_rank(seed, context, action_ids, action_pdf, model_version, status));
 
-    return sample_and_populate_response(seed, action_ids, action_pdf, std::move(model_version), response, _trace_logger.get(), status);
+    return sample_and_populate_response(seed, action_ids, action_pdf, model_version, response, _trace_logger.get(), status);
   }
 
   int live_model_impl::init_model_mgmt(api_status* status) {
@@ -634,7 +905,7 @@ namespace reinforcement_learning {
     const std::string context_patched = history.get_context(previous_id, context_json);
 
     RETURN_IF_FAIL(_model->choose_rank_multistep(seed, context_patched.c_str(), history, action_ids, action_pdf, model_version, status));
-    RETURN_IF_FAIL(sample_and_populate_response(seed, action_ids, action_pdf, std::move(model_version), resp, _trace_logger.get(), status));
+    RETURN_IF_FAIL(sample_and_populate_response(seed, action_ids, action_pdf, model_version, resp, _trace_logger.get(), status));
 
     resp.set_event_id(event_id);
 
@@ -713,7 +984,7 @@ namespace reinforcement_learning {
     return error_code::success;
   }
 
-  void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift) {
+  void autogenerate_missing_uuids(const std::map<size_t, std::string>& found_ids, std::vector<std::string>& complete_ids, uint64_t seed_shift, i_event_id_generator& generator) {
     for (auto ids : found_ids)
     {
       complete_ids[ids.first] = ids.second;
@@ -723,7 +994,9 @@ namespace reinforcement_learning {
     {
       if (complete_ids[i].empty())
       {
-        complete_ids[i] = boost::uuids::to_string(boost::uuids::random_generator()()) + std::to_string(seed_shift);
+        char uuid[EVENT_ID_MAX_SIZE];
+        generator.generate(uuid);
+        complete_ids[i] = uuid + std::to_string(seed_shift);
       }
     }
   }
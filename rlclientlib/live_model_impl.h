@@ -6,13 +6,17 @@
 #include "model_mgmt/data_callback_fn.h"
 #include "model_mgmt/model_downloader.h"
 #include "utility/periodic_background_proc.h"
+#include "utility/executor.h"
 #include "multi_slot_response_detailed.h"
 
 #include "factory_resolver.h"
+#include "event_id_generator.h"
 #include "utility/watchdog.h"
 
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
 
 namespace reinforcement_learning
 {
@@ -24,12 +28,20 @@ namespace reinforcement_learning
   class live_model_impl {
   public:
     using error_fn = void(*)( const api_status&, void* user_context );
+    using choose_rank_callback_fn = std::function<void(int, ranking_response&, const api_status&)>;
+    using multi_slot_callback_fn = std::function<void(int, multi_slot_response&, const api_status&)>;
 
     int init(api_status* status);
 
     int choose_rank(const char* event_id, const char* context, unsigned int flags, ranking_response& response, api_status* status);
     //here the event_id is auto-generated
     int choose_rank(const char* context, unsigned int flags, ranking_response& response, api_status* status);
+    int choose_rank_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, std::vector<ranking_response>& responses, api_status* status);
+    //here the event_ids are auto-generated
+    int choose_rank_batch(const std::vector<const char*>& contexts, unsigned int flags, std::vector<ranking_response>& responses, api_status* status);
+    int choose_rank_async(const char* event_id, const char* context, unsigned int flags, choose_rank_callback_fn callback, api_status* status);
+    //here the event_id is auto-generated
+    int choose_rank_async(const char* context, unsigned int flags, choose_rank_callback_fn callback, api_status* status);
     int request_continuous_action(const char* event_id, const char* context, unsigned int flags, continuous_action_response& response, api_status* status);
     //here the event_id is auto-generated
     int request_continuous_action(const char* context, unsigned int flags, continuous_action_response& response, api_status* status);
@@ -38,6 +50,10 @@ namespace reinforcement_learning
     int request_multi_slot_decision(const char* context_json, unsigned int flags, multi_slot_response& resp, const std::vector<int>& baseline_actions, api_status* status = nullptr);
     int request_multi_slot_decision(const char* event_id, const char* context_json, unsigned int flags, multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status = nullptr);
     int request_multi_slot_decision(const char* context_json, unsigned int flags, multi_slot_response_detailed& resp, const std::vector<int>& baseline_actions, api_status* status = nullptr);
+    int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, std::vector<multi_slot_response>& resps, const std::vector<int>& baseline_actions, api_status* status = nullptr);
+    int request_multi_slot_decision_batch(const std::vector<const char*>& contexts, unsigned int flags, std::vector<multi_slot_response>& resps, const std::vector<int>& baseline_actions, api_status* status = nullptr);
+    int request_multi_slot_decision_async(const char* event_id, const char* context_json, unsigned int flags, multi_slot_callback_fn callback, const std::vector<int>& baseline_actions, api_status* status = nullptr);
+    int request_multi_slot_decision_async(const char* context_json, unsigned int flags, multi_slot_callback_fn callback, const std::vector<int>& baseline_actions, api_status* status = nullptr);
     int request_episodic_decision(const char* event_id, const char* previous_id, const char* context_json, unsigned int flags, ranking_response& resp, episode_state& episode, api_status* status = nullptr);
 
     int report_action_taken(const char* event_id, api_status* status);
@@ -73,7 +89,9 @@ namespace reinforcement_learning
     int init_model(api_status* status);
     int init_model_mgmt(api_status* status);
     int init_loggers(api_status* status);
+    int init_spool(i_sender*& sender, const char* section, api_status* status);
     int init_trace(api_status* status);
+    int init_event_id_generator(api_status* status);
     static void _handle_model_update(const model_management::model_data& data, live_model_impl* ctxt);
     void handle_model_update(const model_management::model_data& data);
     int explore_only(const char* event_id, const char* context, ranking_response& response, api_status* status) const;
@@ -82,6 +100,8 @@ namespace reinforcement_learning
     int report_outcome_internal(const char* event_id, D outcome, api_status* status);
     template<typename D, typename I>
     int report_outcome_internal(const char* primary_id, I secondary_id, D outcome, api_status* status);
+    int get_multi_slot_ids(const char* context_json, std::vector<std::string>& slot_ids, api_status* status);
+    utility::executor& get_executor();
     int request_multi_slot_decision_impl(const char *event_id, const char * context_json, std::vector<std::string>& slot_ids, std::vector<std::vector<uint32_t>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status);
 
   private:
@@ -111,9 +131,15 @@ namespace reinforcement_learning
 
     std::unique_ptr<model_management::model_downloader> _model_download{nullptr};
     std::unique_ptr<i_trace> _trace_logger{nullptr};
+    std::unique_ptr<i_event_id_generator> _event_id_generator{nullptr};
 
     std::unique_ptr<utility::periodic_background_proc<model_management::model_downloader>> _bg_model_proc;
     uint64_t _seed_shift;
+
+    // Started by the first asynchronous call. Declared last so that queued decisions complete before the model and
+    // loggers they use are destroyed.
+    std::once_flag _executor_once;
+    std::unique_ptr<utility::executor> _executor{nullptr};
   };
 
   template <typename D>
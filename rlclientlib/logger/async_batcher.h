@@ -6,6 +6,8 @@
 #include "error_callback_fn.h"
 #include "err_constants.h"
 #include "data_buffer.h"
+#include "batch_compressor.h"
+#include "compression_level_controller.h"
 #include "utility/periodic_background_proc.h"
 
 #include "serialization/fb_serializer.h"
@@ -17,6 +19,8 @@
 // float comparisons
 #include "vw_math.h"
 
+#include <chrono>
+
 namespace reinforcement_learning {
   class error_callback_fn;
 };
@@ -31,6 +35,8 @@ namespace reinforcement_learning { namespace logger {
 
     virtual int append(TEvent&& evt, api_status* status = nullptr) = 0;
     virtual int append(TEvent& evt, api_status* status = nullptr) = 0;
+    //append all events of a batch with a single queue operation
+    virtual int append_batch(std::vector<TEvent>& evts, api_status* status = nullptr) = 0;
 
     virtual int run_iteration(api_status* status) = 0;
   };
@@ -46,16 +52,43 @@ namespace reinforcement_learning { namespace logger {
 
     int append(TEvent&& evt, api_status* status = nullptr) override;
     int append(TEvent& evt, api_status* status = nullptr) override;
+    int append_batch(std::vector<TEvent>& evts, api_status* status = nullptr) override;
 
     int run_iteration(api_status* status) override;
 
+    // how the batch buffers are reused
+    utility::object_pool_stats buffer_pool_stats() const;
+
   private:
+    //serializes what is left of the segment then more events from the queue into buffer, up to the high water mark
     int fill_buffer(std::shared_ptr<utility::data_buffer>& retbuffer,
       size_t& remaining,
       api_status* status);
 
+    //replaces the segment by up to remaining events from the queue, within max_bytes of size estimates
+    size_t drain_segment(size_t& remaining, size_t max_bytes);
+
+    //buffer size for the events left in the segment
+    size_t batch_reserve() const;
+    void update_batch_overhead(size_t serialized_size, size_t estimated_size);
+
     void flush(); //flush all batches
 
+    //waits for the consumer (BLOCK) and returns true, or only wakes it up (DROP) and returns false
+    bool make_room();
+
+    //probability for a new event to be kept in DROP mode, from how full the queue is
+    float admission_pass_prob() const;
+    //applies pass_prob to evt (once per event), returns whether evt is kept
+    bool admit(TEvent& evt, float pass_prob) const;
+
+    //wakes the background thread up once the queued bytes reach the flush threshold
+    void flush_if_over_threshold();
+
+    //picks the compression level of the next batches from the last iteration
+    void adapt_compression_level(float queue_fill);
+    void apply_compression_level(int level);
+
   public:
     async_batcher(i_message_sender* sender,
                   utility::watchdog& watchdog,
@@ -69,16 +102,26 @@ namespace reinforcement_learning { namespace logger {
 
     event_queue<TEvent> _queue;       // A queue to accumulate batch of events.
     size_t _send_high_water_mark;
+    size_t _flush_threshold;          // 0 when flushes are only timer driven
+    std::atomic<bool> _flush_requested{ false };
     error_callback_fn* _perror_cb;
     shared_state_t& _shared_state;
 
     utility::periodic_background_proc<async_batcher> _periodic_background_proc;
-    float _pass_prob;
     queue_mode_enum _queue_mode;
     std::condition_variable _cv;
     std::mutex _m;
     utility::object_pool<utility::data_buffer> _buffer_pool;
+    std::vector<TEvent> _segment;    // events drained from the queue by drain_segment, reused across batches
+    std::vector<size_t> _segment_sizes;    // their size estimates
+    size_t _next_event = 0;          // first event of the segment not serialized yet
     const char* _batch_content_encoding;
+    std::unique_ptr<batch_compressor> _compressor;    // null when batches are not compressed
+    std::unique_ptr<compression_level_controller> _level_controller;    // null when the compression level is static
+    int _shard;                      // index among the batchers sharing _shared_state
+    std::chrono::steady_clock::duration _serialize_time;    // spent in fill_buffer during the current iteration
+    float _batch_overhead;           // serialized size of the batches over the size estimates of their events
+    int _batch_interval_ms;
     float _subsample_rate;
   };
 
@@ -104,19 +147,25 @@ namespace reinforcement_learning { namespace logger {
         return error_code::success;
       }
     }
-    
-    _queue.push(std::move(evt), TSerializer<TEvent>::serializer_t::size_estimate(evt));
 
-    //block or drop events if the queue if full
-    if (_queue.is_full()) {
-      if (queue_mode_enum::BLOCK == _queue_mode) {
-        std::unique_lock<std::mutex> lk(_m);
-        _cv.wait(lk, [this] { return !_queue.is_full(); });
-      }
-      else if (queue_mode_enum::DROP == _queue_mode) {
-        _queue.prune(_pass_prob);
+    // in DROP mode the event is dropped up front rather than making room for it later
+    if (queue_mode_enum::DROP == _queue_mode && !admit(evt, admission_pass_prob())) {
+      return error_code::success;
+    }
+
+    const auto item_size = TSerializer<TEvent>::serializer_t::size_estimate(evt);
+    while (!_queue.push(std::move(evt), item_size)) {
+      // every slot is taken: in DROP mode the event itself is dropped
+      if (!make_room()) {
+        return error_code::success;
       }
     }
+    flush_if_over_threshold();
+
+    //block if the queue is full
+    if (_queue.is_full()) {
+      make_room();
+    }
 
     return error_code::success;
   }
@@ -126,36 +175,213 @@ namespace reinforcement_learning { namespace logger {
     return append(std::move(evt), status);
   }
 
+  template<typename TEvent, template<typename> class TSerializer>
+  int async_batcher<TEvent, TSerializer>::append_batch(std::vector<TEvent>& evts, api_status* status) {
+    std::vector<TEvent> kept;
+    std::vector<size_t> sizes;
+    kept.reserve(evts.size());
+    sizes.reserve(evts.size());
+
+    // the whole batch is admitted against the queue as it was when it came in
+    const float pass_prob = queue_mode_enum::DROP == _queue_mode ? admission_pass_prob() : 1.f;
+    for (auto& evt : evts) {
+      // If subsampling rate is < 1, then run subsampling logic
+      if (_subsample_rate < 1 && evt.try_drop(_subsample_rate, constants::SUBSAMPLE_RATE_DROP_PASS)) {
+        continue;
+      }
+      if (!admit(evt, pass_prob)) {
+        continue;
+      }
+      sizes.push_back(TSerializer<TEvent>::serializer_t::size_estimate(evt));
+      kept.push_back(std::move(evt));
+    }
+
+    if (kept.empty()) {
+      return error_code::success;
+    }
+
+    size_t pushed = 0;
+    while (pushed < kept.size()) {
+      const auto count = _queue.push_batch(kept, sizes, pushed);
+      pushed += count;
+      // same as append: the rest of the batch is dropped when there is no free slot in DROP mode
+      if (count == 0 && !make_room()) {
+        break;
+      }
+    }
+    flush_if_over_threshold();
+
+    //block if the queue is full
+    if (_queue.is_full()) {
+      make_room();
+    }
+
+    return error_code::success;
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  bool async_batcher<TEvent, TSerializer>::make_room() {
+    if (queue_mode_enum::BLOCK == _queue_mode) {
+      // the slots can run out before the bytes reach the threshold, don't wait for the timer either way
+      _flush_requested.store(true, std::memory_order_relaxed);
+      _periodic_background_proc.wake();
+      std::unique_lock<std::mutex> lk(_m);
+      _cv.wait(lk, [this] { return !_queue.is_full(); });
+      return true;
+    }
+    // the events are dropped as they come in, only make sure the consumer doesn't wait for the timer
+    if (!_flush_requested.exchange(true, std::memory_order_relaxed)) {
+      _periodic_background_proc.wake();
+    }
+    return false;
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  float async_batcher<TEvent, TSerializer>::admission_pass_prob() const {
+    const float fill = _queue.fill();
+    if (fill <= constants::QUEUE_DROP_START_FILL) {
+      return 1.f;
+    }
+    return (std::max)((1.f - fill) / (1.f - constants::QUEUE_DROP_START_FILL), 0.f);
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  bool async_batcher<TEvent, TSerializer>::admit(TEvent& evt, float pass_prob) const {
+    if (pass_prob >= 1.f) {
+      return true;
+    }
+    if (pass_prob <= 0.f) {
+      return false;
+    }
+    // the sample only depends on the event id, the kept events record pass_prob
+    return !evt.try_drop(pass_prob, constants::QUEUE_DROP_PASS);
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  void async_batcher<TEvent, TSerializer>::flush_if_over_threshold() {
+    // the flag keeps producers from waking the background thread again until it has started flushing
+    if (_flush_threshold > 0 && _queue.capacity() >= _flush_threshold
+      && !_flush_requested.load(std::memory_order_relaxed)
+      && !_flush_requested.exchange(true, std::memory_order_relaxed)) {
+      _periodic_background_proc.wake();
+    }
+  }
+
   template<typename TEvent, template<typename> class TSerializer>
   int async_batcher<TEvent, TSerializer>::run_iteration(api_status* status) {
+    const float queue_fill = (std::min)(_queue.fill(), 1.f);
+    _flush_requested.store(false, std::memory_order_relaxed);
+    _serialize_time = std::chrono::steady_clock::duration::zero();
     flush();
+    if (_level_controller != nullptr) {
+      adapt_compression_level(queue_fill);
+    }
+    _buffer_pool.trim();
     return error_code::success;
   }
 
+  template<typename TEvent, template<typename> class TSerializer>
+  utility::object_pool_stats async_batcher<TEvent, TSerializer>::buffer_pool_stats() const {
+    return _buffer_pool.stats();
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  void async_batcher<TEvent, TSerializer>::adapt_compression_level(float queue_fill) {
+    using state_compression = shared_state_compression<shared_state_t>;
+    const float busy = std::chrono::duration<float, std::milli>(_serialize_time).count() / _batch_interval_ms;
+    const float ratio = _compressor != nullptr ? _compressor->ratio() : state_compression::ratio(_shared_state);
+    apply_compression_level(_level_controller->update(queue_fill, busy, ratio));
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  void async_batcher<TEvent, TSerializer>::apply_compression_level(int level) {
+    using state_compression = shared_state_compression<shared_state_t>;
+    if (_compressor != nullptr) {
+      _compressor->set_level(level);
+    }
+    if (state_compression::enabled(_shared_state)) {
+      state_compression::set_level(_shared_state, _shard, level);
+    }
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  size_t async_batcher<TEvent, TSerializer>::drain_segment(size_t& remaining, size_t max_bytes) {
+    // take a whole segment of events at once, sized to what is left of the batch
+    _segment.clear();
+    _segment_sizes.clear();
+    _next_event = 0;
+    const auto count = _queue.drain(_segment, remaining, max_bytes, &_segment_sizes);
+    remaining -= count;
+
+    if (count > 0 && queue_mode_enum::BLOCK == _queue_mode) {
+      // taking the lock orders this wake up after a producer that is about to wait
+      { std::lock_guard<std::mutex> lk(_m); }
+      _cv.notify_all();
+    }
+    return count;
+  }
+
   template<typename TEvent, template<typename> class TSerializer>
   int async_batcher<TEvent, TSerializer>::fill_buffer(
                                                       std::shared_ptr<utility::data_buffer>& buffer,
                                                       size_t& remaining,
                                                       api_status* status)
   {
-    TEvent evt;
-    TSerializer<TEvent> collection_serializer(*buffer.get(), _batch_content_encoding, _shared_state);
-
-    while (remaining > 0 && collection_serializer.size() < _send_high_water_mark) {
-      if (_queue.pop(&evt)) {
-        if (queue_mode_enum::BLOCK == _queue_mode) {
-          _cv.notify_one();
-        }
-        RETURN_IF_FAIL(collection_serializer.add(evt, status));
-        --remaining;
+    TSerializer<TEvent> collection_serializer(*buffer.get(), _batch_content_encoding, _shared_state, _compressor.get(), _level_controller.get());
+
+    size_t estimated_size = 0;
+    for (;;) {
+      // the size estimates can be off, what the segment holds beyond the high water mark goes to the next batch
+      while (_next_event < _segment.size() && collection_serializer.size() < _send_high_water_mark) {
+        estimated_size += _segment_sizes[_next_event];
+        RETURN_IF_FAIL(collection_serializer.add(_segment[_next_event++], status));
+      }
+      if (remaining == 0 || collection_serializer.size() >= _send_high_water_mark) {
+        break;
       }
+      if (drain_segment(remaining, _send_high_water_mark - collection_serializer.size()) == 0) {
+        // nothing left to take
+        remaining = 0;
+        break;
+      }
+    }
+    if (_next_event == _segment.size()) {
+      // release the payloads now rather than at the next flush
+      _segment.clear();
+      _segment_sizes.clear();
+      _next_event = 0;
     }
 
+    update_batch_overhead(collection_serializer.size(), estimated_size);
     RETURN_IF_FAIL(collection_serializer.finalize(status));
 
     return error_code::success;
   }
 
+  template<typename TEvent, template<typename> class TSerializer>
+  size_t async_batcher<TEvent, TSerializer>::batch_reserve() const {
+    size_t estimated_size = 0;
+    for (size_t i = _next_event; i < _segment_sizes.size(); ++i) {
+      estimated_size += _segment_sizes[i];
+    }
+    const size_t events = _segment_sizes.size() - _next_event;
+    return static_cast<size_t>(estimated_size * _batch_overhead)
+      + events * constants::BATCH_RESERVE_PER_EVENT + constants::BATCH_RESERVE_HEADER;
+  }
+
+  template<typename TEvent, template<typename> class TSerializer>
+  void async_batcher<TEvent, TSerializer>::update_batch_overhead(size_t serialized_size, size_t estimated_size) {
+    if (estimated_size == 0) {
+      return;
+    }
+    // a batch outgrowing its buffer is copied on each growth while a buffer too large only costs memory, so the
+    // overhead goes up at once and down slowly
+    const float overhead = (std::min)(static_cast<float>(serialized_size) / estimated_size, constants::MAX_BATCH_OVERHEAD);
+    _batch_overhead = overhead > _batch_overhead
+      ? overhead
+      : _batch_overhead + (overhead - _batch_overhead) * constants::BATCH_OVERHEAD_DECAY;
+  }
+
   template<typename TEvent, template<typename> class TSerializer>
   void async_batcher<TEvent, TSerializer>::flush() {
     const auto queue_size = _queue.size();
@@ -167,14 +393,23 @@ namespace reinforcement_learning { namespace logger {
 
     auto remaining = queue_size;
     // Handle batching
-    while (remaining > 0) {
+    while (remaining > 0 || _next_event < _segment.size()) {
       api_status status;
 
-      auto buffer = _buffer_pool.acquire();
+      // the first events of the batch are taken before its buffer so that it can be sized for them, the
+      // flatbuffer builders start at the capacity of the body and grow by copying what they hold
+      if (_next_event == _segment.size() && drain_segment(remaining, _send_high_water_mark) == 0) {
+        break;
+      }
+      const auto reserve = batch_reserve();
+      auto buffer = _buffer_pool.acquire(reserve);
+      buffer->resize_body_region(reserve);
 
+      const auto start = std::chrono::steady_clock::now();
       if (fill_buffer(buffer, remaining, &status) != error_code::success) {
         ERROR_CALLBACK(_perror_cb, status);
       }
+      _serialize_time += std::chrono::steady_clock::now() - start;
 
       if (_sender->send(TSerializer<TEvent>::message_id(), buffer, &status) != error_code::success) {
         ERROR_CALLBACK(_perror_cb, status);
@@ -190,16 +425,34 @@ namespace reinforcement_learning { namespace logger {
     error_callback_fn* perror_cb,
     const utility::async_batcher_config& config)
     : _sender(sender)
-    , _queue(config.send_queue_max_capacity)
+    , _queue(config.send_queue_max_capacity, config.send_queue_max_events)
     , _send_high_water_mark(config.send_high_water_mark)
+    , _flush_threshold(config.send_queue_flush_fraction > 0.f
+      ? (std::min)(static_cast<size_t>(config.send_high_water_mark),
+        (std::max)(static_cast<size_t>(config.send_queue_flush_fraction * config.send_queue_max_capacity), static_cast<size_t>(1)))
+      : 0)
     , _perror_cb(perror_cb)
     , _shared_state(shared_state)
     , _periodic_background_proc(static_cast<int>(config.send_batch_interval_ms), watchdog, "Async batcher thread", perror_cb)
-    , _pass_prob(0.5)
     , _queue_mode(config.queue_mode)
+    , _buffer_pool(config.buffer_pool_max_bytes, config.buffer_pool_idle_ms)
     , _batch_content_encoding(config.batch_content_encoding)
+    , _compressor(config.use_batch_compression ? new batch_compressor(config.batch_compression_level) : nullptr)
+    , _level_controller(config.adaptive_compression_level
+      && (config.use_batch_compression || shared_state_compression<shared_state_t>::enabled(shared_state))
+      ? new compression_level_controller(config.batch_compression_level, config.min_compression_level, config.max_compression_level)
+      : nullptr)
+    , _shard(config.shard)
+    , _serialize_time(std::chrono::steady_clock::duration::zero())
+    , _batch_overhead(constants::INITIAL_BATCH_OVERHEAD)
+    , _batch_interval_ms((std::max)(static_cast<int>(config.send_batch_interval_ms), 1))
     , _subsample_rate(config.subsample_rate)
-  {}
+  {
+    if (_level_controller != nullptr) {
+      // the configured level may be out of the adaptive bounds
+      apply_compression_level(_level_controller->level());
+    }
+  }
 
   template<typename TEvent, template<typename> class TSerializer>
   async_batcher<TEvent, TSerializer>::~async_batcher() {
@@ -0,0 +1,47 @@
+#include "batch_compressor.h"
+#include "api_status.h"
+#include "err_constants.h"
+
+#include "zstd.h"
+
+namespace reinforcement_learning { namespace logger {
+  batch_compressor::batch_compressor(int level)
+    : _context(ZSTD_createCCtx())
+    , _level(level) {}
+
+  batch_compressor::~batch_compressor() {
+    ZSTD_freeCCtx(_context);
+  }
+
+  int batch_compressor::compress(const uint8_t* data, size_t size, api_status* status) {
+    if (_context == nullptr) {
+      RETURN_ERROR_ARG(nullptr, status, compression_error, "Could not create the compression context.");
+    }
+
+    _output.resize(ZSTD_compressBound(size));
+    const size_t res = ZSTD_compressCCtx(_context, _output.data(), _output.size(), data, size, _level);
+    if (ZSTD_isError(res)) {
+      RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res));
+    }
+    _output.resize(res);
+    if (size > 0) {
+      _ratio = static_cast<float>(res) / size;
+    }
+    return error_code::success;
+  }
+
+  int batch_compressor::decompress(const uint8_t* data, size_t size, std::vector<uint8_t>& output, api_status* status) {
+    const auto content_size = ZSTD_getFrameContentSize(data, size);
+    if (content_size == ZSTD_CONTENTSIZE_ERROR)
+      RETURN_ERROR_ARG(nullptr, status, compression_error, "Invalid compressed content.");
+    if (content_size == ZSTD_CONTENTSIZE_UNKNOWN)
+      RETURN_ERROR_ARG(nullptr, status, compression_error, "Unknown compressed size.");
+
+    output.resize(static_cast<size_t>(content_size));
+    const size_t res = ZSTD_decompress(output.data(), output.size(), data, size);
+    if (ZSTD_isError(res))
+      RETURN_ERROR_ARG(nullptr, status, compression_error, ZSTD_getErrorName(res));
+    output.resize(res);
+    return error_code::success;
+  }
+}}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ZSTD_CCtx_s;
+
+namespace reinforcement_learning {
+  class api_status;
+}
+
+namespace reinforcement_learning { namespace logger {
+  // Compresses whole batches with zstd. The compression context and the output storage are kept from one batch to
+  // the next, so a batcher owns one and only uses it from its background thread.
+  class batch_compressor {
+  public:
+    explicit batch_compressor(int level);
+    ~batch_compressor();
+
+    batch_compressor(const batch_compressor&) = delete;
+    batch_compressor& operator=(const batch_compressor&) = delete;
+
+    // compresses [data, data + size[ into output()
+    int compress(const uint8_t* data, size_t size, api_status* status);
+    const std::vector<uint8_t>& output() const { return _output; }
+
+    int level() const { return _level; }
+    void set_level(int level) { _level = level; }
+    // compressed over uncompressed size of the last batch
+    float ratio() const { return _ratio; }
+
+    static int decompress(const uint8_t* data, size_t size, std::vector<uint8_t>& output, api_status* status);
+
+  private:
+    ZSTD_CCtx_s* _context;
+    std::vector<uint8_t> _output;
+    int _level;
+    float _ratio = 1.f;
+  };
+}}
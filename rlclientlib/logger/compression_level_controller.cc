@@ -0,0 +1,48 @@
+#include "compression_level_controller.h"
+
+#include "zstd.h"
+
+#include <algorithm>
+
+namespace reinforcement_learning { namespace logger {
+  namespace {
+    const float HIGH_QUEUE_FILL = 0.5f;
+    const float LOW_QUEUE_FILL = 0.1f;
+    const float HIGH_BUSY = 0.5f;
+    // compressing harder what hardly compresses doesn't save enough bytes to be worth it
+    const float MAX_USEFUL_RATIO = 0.9f;
+    const float RATIO_WEIGHT = 0.2f;
+  }
+
+  compression_level_controller::compression_level_controller(int level, int min_level, int max_level)
+    : _min_level((std::max)(min_level, 1))
+    , _max_level((std::max)((std::min)(max_level, ZSTD_maxCLevel()), _min_level))
+    , _base_level(clamp(level))
+    , _level(_base_level) {}
+
+  int compression_level_controller::update(float queue_fill, float busy, float ratio) {
+    const float average = (1.f - RATIO_WEIGHT) * _ratio.load(std::memory_order_relaxed) + RATIO_WEIGHT * ratio;
+    _ratio.store(average, std::memory_order_relaxed);
+
+    int level = _level.load(std::memory_order_relaxed);
+    if (busy >= HIGH_BUSY) {
+      --level;
+    }
+    else if (queue_fill >= HIGH_QUEUE_FILL) {
+      if (average < MAX_USEFUL_RATIO) {
+        ++level;
+      }
+    }
+    else if (queue_fill <= LOW_QUEUE_FILL && level != _base_level) {
+      level += level < _base_level ? 1 : -1;
+    }
+
+    level = clamp(level);
+    _level.store(level, std::memory_order_relaxed);
+    return level;
+  }
+
+  int compression_level_controller::clamp(int level) const {
+    return (std::min)((std::max)(level, _min_level), _max_level);
+  }
+}}
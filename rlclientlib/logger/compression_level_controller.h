@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+
+namespace reinforcement_learning { namespace logger {
+  // Picks the zstd level of the next batches within [min_level, max_level] from what the batcher observed during its
+  // last iteration. The level goes up while the queue fills up (the sender falls behind, so smaller batches help) as
+  // long as compression pays off, it goes down when compressing takes most of the batch interval (the batcher thread
+  // is CPU bound), and it moves back to the configured level once the pressure is gone.
+  // Only the batcher thread updates it, the level and ratio can be read from any thread.
+  class compression_level_controller {
+  public:
+    compression_level_controller(int level, int min_level, int max_level);
+
+    // queue_fill: queued bytes over the queue capacity when the iteration started
+    // busy: time spent serializing and compressing over the batch interval
+    // ratio: compressed over uncompressed size achieved with the current level
+    // returns the level to use for the next batches
+    int update(float queue_fill, float busy, float ratio);
+
+    int level() const { return _level.load(std::memory_order_relaxed); }
+    // moving average of the ratios passed to update
+    float ratio() const { return _ratio.load(std::memory_order_relaxed); }
+
+  private:
+    int clamp(int level) const;
+
+    const int _min_level;
+    const int _max_level;
+    const int _base_level;
+    std::atomic<int> _level;
+    std::atomic<float> _ratio{ 1.f };
+  };
+
+  // Lets the controller of a batcher drive the per event compression done with the shared state of its serializer
+  // (see dedup_state). The state is shared by the shards of a batcher, each shard sets the level of its own events.
+  // The default is for shared states that don't compress.
+  template<typename TState>
+  struct shared_state_compression {
+    static bool enabled(const TState&) { return false; }
+    static float ratio(const TState&) { return 1.f; }
+    static void set_level(TState&, int /*shard*/, int /*level*/) {}
+  };
+}}
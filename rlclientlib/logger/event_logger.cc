@@ -8,6 +8,16 @@ namespace reinforcement_learning { namespace logger {
     return append(ranking_event::choose_rank(event_id, context, flags, response, now, 1.0f, learning_mode), status);
   }
 
+  int interaction_logger::log_batch(const std::vector<const char*>& contexts, unsigned int flags, const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode) {
+    const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+    std::vector<ranking_event> events;
+    events.reserve(responses.size());
+    for (size_t i = 0; i < responses.size(); ++i) {
+      events.push_back(ranking_event::choose_rank(responses[i].get_event_id(), contexts[i], flags, responses[i], now, 1.0f, learning_mode));
+    }
+    return append_batch(std::move(events), status);
+  }
+
   int ccb_logger::log_decisions(std::vector<const char*>& event_ids, const char* context, unsigned int flags, const std::vector<std::vector<uint32_t>>& action_ids,
     const std::vector<std::vector<float>>& pdfs, const std::string& model_version, api_status* status) {
     const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
@@ -21,6 +31,18 @@ namespace reinforcement_learning { namespace logger {
     return append(std::move(multi_slot_decision_event::request_decision(event_id, context, flags, action_ids, pdfs, model_version, now)), status);
   }
 
+  int multi_slot_logger::log_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+      const std::vector<std::vector<std::vector<float>>>& pdfs, const std::string& model_version, api_status* status) {
+
+    const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+    std::vector<multi_slot_decision_event> events;
+    events.reserve(event_ids.size());
+    for (size_t i = 0; i < event_ids.size(); ++i) {
+      events.push_back(multi_slot_decision_event::request_decision(event_ids[i], contexts[i], flags, action_ids[i], pdfs[i], model_version, now));
+    }
+    return append_batch(std::move(events), status);
+  }
+
   int observation_logger::report_action_taken(const char* event_id, api_status* status) {
     const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
     return append(outcome_event::report_action_taken(event_id, now), status);
@@ -33,7 +55,23 @@ namespace reinforcement_learning { namespace logger {
 
   int generic_event_logger::log(const char* event_id, generic_event::payload_buffer_t&& payload, generic_event::payload_type_t type, event_content_type content_type, generic_event::object_list_t&& objects, api_status* status) {
     const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
-    return append(generic_event(event_id, now, type, std::move(payload), content_type, std::move(objects), _app_id), status);
+    generic_event evt(event_id, now, type, std::move(payload), content_type, std::move(objects), _app_id);
+    if (content_type == event_content_type::ZSTD) {
+      evt.set_dictionary_id(_dictionary_id);
+    }
+    return append(std::move(evt), status);
   }
 
+  int generic_event_logger::log_batch(const std::vector<const char*>& event_ids, std::vector<generic_event::payload_buffer_t>&& payloads, generic_event::payload_type_t type, const std::vector<event_content_type>& content_types, std::vector<generic_event::object_list_t>&& objects, api_status* status) {
+    const auto now = _time_provider != nullptr ? _time_provider->gmt_now() : timestamp();
+    std::vector<generic_event> events;
+    events.reserve(event_ids.size());
+    for (size_t i = 0; i < event_ids.size(); ++i) {
+      events.emplace_back(event_ids[i], now, type, std::move(payloads[i]), content_types[i], std::move(objects[i]), _app_id);
+      if (content_types[i] == event_content_type::ZSTD) {
+        events.back().set_dictionary_id(_dictionary_id);
+      }
+    }
+    return append_batch(std::move(events), status);
+  }
 }}
@@ -34,6 +34,7 @@ namespace reinforcement_learning { namespace logger {
   protected:
     int append(TEvent&& item, api_status* status);
     int append(TEvent& item, api_status* status);
+    int append_batch(std::vector<TEvent>&& items, api_status* status);
 
   protected:
     bool _initialized = false;
@@ -80,6 +81,18 @@ namespace reinforcement_learning { namespace logger {
     return append(std::move(item), status);
   }
 
+  template<typename TEvent>
+  int event_logger<TEvent>::append_batch(std::vector<TEvent>&& items, api_status* status) {
+    if (!_initialized) {
+      api_status::try_update(status, error_code::not_initialized,
+        "Logger not initialized. Call init() first.");
+      return error_code::not_initialized;
+    }
+
+    // Add all items to the batch with a single queue operation
+    return _batcher->append_batch(items, status);
+  }
+
   class interaction_logger : public event_logger<ranking_event> {
   public:
     interaction_logger(i_time_provider* time_provider, i_async_batcher<ranking_event>* batcher)
@@ -87,6 +100,7 @@ namespace reinforcement_learning { namespace logger {
     {}
 
     int log(const char* event_id, const char* context, unsigned int flags, const ranking_response& response, api_status* status, learning_mode learning_mode = ONLINE);
+    int log_batch(const std::vector<const char*>& contexts, unsigned int flags, const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode = ONLINE);
   };
 
 class ccb_logger : public event_logger<decision_ranking_event> {
@@ -107,6 +121,8 @@ class multi_slot_logger : public event_logger<multi_slot_decision_event> {
 
     int log_decision(const std::string &event_id, const char* context, unsigned int flags, const std::vector<std::vector<uint32_t>>& action_ids,
       const std::vector<std::vector<float>>& pdfs, const std::string& model_version, api_status* status);
+    int log_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+      const std::vector<std::vector<std::vector<float>>>& pdfs, const std::string& model_version, api_status* status);
   };
 
   class observation_logger : public event_logger<outcome_event> {
@@ -126,11 +142,17 @@ class multi_slot_logger : public event_logger<multi_slot_decision_event> {
 
   class generic_event_logger : public event_logger<generic_event> {
   public:
-    generic_event_logger(i_time_provider* time_provider, i_async_batcher<generic_event>* batcher, const char* app_id)
+    // dictionary_id is recorded in the events whose payload was zstd compressed (0 when no dictionary is used)
+    generic_event_logger(i_time_provider* time_provider, i_async_batcher<generic_event>* batcher, const char* app_id, uint32_t dictionary_id = 0)
       : event_logger(time_provider, batcher, app_id)
+      , _dictionary_id(dictionary_id)
     {}
 
     int log(const char* event_id, generic_event::payload_buffer_t&& payload, generic_event::payload_type_t type, event_content_type content_type, api_status* status);
     int log(const char* event_id, generic_event::payload_buffer_t&& payload, generic_event::payload_type_t type, event_content_type content_type, generic_event::object_list_t&& objects, api_status* status);
+    int log_batch(const std::vector<const char*>& event_ids, std::vector<generic_event::payload_buffer_t>&& payloads, generic_event::payload_type_t type, const std::vector<event_content_type>& content_types, std::vector<generic_event::object_list_t>&& objects, api_status* status);
+
+  private:
+    uint32_t _dictionary_id;
   };
 }}
@@ -1,89 +1,198 @@
 #pragma once
 
 #include "ranking_event.h"
+#include "constants.h"
 
-#include <list>
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <mutex>
 #include <type_traits>
 
 namespace reinforcement_learning {
 
-  //a moving concurrent queue with locks and mutex
+  //a bounded multi-producer/single-consumer ring of events with byte capacity accounting
+  //producers claim slots with a CAS on the tail and publish them through the slot sequence number (lock and
+  //allocation free), the consumer side (pop and drain) is serialized by a mutex that producers never take
   template <class T>
   class event_queue {
   private:
-    using queue_t = std::list<std::pair<T,size_t>>;
-    using iterator_t = typename queue_t::iterator;
+    struct slot {
+      std::atomic<size_t> sequence;
+      T item;
+      size_t item_size;
+    };
 
-    queue_t _queue;
-    std::mutex _mutex;
-    int _drop_pass{ 0 };
-    size_t _capacity{ 0 };
+    std::unique_ptr<slot[]> _slots;
+    const size_t _mask;
+    // the producer and consumer counters live on separate cache lines
+    char _pad0[64];
+    std::atomic<size_t> _tail{ 0 };
+    char _pad1[64];
+    std::atomic<size_t> _head{ 0 };
+    char _pad2[64];
+    std::atomic<size_t> _capacity{ 0 };
+    std::mutex _consumer_mutex;
     size_t _max_capacity{ 0 };
 
   public:
-    event_queue(size_t max_capacity) 
-      : _max_capacity(max_capacity) {
+    //max_capacity is in bytes, max_events (rounded up to a power of two) is the number of slots
+    event_queue(size_t max_capacity, size_t max_events = value::DEFAULT_SEND_QUEUE_MAX_EVENTS)
+      : _slots(new slot[round_up_pow2(max_events)])
+      , _mask(round_up_pow2(max_events) - 1)
+      , _max_capacity(max_capacity) {
+      for (size_t i = 0; i <= _mask; ++i) {
+        _slots[i].sequence.store(i, std::memory_order_relaxed);
+        _slots[i].item_size = 0;
+      }
     }
 
+    event_queue(const event_queue&) = delete;
+    event_queue& operator=(const event_queue&) = delete;
+
     bool pop(T* item)
     {
-      std::unique_lock<std::mutex> mlock(_mutex);
-      if (!_queue.empty())
-      {
-        auto entry(std::move(_queue.front()));
-        *item = std::move(entry.first);
-        _capacity = (std::max)(0, static_cast<int>(_capacity) - static_cast<int>(entry.second));
-        _queue.pop_front();
-        return true;
+      std::unique_lock<std::mutex> mlock(_consumer_mutex);
+      slot* s = published_head();
+      if (s == nullptr) return false;
+      if (item != nullptr) {
+        *item = std::move(s->item);
+      }
+      release_head(s);
+      return true;
+    }
+
+    //moves up to max_events events into out under a single consumer lock, stopping before max_bytes would be
+    //exceeded (the first event is always taken), returns the number of events moved. Their sizes go to out_sizes
+    //when not null
+    size_t drain(std::vector<T>& out, size_t max_events, size_t max_bytes, std::vector<size_t>* out_sizes = nullptr)
+    {
+      std::unique_lock<std::mutex> mlock(_consumer_mutex);
+      size_t pos = _head.load(std::memory_order_relaxed);
+      size_t count = 0;
+      size_t bytes = 0;
+      while (count < max_events) {
+        slot& s = _slots[pos & _mask];
+        if (s.sequence.load(std::memory_order_acquire) != pos + 1) break;
+        if (count > 0 && bytes + s.item_size > max_bytes) break;
+        out.push_back(std::move(s.item));
+        if (out_sizes != nullptr) {
+          out_sizes->push_back(s.item_size);
+        }
+        bytes += s.item_size;
+        ++count;
+        s.sequence.store(pos + _mask + 1, std::memory_order_release);
+        ++pos;
       }
-      return false;
+      _head.store(pos, std::memory_order_release);
+      _capacity.fetch_sub(bytes, std::memory_order_relaxed);
+      return count;
     }
 
-    void push(T& item, size_t item_size) {
-      push(std::move(item), item_size);
+    //returns false, leaving item untouched, when there is no free slot
+    bool push(T& item, size_t item_size) {
+      return push(std::move(item), item_size);
     }
 
-    void push(T&& item, size_t item_size)
+    bool push(T&& item, size_t item_size)
     {
-      std::unique_lock<std::mutex> mlock(_mutex);
-      _capacity += item_size;
-      _queue.push_back({std::forward<T>(item),item_size});
+      size_t pos;
+      if (!claim(1, pos)) return false;
+      publish(pos, std::move(item), item_size);
+      return true;
     }
 
-    void prune(float pass_prob)
+    //pushes a prefix of items with a single claim, returns how many were pushed (less than items.size() when the
+    //ring is too full)
+    size_t push_batch(std::vector<T>& items, const std::vector<size_t>& item_sizes, size_t offset = 0)
     {
-      std::unique_lock<std::mutex> mlock(_mutex);
-      if (!is_full()) return;
-      for (auto it = _queue.begin(); it != _queue.end();) {
-        it = it->first.try_drop(pass_prob, _drop_pass) ? erase(it) : (++it);
+      size_t count = (std::min)(items.size() - offset, _mask + 1);
+      size_t pos;
+      while (count > 0 && !claim(count, pos)) {
+        count /= 2;
+      }
+      for (size_t i = 0; i < count; ++i) {
+        publish(pos + i, std::move(items[offset + i]), item_sizes[offset + i]);
       }
-      ++_drop_pass;
+      return count;
     }
 
     //approximate size
     size_t size()
     {
-      std::unique_lock<std::mutex> mlock(_mutex);
-      return _queue.size();
+      const auto head = _head.load(std::memory_order_acquire);
+      const auto tail = _tail.load(std::memory_order_acquire);
+      return tail > head ? tail - head : 0;
     }
 
+    //full when either the byte capacity or the slots are used up
     bool is_full() const {
-      return capacity() >= _max_capacity;
+      return capacity() >= _max_capacity
+        || _tail.load(std::memory_order_relaxed) - _head.load(std::memory_order_relaxed) > _mask;
+    }
+
+    size_t capacity() const
+    {
+      return _capacity.load(std::memory_order_relaxed);
     }
 
-    size_t capacity() const 
+    //approximate share of the bytes or of the slots in use, whichever is higher (can go over 1 for the bytes)
+    float fill() const
     {
-      return _capacity;
+      const size_t head = _head.load(std::memory_order_relaxed);
+      const size_t tail = _tail.load(std::memory_order_relaxed);
+      const float slots = tail > head ? static_cast<float>(tail - head) / (_mask + 1) : 0.f;
+      const float bytes = _max_capacity > 0 ? static_cast<float>(capacity()) / _max_capacity : 1.f;
+      return (std::max)(slots, bytes);
     }
 
   private:
-    //thread-unsafe
-    iterator_t erase(iterator_t it) {
-      _capacity = (std::max)(0, static_cast<int>(_capacity) - static_cast<int>(it->second));
-      return _queue.erase(it);
+    static size_t round_up_pow2(size_t n) {
+      size_t v = 1;
+      while (v < n) v <<= 1;
+      return v;
+    }
+
+    //claims count consecutive positions starting at pos
+    bool claim(size_t count, size_t& pos) {
+      pos = _tail.load(std::memory_order_relaxed);
+      for (;;) {
+        // the consumer frees slots in order, so the last slot being free means they all are
+        const size_t last = pos + count - 1;
+        const size_t seq = _slots[last & _mask].sequence.load(std::memory_order_acquire);
+        if (seq != last) {
+          if (seq < last) return false; // still holds an event from the previous lap
+          pos = _tail.load(std::memory_order_relaxed);
+          continue;
+        }
+        if (_tail.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+          return true;
+        }
+      }
+    }
+
+    void publish(size_t pos, T&& item, size_t item_size) {
+      slot& s = _slots[pos & _mask];
+      s.item = std::move(item);
+      s.item_size = item_size;
+      _capacity.fetch_add(item_size, std::memory_order_relaxed);
+      s.sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    //thread-unsafe, requires the consumer mutex
+    slot* published_head() {
+      const size_t pos = _head.load(std::memory_order_relaxed);
+      slot& s = _slots[pos & _mask];
+      return s.sequence.load(std::memory_order_acquire) == pos + 1 ? &s : nullptr;
+    }
+
+    //thread-unsafe, requires the consumer mutex
+    void release_head(slot* s) {
+      const size_t pos = _head.load(std::memory_order_relaxed);
+      _capacity.fetch_sub(s->item_size, std::memory_order_relaxed);
+      s->sequence.store(pos + _mask + 1, std::memory_order_release);
+      _head.store(pos + 1, std::memory_order_release);
     }
   };
 }
-
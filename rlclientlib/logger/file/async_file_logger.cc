@@ -0,0 +1,341 @@
+#include "async_file_logger.h"
+#include "api_status.h"
+#include "err_constants.h"
+#include "error_callback_fn.h"
+#include "logger/spool/mapped_file.h"
+#include "trace_logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace reinforcement_learning { namespace logger { namespace file {
+  namespace {
+    // iovecs per gather write, well under IOV_MAX everywhere
+    const int MAX_IOV = 256;
+
+    void split_path(const std::string& path, std::string& directory, std::string& name) {
+      const auto separator = path.find_last_of("/\\");
+      if (separator == std::string::npos) {
+        directory = ".";
+        name = path;
+      }
+      else {
+        directory = separator == 0 ? path.substr(0, 1) : path.substr(0, separator);
+        name = path.substr(separator + 1);
+      }
+    }
+
+    bool is_empty_file(const std::string& path) {
+      std::ifstream file(path, std::ios::binary | std::ios::ate);
+      return !file.good() || file.tellg() <= 0;
+    }
+  }
+
+  async_file_logger::async_file_logger(const std::string& file_name, const utility::file_sender_config& config,
+    i_trace* trace, error_callback_fn* perror_cb)
+    : _file_name(file_name)
+    , _config(config)
+    , _trace(trace)
+    , _perror_cb(perror_cb) {}
+
+  async_file_logger::~async_file_logger() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_running) {
+        close_file();
+        return;
+      }
+      _running = false;
+    }
+    // the writer writes what is left, syncs it and rotates the file before it exits
+    _writer_cv.notify_all();
+    _sender_cv.notify_all();
+    _thread.join();
+  }
+
+  int async_file_logger::init(const utility::configuration& config, api_status* status) {
+    if (rotation_enabled()) {
+      // rotated files are <file_name>.<sequence>, carry on after the ones already there
+      std::string directory, name;
+      split_path(_file_name, directory, name);
+      std::vector<std::string> names;
+      RETURN_IF_FAIL(spool::list_files(directory, name + ".", names, status));
+      for (const auto& rotated : names) {
+        const auto digits = rotated.substr(name.size() + 1);
+        if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) continue;
+        _next_sequence = (std::max)(_next_sequence, static_cast<uint64_t>(std::strtoull(digits.c_str(), nullptr, 10)) + 1);
+      }
+      // what a previous process left in the file is rotated rather than overwritten
+      if (!is_empty_file(_file_name)) {
+        RETURN_IF_FAIL(rotate(status));
+      }
+    }
+    RETURN_IF_FAIL(open_file(status));
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    try {
+      _running = true;
+      _thread = std::thread(&async_file_logger::run, this);
+    }
+    catch (const std::exception& e) {
+      _running = false;
+      RETURN_ERROR_LS(_trace, status, background_thread_start) << " (async file logger)" << e.what();
+    }
+    return error_code::success;
+  }
+
+  int async_file_logger::v_send(const buffer& data, api_status* status) {
+    std::shared_ptr<write_group> group;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _sender_cv.wait(lock, [this] { return _front.empty() || _front_bytes < _config.max_pending_bytes || !_running; });
+      if (!_running) {
+        RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " Error: the writer is stopped";
+      }
+      _front.push_back(data);
+      _front_bytes += data->buffer_filled_size();
+      if (_config.durability == file_durability_enum::BATCH) {
+        if (!_front_group) {
+          _front_group = std::make_shared<write_group>();
+        }
+        group = _front_group;
+      }
+    }
+    _writer_cv.notify_one();
+
+    if (group) {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _sender_cv.wait(lock, [&group] { return group->done; });
+      if (group->result != error_code::success) {
+        RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name;
+      }
+    }
+    return error_code::success;
+  }
+
+  void async_file_logger::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+      if (_front.empty() && _running) {
+        const auto deadline = next_deadline();
+        if (deadline == clock::time_point::max()) {
+          _writer_cv.wait(lock);
+        }
+        else {
+          _writer_cv.wait_until(lock, deadline);
+        }
+      }
+
+      // the batches sent meanwhile are written together
+      std::shared_ptr<write_group> group;
+      _back.swap(_front);
+      _front_bytes = 0;
+      group.swap(_front_group);
+      const bool running = _running;
+      lock.unlock();
+      _sender_cv.notify_all();
+
+      api_status status;
+      int result = error_code::success;
+      const bool wrote = !_back.empty();
+      if (wrote) {
+        result = write_all(_back, &status);
+        _back.clear();
+      }
+
+      const auto now = clock::now();
+      if (result == error_code::success && _unsynced && _config.durability != file_durability_enum::NONE
+        && (!running || (wrote && _config.durability == file_durability_enum::BATCH)
+          || now - _last_sync >= std::chrono::milliseconds(_config.sync_interval_ms))) {
+        result = sync(&status);
+      }
+      if (result == error_code::success && (rotation_due(now) || (!running && rotation_enabled() && _file_bytes > 0))) {
+        result = rotate(&status);
+        if (result == error_code::success && running) {
+          result = open_file(&status);
+        }
+      }
+      if (result != error_code::success) {
+        ERROR_CALLBACK(_perror_cb, status);
+      }
+
+      lock.lock();
+      if (group) {
+        group->done = true;
+        group->result = result;
+        _sender_cv.notify_all();
+      }
+      if (!running && _front.empty()) break;
+    }
+    lock.unlock();
+    close_file();
+  }
+
+  bool async_file_logger::rotation_enabled() const {
+    return _config.rotate_size > 0 || _config.rotate_interval_ms > 0;
+  }
+
+  bool async_file_logger::rotation_due(clock::time_point now) const {
+    if (_file_bytes == 0) return false;
+    return (_config.rotate_size > 0 && _file_bytes >= _config.rotate_size)
+      || (_config.rotate_interval_ms > 0 && now - _file_opened >= std::chrono::milliseconds(_config.rotate_interval_ms));
+  }
+
+  async_file_logger::clock::time_point async_file_logger::next_deadline() const {
+    auto deadline = clock::time_point::max();
+    if (_unsynced && _config.durability == file_durability_enum::INTERVAL) {
+      deadline = _last_sync + std::chrono::milliseconds(_config.sync_interval_ms);
+    }
+    if (_file_bytes > 0 && _config.rotate_interval_ms > 0) {
+      deadline = (std::min)(deadline, _file_opened + std::chrono::milliseconds(_config.rotate_interval_ms));
+    }
+    return deadline;
+  }
+
+  int async_file_logger::rotate(api_status* status) {
+    if (_unsynced && _config.durability != file_durability_enum::NONE) {
+      RETURN_IF_FAIL(sync(status));
+    }
+    close_file();
+
+    std::ostringstream rotated;
+    rotated << _file_name << "." << std::setw(10) << std::setfill('0') << _next_sequence++;
+    if (std::rename(_file_name.c_str(), rotated.str().c_str()) != 0) {
+      RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " cannot be renamed to "
+        << rotated.str() << " Error:" << std::strerror(errno);
+    }
+    _file_bytes = 0;
+    return error_code::success;
+  }
+
+#ifdef _WIN32
+  int async_file_logger::open_file(api_status* status) {
+    _fd = _open(_file_name.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (_fd < 0) {
+      RETURN_ERROR_LS(_trace, status, file_open_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+    }
+    _file_bytes = 0;
+    _unsynced = false;
+    _last_sync = clock::now();
+    return error_code::success;
+  }
+
+  void async_file_logger::close_file() {
+    if (_fd >= 0) _close(_fd);
+    _fd = -1;
+  }
+
+  int async_file_logger::write_all(const std::vector<buffer>& batches, api_status* status) {
+    if (_file_bytes == 0) _file_opened = clock::now();
+    for (const auto& batch : batches) {
+      const auto* data = batch->preamble_begin();
+      size_t left = batch->buffer_filled_size();
+      while (left > 0) {
+        const unsigned chunk = static_cast<unsigned>((std::min)(left, static_cast<size_t>(1u << 30)));
+        const int written = _write(_fd, data, chunk);
+        if (written < 0) {
+          RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+        }
+        data += written;
+        left -= written;
+        _file_bytes += written;
+      }
+    }
+    _unsynced = true;
+    return error_code::success;
+  }
+
+  int async_file_logger::sync(api_status* status) {
+    if (_commit(_fd) != 0) {
+      RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+    }
+    _unsynced = false;
+    _last_sync = clock::now();
+    return error_code::success;
+  }
+#else
+  int async_file_logger::open_file(api_status* status) {
+    _fd = ::open(_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+      RETURN_ERROR_LS(_trace, status, file_open_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+    }
+    _file_bytes = 0;
+    _unsynced = false;
+    _last_sync = clock::now();
+    return error_code::success;
+  }
+
+  void async_file_logger::close_file() {
+    if (_fd >= 0) ::close(_fd);
+    _fd = -1;
+  }
+
+  int async_file_logger::write_all(const std::vector<buffer>& batches, api_status* status) {
+    if (_file_bytes == 0) _file_opened = clock::now();
+    iovec iov[MAX_IOV];
+    size_t next = 0;      // first batch not completely written
+    size_t offset = 0;    // bytes of it already written
+    while (next < batches.size()) {
+      int count = 0;
+      for (size_t i = next; i < batches.size() && count < MAX_IOV; ++i) {
+        const size_t skip = i == next ? offset : 0;
+        const size_t size = batches[i]->buffer_filled_size() - skip;
+        if (size == 0) continue;
+        iov[count].iov_base = batches[i]->preamble_begin() + skip;
+        iov[count].iov_len = size;
+        ++count;
+      }
+      ssize_t written = 0;
+      if (count > 0) {
+        written = ::writev(_fd, iov, count);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+        }
+      }
+      _file_bytes += static_cast<size_t>(written);
+
+      // a short write resumes in the middle of a batch
+      size_t left = static_cast<size_t>(written);
+      while (next < batches.size() && batches[next]->buffer_filled_size() - offset <= left) {
+        left -= batches[next]->buffer_filled_size() - offset;
+        offset = 0;
+        ++next;
+      }
+      offset += left;
+    }
+    _unsynced = true;
+    return error_code::success;
+  }
+
+  int async_file_logger::sync(api_status* status) {
+#ifdef __APPLE__
+    const int res = ::fsync(_fd);
+#else
+    const int res = ::fdatasync(_fd);
+#endif
+    if (res != 0) {
+      RETURN_ERROR_LS(_trace, status, file_write_error) << " File:" << _file_name << " Error:" << std::strerror(errno);
+    }
+    _unsynced = false;
+    _last_sync = clock::now();
+    return error_code::success;
+  }
+#endif
+}}}
@@ -0,0 +1,86 @@
+#pragma once
+#include "sender.h"
+#include "utility/config_helper.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace reinforcement_learning {
+  class error_callback_fn;
+  class i_trace;
+}
+
+namespace reinforcement_learning { namespace logger { namespace file {
+  // Writes batches to a file from a thread of its own instead of the batcher thread.
+  // v_send only hands the batch over: the batches sent while the writer is busy pile up in the front buffer and the
+  // writer takes them all at once, swapping it with its back buffer, and writes them with a single gather write.
+  // How much survives a machine crash is set by the durability policy (see utility::file_sender_config). With
+  // rotation on, the file is closed and renamed to <file_name>.<sequence> when it is big or old enough, so
+  // collectors only ever pick up complete files.
+  class async_file_logger : public i_sender {
+  public:
+    async_file_logger(const std::string& file_name, const utility::file_sender_config& config, i_trace* trace,
+      error_callback_fn* perror_cb);
+    ~async_file_logger();
+
+    async_file_logger(const async_file_logger&) = delete;
+    async_file_logger(async_file_logger&&) = delete;
+    async_file_logger& operator=(const async_file_logger&) = delete;
+    async_file_logger& operator=(async_file_logger&&) = delete;
+
+    int init(const utility::configuration& config, api_status* status) override;
+
+  protected:
+    // waits until the batch is on disk with the BATCH durability, or while more than max_pending_bytes are waiting
+    int v_send(const buffer& data, api_status* status) override;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    // the batches written by one gather write, the BATCH durability senders wait on it
+    struct write_group {
+      bool done = false;
+      int result = 0;
+    };
+
+    void run();
+    int write_all(const std::vector<buffer>& batches, api_status* status);
+    int sync(api_status* status);
+    int open_file(api_status* status);
+    void close_file();
+    // closes the file and renames it to the next sequence, open_file starts the next one
+    int rotate(api_status* status);
+    bool rotation_enabled() const;
+    bool rotation_due(clock::time_point now) const;
+    clock::time_point next_deadline() const;
+
+    const std::string _file_name;
+    const utility::file_sender_config _config;
+    i_trace* _trace;
+    error_callback_fn* _perror_cb;
+
+    std::mutex _mutex;
+    std::condition_variable _writer_cv;   // batches to write or shutdown
+    std::condition_variable _sender_cv;   // room in the front buffer or a write group done
+    std::vector<buffer> _front;
+    size_t _front_bytes = 0;
+    std::shared_ptr<write_group> _front_group;
+    bool _running = false;
+    std::thread _thread;
+
+    // only used by the writer thread once it runs
+    std::vector<buffer> _back;
+    int _fd = -1;
+    uint64_t _next_sequence = 0;
+    size_t _file_bytes = 0;
+    bool _unsynced = false;
+    clock::time_point _file_opened;     // when the first batch went to the file
+    clock::time_point _last_sync;
+  };
+}}}
@@ -23,4 +23,60 @@ namespace reinforcement_learning {
     memmove(_buffer.body_begin() + new_size - in_use_back, _buffer.body_begin() + old_size - in_use_back, in_use_back);
     return _buffer.body_begin();
   }
+
+  pooled_flatbuffer_allocator& pooled_flatbuffer_allocator::get_instance() {
+    static auto* instance = new pooled_flatbuffer_allocator();
+    return *instance;
+  }
+
+  pooled_flatbuffer_allocator::pooled_flatbuffer_allocator(size_t max_cached_bytes_per_class)
+    : _max_cached_bytes_per_class(max_cached_bytes_per_class) {}
+
+  pooled_flatbuffer_allocator::~pooled_flatbuffer_allocator() {
+    for (auto& blocks : _free_blocks) {
+      for (auto* p : blocks) {
+        delete[] p;
+      }
+    }
+  }
+
+  size_t pooled_flatbuffer_allocator::size_class(size_t size) {
+    size_t cls = 0;
+    while (cls < CLASS_COUNT && (size_t(1) << (MIN_CLASS_SHIFT + cls)) < size) {
+      ++cls;
+    }
+    return cls;
+  }
+
+  uint8_t* pooled_flatbuffer_allocator::allocate(size_t size) {
+    const auto cls = size_class(size);
+    if (cls == CLASS_COUNT) {
+      return new uint8_t[size];
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto& blocks = _free_blocks[cls];
+      if (!blocks.empty()) {
+        auto* p = blocks.back();
+        blocks.pop_back();
+        return p;
+      }
+    }
+    return new uint8_t[size_t(1) << (MIN_CLASS_SHIFT + cls)];
+  }
+
+  void pooled_flatbuffer_allocator::deallocate(uint8_t* p, size_t size) {
+    const auto cls = size_class(size);
+    if (cls < CLASS_COUNT) {
+      const size_t block_size = size_t(1) << (MIN_CLASS_SHIFT + cls);
+      std::lock_guard<std::mutex> lock(_mutex);
+      auto& blocks = _free_blocks[cls];
+      if ((blocks.size() + 1) * block_size <= _max_cached_bytes_per_class) {
+        blocks.push_back(p);
+        return;
+      }
+    }
+    delete[] p;
+  }
 }
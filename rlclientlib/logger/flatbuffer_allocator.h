@@ -2,6 +2,10 @@
 #include "data_buffer.h"
 #include "flatbuffers/flatbuffers.h"
 
+#include <array>
+#include <mutex>
+#include <vector>
+
 namespace reinforcement_learning {
   class flatbuffer_allocator : public flatbuffers::Allocator {
 
@@ -15,4 +19,33 @@ namespace reinforcement_learning {
   private:
     utility::data_buffer& _buffer;
   };
+
+  // Thread safe allocator recycling freed blocks by power of two size class, so that builders which release their
+  // buffer (payload serializers) do not hit the heap once warmed up. Blocks above the largest class are not pooled.
+  class pooled_flatbuffer_allocator : public flatbuffers::Allocator {
+  public:
+    // Released buffers keep a pointer to their allocator and may outlive any owner, so the shared instance is
+    // never destroyed.
+    static pooled_flatbuffer_allocator& get_instance();
+
+    explicit pooled_flatbuffer_allocator(size_t max_cached_bytes_per_class = 4 * 1024 * 1024);
+    ~pooled_flatbuffer_allocator();
+
+    pooled_flatbuffer_allocator(const pooled_flatbuffer_allocator&) = delete;
+    pooled_flatbuffer_allocator& operator=(const pooled_flatbuffer_allocator&) = delete;
+
+    uint8_t* allocate(size_t size) override;
+    void deallocate(uint8_t *p, size_t size) override;
+
+  private:
+    static const size_t MIN_CLASS_SHIFT = 8;  // 256 bytes
+    static const size_t CLASS_COUNT = 13;     // up to 1 MB
+
+    // returns CLASS_COUNT when size is too large to be pooled
+    static size_t size_class(size_t size);
+
+    std::mutex _mutex;
+    std::array<std::vector<uint8_t*>, CLASS_COUNT> _free_blocks;
+    const size_t _max_cached_bytes_per_class;
+  };
 }
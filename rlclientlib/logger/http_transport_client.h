@@ -2,6 +2,7 @@
 #define OPENSSL_API_COMPAT 0x0908
 
 #include "api_status.h"
+#include "constants.h"
 #include "moving_queue.h"
 #include "sender.h"
 #include "error_callback_fn.h"
@@ -13,11 +14,17 @@
 #include "utility/header_authorization.h"
 #include "utility/eventhub_http_authorization.h"
 #include "utility/stl_container_adapter.h"
+#include "utility/timer_queue.h"
 
 #include <pplx/pplxtasks.h>
 #include <cpprest/http_headers.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <random>
 #include <sstream>
 #include "data_buffer.h"
 
@@ -32,55 +39,37 @@ namespace reinforcement_learning {
 
   template <typename TAuthorization>
   // The http_transport_client sends string data in POST requests to an HTTP endpoint using the passed in authorization headers.
+  // At most max_in_flight requests are outstanding, a request is started by the completion of the previous one when
+  // the window is full, so send only waits when as many batches are queued behind the window. All the requests go
+  // through the same i_http_client, which keeps its connections alive from one request to the next.
+  // A failed request is retried after an exponential backoff with jitter, on a timer rather than a blocked thread.
+  // All the clients of the process share that timer thread (see timer_queue::shared).
   class http_transport_client : public i_sender {
   public:
     virtual int init(const utility::configuration& config, api_status* status) override;
 
     // Takes the ownership of the i_http_client and delete it at the end of lifetime
-    http_transport_client(i_http_client* client, size_t tasks_count, size_t MAX_RETRIES, i_trace* trace, error_callback_fn* _error_cb);
+    http_transport_client(i_http_client* client, size_t max_in_flight, size_t max_retries, i_trace* trace, error_callback_fn* _error_cb,
+      milliseconds min_retry_delay = milliseconds(value::DEFAULT_HTTP_RETRY_MIN_DELAY_MS),
+      milliseconds max_retry_delay = milliseconds(value::DEFAULT_HTTP_RETRY_MAX_DELAY_MS));
+    // Waits for the queued and in flight requests to complete
     ~http_transport_client();
   protected:
     int v_send(const buffer& data, api_status* status) override;
 
   private:
-    class http_request_task {
-    public:
-      using buffer = std::shared_ptr< utility::data_buffer>;
-      http_request_task() = default;
-      http_request_task(
-        i_http_client* client,
-        http_headers headers,
-        const buffer& data,
-        size_t max_retries = 1, // If MAX_RETRIES is set to 1, only the initial request will be attempted.
-        error_callback_fn* error_callback = nullptr,
-        i_trace* trace = nullptr);
-
-      // The constructor kicks off an async request which captures the this variable. If this object is moved then the
-      // this pointer is invalidated and causes tricky bugs.
-      http_request_task(http_request_task&& other) = delete;
-      http_request_task& operator=(http_request_task&& other) = delete;
-      http_request_task(const http_request_task&) = delete;
-      http_request_task& operator=(const http_request_task&) = delete;
-
-      // Return error_code
-      int join();
-    private:
-      pplx::task<web::http::status_code> send_request(size_t try_count);
-
-      i_http_client* _client;
-      http_headers _headers;
-      buffer _post_data;
-
-      pplx::task<web::http::status_code> _task;
-
-      size_t _max_retries = 1;
-
-      error_callback_fn* _error_callback;
-      i_trace* _trace;
+    struct http_request_state {
+      http_headers headers;
+      buffer post_data;
+      size_t try_count = 0;
     };
+    using request_ptr = std::shared_ptr<http_request_state>;
 
-  private:
-    int pop_task(api_status* status);
+    void start_request(const request_ptr& request);
+    void on_response(const request_ptr& request, web::http::status_code code);
+    // frees the window slot of request or hands it to the next queued request
+    void complete(const request_ptr& request);
+    milliseconds retry_delay(size_t try_count);
 
     // cannot be copied or assigned
     http_transport_client(const http_transport_client&) = delete;
@@ -93,143 +82,154 @@ namespace reinforcement_learning {
     TAuthorization _authorization;
 
     std::mutex _mutex;
-    moving_queue<std::unique_ptr<http_request_task>> _tasks;
-    const size_t _max_tasks_count;
+    std::condition_variable _cv;
+    size_t _in_flight = 0;
+    moving_queue<request_ptr> _queued;
+    std::minstd_rand _jitter;
+
+    const size_t _max_in_flight;
     const size_t _max_retries;
+    const milliseconds _min_retry_delay;
+    const milliseconds _max_retry_delay;
     i_trace* _trace;
     error_callback_fn* _error_callback;
+
+    // a retry keeps its window slot, so no retry of this client is left once the destructor is done waiting
+    std::shared_ptr<utility::timer_queue> _retry_timer;
   };
 
   template <typename TAuthorization>
-  http_transport_client<TAuthorization>::http_request_task::http_request_task(
-    i_http_client* client,
-    http_headers headers,
-    const buffer& post_data,
-    size_t max_retries,
-    error_callback_fn* error_callback,
-    i_trace* trace)
-    : _client(client),
-    _headers(headers),
-    _post_data(post_data),
-    _max_retries(max_retries),
-    _error_callback(error_callback),
-    _trace(trace)
-    {
-      _task = send_request(0 /* inital try */);
-    }
+  int http_transport_client<TAuthorization>::init(const utility::configuration& config, api_status* status) {
+    RETURN_IF_FAIL(_authorization.init(config, status, _trace));
+    return error_code::success;
+  }
 
   template <typename TAuthorization>
-  pplx::task<web::http::status_code> http_transport_client<TAuthorization>::http_request_task::send_request(size_t try_count) {
-    http_request request(methods::POST);
-    request.headers() = _headers;
-
-    utility::stl_container_adapter container(_post_data.get());
-    const size_t container_size = container.size();
-    const auto stream = concurrency::streams::bytestream::open_istream(container);
-    request.set_body(stream, container_size);
-
-    return _client->request(request).then([this, try_count](pplx::task<http_response> response) {
-      web::http::status_code code = status_codes::InternalError;
-      api_status status;
-
-      try {
-        code = response.get().status_code();
-      }
-      catch (const std::exception& e) {
-        TRACE_ERROR(_trace, e.what());
-      }
-
-      // If the response is not the expected code then it has failed. Retry if possible otherwise report background error.
-      if(code != status_codes::Created && code != status_codes::NoContent) {
-        // Stop condition of recurison.
-        if (try_count < _max_retries) {
-          TRACE_ERROR(_trace, "HTTP request failed, retrying...");
-
-          // Yes, recursively send another request inside this one. If a subsequent request returns success we are good, otherwise the failure will propagate.
-          return send_request(try_count + 1).get();
-        }
-        else {
-          auto msg = u::concat("(expected 201): Found ", code, ", failed after ", try_count, " retries.");
-          api_status::try_update(&status, error_code::http_bad_status_code, msg.c_str());
-          ERROR_CALLBACK(_error_callback, status);
+  int http_transport_client<TAuthorization>::v_send(const buffer& post_data, api_status* status) {
+    auto request = std::make_shared<http_request_state>();
+    RETURN_IF_FAIL(_authorization.insert_authorization_header(request->headers, status, _trace));
+    request->post_data = post_data;
 
-          return code;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_in_flight >= _max_in_flight) {
+        // the request is started when one in flight completes, the caller only waits when the queue is full too
+        _cv.wait(lock, [this] { return _in_flight < _max_in_flight || _queued.size() < _max_in_flight; });
+        if (_in_flight >= _max_in_flight) {
+          _queued.push(std::move(request));
+          return error_code::success;
         }
       }
-
-      // We have succeeded, return success.
-      return code;
-    });
+      ++_in_flight;
+    }
+    start_request(request);
+    return error_code::success;
   }
 
   template <typename TAuthorization>
-  int http_transport_client<TAuthorization>::http_request_task::join() {
-    _task.get();
-
-    // The task may have failed but was reported with the callback. This function's primary purpose
-    // is to block if the task is not yet complete.
-    return error_code::success;
+  void http_transport_client<TAuthorization>::start_request(const request_ptr& request) {
+    try {
+      http_request http_request(methods::POST);
+      http_request.headers() = request->headers;
+
+      utility::stl_container_adapter container(request->post_data.get());
+      const size_t container_size = container.size();
+      const auto stream = concurrency::streams::bytestream::open_istream(container);
+      http_request.set_body(stream, container_size);
+
+      _client->request(http_request).then([this, request](pplx::task<http_response> response) {
+        web::http::status_code code = status_codes::InternalError;
+        try {
+          code = response.get().status_code();
+        }
+        catch (const std::exception& e) {
+          TRACE_ERROR(_trace, e.what());
+        }
+        on_response(request, code);
+      });
+    }
+    catch (const std::exception& e) {
+      TRACE_ERROR(_trace, e.what());
+      on_response(request, status_codes::InternalError);
+    }
   }
 
   template <typename TAuthorization>
-  int http_transport_client<TAuthorization>::init(const utility::configuration& config, api_status* status) {
-    RETURN_IF_FAIL(_authorization.init(config, status, _trace));
-    return error_code::success;
+  void http_transport_client<TAuthorization>::on_response(const request_ptr& request, web::http::status_code code) {
+    // If the response is not the expected code then it has failed. Retry if possible otherwise report background error.
+    if (code != status_codes::Created && code != status_codes::NoContent) {
+      if (request->try_count < _max_retries) {
+        TRACE_ERROR(_trace, "HTTP request failed, retrying...");
+        ++request->try_count;
+        try {
+          _retry_timer->schedule(retry_delay(request->try_count), [this, request] { start_request(request); });
+          return;
+        }
+        catch (const std::exception& e) {
+          TRACE_ERROR(_trace, e.what());
+        }
+      }
+      api_status status;
+      auto msg = u::concat("(expected 201): Found ", code, ", failed after ", request->try_count, " retries.");
+      api_status::try_update(&status, error_code::http_bad_status_code, msg.c_str());
+      ERROR_CALLBACK(_error_callback, status);
+    }
+    complete(request);
   }
 
   template <typename TAuthorization>
-  int http_transport_client<TAuthorization>::pop_task(api_status* status) {
-    // This function must be under a lock as there is a delay between popping from the queue and joining the task, but it should essentially be atomic.
-    std::lock_guard<std::mutex> lock(_mutex);
+  void http_transport_client<TAuthorization>::complete(const request_ptr& request) {
+    // the buffer goes back to its pool right away
+    request->post_data.reset();
 
-    std::unique_ptr<http_request_task> oldest;
-    _tasks.pop(&oldest);
-
-    try {
-      // This will block if the task is not complete yet.
-      RETURN_IF_FAIL(oldest->join());
+    request_ptr next;
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_queued.size() > 0) {
+        _queued.pop(&next);
+      }
+      else {
+        --_in_flight;
+      }
+      _cv.notify_all();
     }
-    catch (...) {
-      // Ignore if there is an exception surfaced as this should have been handled in the continuation.
-      TRACE_WARN(_trace, "There should not be an exception raised in pop_task function.");
+    // the slot stays taken by next, so the destructor keeps waiting
+    if (next) {
+      start_request(next);
     }
-
-    return error_code::success;
   }
 
   template <typename TAuthorization>
-  int http_transport_client<TAuthorization>::v_send(const buffer& post_data, api_status* status) {
-    http_headers headers;
-    RETURN_IF_FAIL(_authorization.insert_authorization_header(headers, status, _trace));
-
-    try {
-      // Before creating the task, ensure that it is allowed to be created.
-      if (_tasks.size() >= _max_tasks_count) {
-        RETURN_IF_FAIL(pop_task(status));
-      }
-
-      std::unique_ptr<http_request_task> request_task(new http_request_task(_client.get(), headers, post_data, _max_retries, _error_callback, _trace));
-      _tasks.push(std::move(request_task));
-    }
-    catch (const std::exception& e) {
-      RETURN_ERROR_LS(_trace, status, eventhub_http_generic) << e.what();
+  milliseconds http_transport_client<TAuthorization>::retry_delay(size_t try_count) {
+    // the delay doubles with each retry up to the max, the actual wait is drawn from its upper half so that the
+    // clients failing together don't retry together
+    milliseconds delay = _min_retry_delay;
+    for (size_t i = 1; i < try_count && delay < _max_retry_delay; ++i) {
+      delay *= 2;
     }
-    return error_code::success;
+    delay = (std::min)(delay, _max_retry_delay);
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::uniform_int_distribution<milliseconds::rep> jitter(delay.count() / 2, delay.count());
+    return milliseconds(jitter(_jitter));
   }
 
   template <typename TAuthorization>
-  http_transport_client<TAuthorization>::http_transport_client(i_http_client* client, size_t max_tasks_count, size_t max_retries, i_trace* trace, error_callback_fn* error_callback)
+  http_transport_client<TAuthorization>::http_transport_client(i_http_client* client, size_t max_in_flight, size_t max_retries, i_trace* trace, error_callback_fn* error_callback,
+    milliseconds min_retry_delay, milliseconds max_retry_delay)
     : _client(client)
-    , _max_tasks_count(max_tasks_count)
+    , _jitter(std::random_device{}())
+    , _max_in_flight((std::max)(max_in_flight, static_cast<size_t>(1)))
     , _max_retries(max_retries)
+    , _min_retry_delay((std::max)(min_retry_delay, milliseconds(0)))
+    , _max_retry_delay((std::max)(max_retry_delay, _min_retry_delay))
     , _trace(trace)
-    , _error_callback(error_callback) {
+    , _error_callback(error_callback)
+    , _retry_timer(utility::timer_queue::shared()) {
   }
 
   template <typename TAuthorization>
   http_transport_client<TAuthorization>::~http_transport_client() {
-    while (_tasks.size() != 0) {
-      pop_task(nullptr);
-    }
+    std::unique_lock<std::mutex> lock(_mutex);
+    _cv.wait(lock, [this] { return _in_flight == 0; });
   }
 }
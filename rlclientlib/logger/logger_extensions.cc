@@ -1,4 +1,5 @@
 #include "logger/logger_facade.h"
+#include "logger/sharded_async_batcher.h"
 #include "dedup.h"
 
 namespace reinforcement_learning { namespace logger {
@@ -12,12 +13,15 @@ public:
 
 	i_async_batcher<generic_event>* create_batcher(i_message_sender* sender, utility::watchdog& watchdog, error_callback_fn* perror_cb, const char* section) override {
 		auto config = utility::get_batcher_config(_config, section);
-		return new async_batcher<generic_event, fb_collection_serializer>(
-				sender,
-				watchdog,
-				_dummy_state,
-				perror_cb,
-				config);
+		return create_sharded_batcher<generic_event>(sender, config,
+			[&](i_message_sender* shard_sender, const utility::async_batcher_config& shard_config) {
+				return new async_batcher<generic_event, fb_collection_serializer>(
+						shard_sender,
+						watchdog,
+						_dummy_state,
+						perror_cb,
+						shard_config);
+			});
 	}
 
 	bool is_object_extraction_enabled() const override { return false; }
@@ -39,6 +43,9 @@ private:
 i_logger_extensions::i_logger_extensions(const utility::configuration& config): _config(config) { }
 i_logger_extensions::~i_logger_extensions() { }
 
+int i_logger_extensions::init(api_status* status) { return error_code::success; }
+uint32_t i_logger_extensions::get_compression_dictionary_id() const { return 0; }
+
 
 i_logger_extensions* i_logger_extensions::get_extensions(const utility::configuration& config, i_time_provider* time_provider) {
 	const char *section = "interaction"; //fixme lift this to live_model_impl;
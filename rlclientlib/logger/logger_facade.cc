@@ -43,7 +43,8 @@ namespace reinforcement_learning {
     , _v2(_version == 2 ? new generic_event_logger(
       time_provider,
       ext.create_batcher(sender, watchdog, perror_cb, INTERACTION_SECTION),
-      c.get(name::APP_ID, "")) : nullptr) {
+      c.get(name::APP_ID, ""),
+      ext.get_compression_dictionary_id()) : nullptr) {
     }
 
     int interaction_logger_facade::init(api_status* status) {
@@ -95,6 +96,28 @@ namespace reinforcement_learning {
       }
     }
 
+    int interaction_logger_facade::log_batch(const std::vector<const char*>& contexts, unsigned int flags, const std::vector<ranking_response>& responses, api_status* status, learning_mode learning_mode) {
+      switch (_version) {
+        case 1: return _v1_cb->log_batch(contexts, flags, responses, status, learning_mode);
+        case 2: {
+          v2::LearningModeType lmt;
+          RETURN_IF_FAIL(get_learning_mode(learning_mode, lmt, status));
+
+          std::vector<const char*> event_ids(responses.size());
+          std::vector<generic_event::object_list_t> actions(responses.size());
+          std::vector<generic_event::payload_buffer_t> payloads(responses.size());
+          std::vector<event_content_type> content_types(responses.size());
+
+          for (size_t i = 0; i < responses.size(); ++i) {
+            event_ids[i] = responses[i].get_event_id();
+            RETURN_IF_FAIL(wrap_log_call(_ext, _serializer_cb, contexts[i], actions[i], payloads[i], content_types[i], status, flags, lmt, responses[i]));
+          }
+          return _v2->log_batch(event_ids, std::move(payloads), _serializer_cb.type, content_types, std::move(actions), status);
+        }
+        default: return protocol_not_supported(status);
+      }
+    }
+
     int interaction_logger_facade::log(const char* episode_id, const char* previous_id, const char* context, unsigned int flags, const ranking_response& response, api_status* status) {
       switch (_version) {
         case 2: {
@@ -158,6 +181,36 @@ namespace reinforcement_learning {
       }
     }
 
+    int interaction_logger_facade::log_decision_batch(const std::vector<const char*>& event_ids, const std::vector<const char*>& contexts, unsigned int flags, const std::vector<std::vector<std::vector<uint32_t>>>& action_ids,
+      const std::vector<std::vector<std::vector<float>>>& pdfs, const std::string& model_version, const std::vector<std::vector<std::string>>& slot_ids, api_status* status,
+      const std::vector<int>& baseline_actions, learning_mode learning_mode) {
+      switch (_version) {
+      case 1: {
+        switch (_model_type) {
+        case model_type_t::SLATES: return _v1_multislot->log_decision_batch(event_ids, contexts, flags, action_ids, pdfs, model_version, status);
+        default: RETURN_ERROR_ARG(nullptr, status, protocol_not_supported, "multi_slot logger under v1 protocol can only log slates.");
+        }
+      }
+      case 2: {
+        v2::LearningModeType lmt;
+        RETURN_IF_FAIL(get_learning_mode(learning_mode, lmt, status));
+
+        generic_event::payload_type_t payload_type;
+        RETURN_IF_FAIL(multi_slot_model_type_to_payload_type(_model_type, payload_type, status));
+
+        std::vector<generic_event::object_list_t> actions(event_ids.size());
+        std::vector<generic_event::payload_buffer_t> payloads(event_ids.size());
+        std::vector<event_content_type> content_types(event_ids.size());
+
+        for (size_t i = 0; i < event_ids.size(); ++i) {
+          RETURN_IF_FAIL(wrap_log_call(_ext, _serializer_multislot, contexts[i], actions[i], payloads[i], content_types[i], status, flags, action_ids[i], pdfs[i], model_version, slot_ids[i], baseline_actions, lmt));
+        }
+        return _v2->log_batch(event_ids, std::move(payloads), payload_type, content_types, std::move(actions), status);
+      }
+      default: return protocol_not_supported(status);
+      }
+    }
+
     int interaction_logger_facade::log_continuous_action(const char* context, unsigned int flags, const continuous_action_response& response, api_status* status) {
       switch (_version) {
       case 2: {
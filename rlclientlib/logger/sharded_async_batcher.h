@@ -0,0 +1,110 @@
+#pragma once
+
+#include "async_batcher.h"
+#include "message_sender.h"
+#include "utility/config_helper.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace reinforcement_learning { namespace logger {
+  // Serializes the sends of several batchers into one message sender (senders are not required to be thread safe).
+  // The wrapped sender is shared, not owned.
+  class shared_message_sender : public i_message_sender {
+  public:
+    struct state {
+      explicit state(i_message_sender* sender) : sender(sender) {}
+      std::unique_ptr<i_message_sender> sender;
+      std::mutex mutex;
+    };
+
+    explicit shared_message_sender(std::shared_ptr<state> state) : _state(std::move(state)) {}
+
+    int send(const uint16_t msg_type, const buffer& db, api_status* status = nullptr) override {
+      std::lock_guard<std::mutex> lock(_state->mutex);
+      return _state->sender->send(msg_type, db, status);
+    }
+
+    // the wrapped sender was initialized by its creator
+    int init(api_status* status = nullptr) override { return error_code::success; }
+
+  private:
+    std::shared_ptr<state> _state;
+  };
+
+  // index of the shard the calling thread logs to
+  // threads are numbered in the order they first log, so that they spread evenly over the shards
+  inline size_t thread_shard(size_t shards_count) {
+    static std::atomic<size_t> next_thread{ 0 };
+    static thread_local const size_t thread_index = next_thread.fetch_add(1, std::memory_order_relaxed);
+    return thread_index % shards_count;
+  }
+
+  // Spreads events over several batchers, each with its own queue, serializer and background thread, so that
+  // serialization and compression scale with the number of logging threads.
+  // A thread always appends to the same shard, which keeps the order of the events it logs.
+  template<typename TEvent>
+  class sharded_async_batcher : public i_async_batcher<TEvent> {
+  public:
+    explicit sharded_async_batcher(std::vector<std::unique_ptr<i_async_batcher<TEvent>>>&& shards)
+      : _shards(std::move(shards)) {}
+
+    int init(api_status* status) override {
+      for (auto& shard : _shards) {
+        RETURN_IF_FAIL(shard->init(status));
+      }
+      return error_code::success;
+    }
+
+    int append(TEvent&& evt, api_status* status = nullptr) override {
+      return current_shard().append(std::move(evt), status);
+    }
+
+    int append(TEvent& evt, api_status* status = nullptr) override {
+      return append(std::move(evt), status);
+    }
+
+    int append_batch(std::vector<TEvent>& evts, api_status* status = nullptr) override {
+      return current_shard().append_batch(evts, status);
+    }
+
+    int run_iteration(api_status* status) override {
+      for (auto& shard : _shards) {
+        RETURN_IF_FAIL(shard->run_iteration(status));
+      }
+      return error_code::success;
+    }
+
+  private:
+    i_async_batcher<TEvent>& current_shard() {
+      return *_shards[thread_shard(_shards.size())];
+    }
+
+    std::vector<std::unique_ptr<i_async_batcher<TEvent>>> _shards;
+  };
+
+  // Creates config.batcher_shards batchers with create_shard, or a single one when sharding is off.
+  // The shards share sender, the queue capacity and slots of config are split between them.
+  template<typename TEvent>
+  i_async_batcher<TEvent>* create_sharded_batcher(i_message_sender* sender, const utility::async_batcher_config& config,
+    const std::function<i_async_batcher<TEvent>*(i_message_sender*, const utility::async_batcher_config&)>& create_shard) {
+    if (config.batcher_shards <= 1) {
+      return create_shard(sender, config);
+    }
+
+    auto shard_config = config;
+    shard_config.send_queue_max_capacity = (std::max)(config.send_queue_max_capacity / config.batcher_shards, 1);
+    shard_config.send_queue_max_events = (std::max)(config.send_queue_max_events / config.batcher_shards, 1);
+
+    const auto state = std::make_shared<shared_message_sender::state>(sender);
+    std::vector<std::unique_ptr<i_async_batcher<TEvent>>> shards;
+    for (int i = 0; i < config.batcher_shards; ++i) {
+      shard_config.shard = i;
+      shards.emplace_back(create_shard(new shared_message_sender(state), shard_config));
+    }
+    return new sharded_async_batcher<TEvent>(std::move(shards));
+  }
+}}
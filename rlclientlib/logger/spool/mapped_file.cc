@@ -0,0 +1,209 @@
+#include "mapped_file.h"
+#include "api_status.h"
+#include "err_constants.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  mapped_file::~mapped_file() {
+    close();
+  }
+
+#ifdef _WIN32
+  int mapped_file::open(const std::string& path, size_t size, api_status* status) {
+    close();
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS,
+      FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot open " << path << " Error:" << GetLastError();
+    }
+    LARGE_INTEGER current;
+    if (!GetFileSizeEx(file, &current)) {
+      const auto error = GetLastError();
+      CloseHandle(file);
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot stat " << path << " Error:" << error;
+    }
+    const uint64_t mapped_size = (std::max)(static_cast<uint64_t>(current.QuadPart), static_cast<uint64_t>(size));
+    if (mapped_size == 0) {
+      CloseHandle(file);
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "empty segment " << path;
+    }
+    // the mapping grows the file to its size
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(mapped_size >> 32),
+      static_cast<DWORD>(mapped_size & 0xFFFFFFFF), nullptr);
+    void* data = mapping == nullptr ? nullptr : MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(mapped_size));
+    if (data == nullptr) {
+      const auto error = GetLastError();
+      if (mapping != nullptr) CloseHandle(mapping);
+      CloseHandle(file);
+      if (error == ERROR_DISK_FULL) {
+        RETURN_ERROR_LS(nullptr, status, spool_full) << " File:" << path;
+      }
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot map " << path << " Error:" << error;
+    }
+    _file = file;
+    _mapping = mapping;
+    _data = static_cast<uint8_t*>(data);
+    _size = static_cast<size_t>(mapped_size);
+    return error_code::success;
+  }
+
+  void mapped_file::close() {
+    if (_data != nullptr) UnmapViewOfFile(_data);
+    if (_mapping != nullptr) CloseHandle(_mapping);
+    if (_file != nullptr) CloseHandle(_file);
+    _data = nullptr;
+    _mapping = nullptr;
+    _file = nullptr;
+    _size = 0;
+  }
+
+  int make_directory(const std::string& directory, api_status* status) {
+    if (_mkdir(directory.c_str()) != 0 && errno != EEXIST) {
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot create " << directory << " Error:" << std::strerror(errno);
+    }
+    return error_code::success;
+  }
+
+  int list_files(const std::string& directory, const std::string& prefix, std::vector<std::string>& names, api_status* status) {
+    WIN32_FIND_DATAA entry;
+    const auto pattern = directory + "\\" + prefix + "*";
+    HANDLE find = FindFirstFileA(pattern.c_str(), &entry);
+    if (find == INVALID_HANDLE_VALUE) {
+      if (GetLastError() == ERROR_FILE_NOT_FOUND) return error_code::success;
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot list " << directory << " Error:" << GetLastError();
+    }
+    do {
+      if ((entry.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+        names.emplace_back(entry.cFileName);
+      }
+    } while (FindNextFileA(find, &entry));
+    FindClose(find);
+    return error_code::success;
+  }
+#else
+  namespace {
+    // allocates the blocks of [offset, offset + length) so that writes through the mapping can't fault on a full
+    // disk, returns 0 or an errno value
+    int reserve_blocks(int fd, off_t offset, off_t length) {
+#ifdef __linux__
+      const int error = posix_fallocate(fd, offset, length);
+      if (error != EINVAL && error != EOPNOTSUPP) {
+        return error;
+      }
+#endif
+      // the file system can't preallocate, write the zeros instead
+      static const char zeros[64 * 1024] = {};
+      while (length > 0) {
+        const ssize_t written = pwrite(fd, zeros, static_cast<size_t>((std::min)(length, static_cast<off_t>(sizeof(zeros)))), offset);
+        if (written < 0) {
+          if (errno == EINTR) continue;
+          return errno;
+        }
+        offset += written;
+        length -= written;
+      }
+      return 0;
+    }
+
+    bool is_disk_full(int error) {
+      return error == ENOSPC || error == EDQUOT;
+    }
+  }
+
+  int mapped_file::open(const std::string& path, size_t size, api_status* status) {
+    close();
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+      const int error = errno;
+      if (is_disk_full(error)) {
+        RETURN_ERROR_LS(nullptr, status, spool_full) << " File:" << path;
+      }
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot open " << path << " Error:" << std::strerror(error);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      const int error = errno;
+      ::close(fd);
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot stat " << path << " Error:" << std::strerror(error);
+    }
+    size_t mapped_size = static_cast<size_t>(st.st_size);
+    if (mapped_size < size) {
+      int error = ftruncate(fd, static_cast<off_t>(size)) != 0 ? errno : 0;
+      if (error == 0) {
+        error = reserve_blocks(fd, st.st_size, static_cast<off_t>(size) - st.st_size);
+      }
+      if (error != 0) {
+        ::close(fd);
+        if (is_disk_full(error)) {
+          RETURN_ERROR_LS(nullptr, status, spool_full) << " File:" << path;
+        }
+        RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot grow " << path << " Error:" << std::strerror(error);
+      }
+      mapped_size = size;
+    }
+    if (mapped_size == 0) {
+      ::close(fd);
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "empty segment " << path;
+    }
+    void* data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+      const int error = errno;
+      ::close(fd);
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot map " << path << " Error:" << std::strerror(error);
+    }
+    _fd = fd;
+    _data = static_cast<uint8_t*>(data);
+    _size = mapped_size;
+    return error_code::success;
+  }
+
+  void mapped_file::close() {
+    if (_data != nullptr) munmap(_data, _size);
+    if (_fd >= 0) ::close(_fd);
+    _data = nullptr;
+    _fd = -1;
+    _size = 0;
+  }
+
+  int make_directory(const std::string& directory, api_status* status) {
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST) {
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot create " << directory << " Error:" << std::strerror(errno);
+    }
+    return error_code::success;
+  }
+
+  int list_files(const std::string& directory, const std::string& prefix, std::vector<std::string>& names, api_status* status) {
+    DIR* dir = opendir(directory.c_str());
+    if (dir == nullptr) {
+      RETURN_ERROR_LS(nullptr, status, spool_error) << "cannot list " << directory << " Error:" << std::strerror(errno);
+    }
+    while (const dirent* entry = readdir(dir)) {
+      const std::string name(entry->d_name);
+      if (name.compare(0, prefix.size(), prefix) == 0) {
+        names.push_back(name);
+      }
+    }
+    closedir(dir);
+    return error_code::success;
+  }
+#endif
+
+  bool remove_file(const std::string& path) {
+    return std::remove(path.c_str()) == 0;
+  }
+}}}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace reinforcement_learning {
+  class api_status;
+}
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  // A file mapped read/write in memory. Writes to the mapping land in the page cache right away, so they survive
+  // the process, the operating system writes them back to disk on its own schedule.
+  class mapped_file {
+  public:
+    mapped_file() = default;
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    // opens path, creating it when it does not exist, and grows it with zeros to at least size bytes (0 keeps the
+    // size of an existing file). The blocks are allocated up front, a full disk fails with spool_full.
+    int open(const std::string& path, size_t size, api_status* status);
+    void close();
+
+    uint8_t* data() const { return _data; }
+    size_t size() const { return _size; }
+
+  private:
+#ifdef _WIN32
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#else
+    int _fd = -1;
+#endif
+    uint8_t* _data = nullptr;
+    size_t _size = 0;
+  };
+
+  // creates directory when it does not exist (not its parents)
+  int make_directory(const std::string& directory, api_status* status);
+  // names of the files of directory starting with prefix
+  int list_files(const std::string& directory, const std::string& prefix, std::vector<std::string>& names, api_status* status);
+  bool remove_file(const std::string& path);
+}}}
@@ -0,0 +1,228 @@
+#include "segment_spool.h"
+#include "api_status.h"
+#include "err_constants.h"
+#include "trace_logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  namespace {
+    const char SEGMENT_MAGIC[8] = { 'R', 'L', 'S', 'P', 'O', 'O', 'L', '1' };
+    const size_t SEGMENT_HEADER_SIZE = sizeof(SEGMENT_MAGIC);
+    const char* const SEGMENT_SUFFIX = ".spool";
+
+    // states of a record, the zeros of a new segment read as the end of the records
+    const uint32_t RECORD_EMPTY = 0;
+    const uint32_t RECORD_PENDING = 1;
+    const uint32_t RECORD_REPLAYED = 2;
+
+    struct record_header {
+      uint32_t size;
+      uint32_t state;
+    };
+
+    // records start on 8 bytes boundaries
+    size_t record_span(size_t size) {
+      return (sizeof(record_header) + size + 7) & ~static_cast<size_t>(7);
+    }
+
+    record_header* header_at(uint8_t* base, size_t offset) {
+      return reinterpret_cast<record_header*>(base + offset);
+    }
+  }
+
+  segment_spool::segment_spool(std::string directory, std::string prefix, size_t segment_size, size_t max_bytes, i_trace* trace)
+    : _directory(std::move(directory))
+    , _prefix(std::move(prefix))
+    , _segment_size((std::max)(segment_size, SEGMENT_HEADER_SIZE + record_span(0)))
+    , _max_bytes(max_bytes)
+    , _trace(trace) {}
+
+  std::string segment_spool::segment_path(uint64_t sequence) const {
+    std::ostringstream path;
+    path << _directory << "/" << _prefix << "." << sequence << SEGMENT_SUFFIX;
+    return path.str();
+  }
+
+  int segment_spool::open_segment(uint64_t sequence, size_t size, bool create, std::unique_ptr<segment>& seg, api_status* status) {
+    seg.reset(new segment());
+    seg->sequence = sequence;
+    seg->path = segment_path(sequence);
+    RETURN_IF_FAIL(seg->file.open(seg->path, create ? size : 0, status));
+    uint8_t* base = seg->file.data();
+    if (create) {
+      std::memcpy(base, SEGMENT_MAGIC, SEGMENT_HEADER_SIZE);
+    }
+    else if (seg->file.size() < SEGMENT_HEADER_SIZE || std::memcmp(base, SEGMENT_MAGIC, SEGMENT_HEADER_SIZE) != 0) {
+      RETURN_ERROR_LS(nullptr, status, spool_error) << seg->path << " is not a spool segment";
+    }
+
+    // the records end at the first empty or truncated one
+    size_t offset = SEGMENT_HEADER_SIZE;
+    seg->read_offset = 0;
+    seg->pending_records = 0;
+    while (offset + sizeof(record_header) <= seg->file.size()) {
+      const record_header* header = header_at(base, offset);
+      if (header->state == RECORD_EMPTY || offset + record_span(header->size) > seg->file.size()) {
+        break;
+      }
+      if (header->state == RECORD_PENDING) {
+        if (seg->pending_records++ == 0) {
+          seg->read_offset = offset;
+        }
+        ++_pending_records;
+        _pending_bytes += header->size;
+      }
+      offset += record_span(header->size);
+    }
+    seg->write_offset = offset;
+    if (seg->pending_records == 0) {
+      seg->read_offset = offset;
+    }
+    return error_code::success;
+  }
+
+  int segment_spool::init(api_status* status) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    RETURN_IF_FAIL(make_directory(_directory, status));
+    std::vector<std::string> names;
+    RETURN_IF_FAIL(list_files(_directory, _prefix + ".", names, status));
+
+    std::vector<uint64_t> sequences;
+    const std::string suffix(SEGMENT_SUFFIX);
+    for (const auto& name : names) {
+      // <prefix>.<sequence>.spool
+      const auto first = _prefix.size() + 1;
+      if (name.size() <= first + suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        continue;
+      }
+      const auto digits = name.substr(first, name.size() - suffix.size() - first);
+      if (digits.find_first_not_of("0123456789") != std::string::npos) {
+        continue;
+      }
+      sequences.push_back(std::strtoull(digits.c_str(), nullptr, 10));
+    }
+    std::sort(sequences.begin(), sequences.end());
+    if (!sequences.empty()) {
+      _next_sequence = sequences.back() + 1;
+    }
+
+    for (const auto sequence : sequences) {
+      std::unique_ptr<segment> seg;
+      api_status segment_status;
+      if (open_segment(sequence, 0, false, seg, &segment_status) != error_code::success) {
+        // leave it on disk for someone to look at
+        TRACE_WARN(_trace, segment_status.get_error_msg());
+        continue;
+      }
+      _disk_bytes += seg->file.size();
+      _segments.push_back(std::move(seg));
+    }
+    remove_replayed_segments();
+    if (!_segments.empty() && _segments.back()->pending_records == 0) {
+      // nothing left to replay, the next append starts a new segment
+      const auto path = _segments.back()->path;
+      _disk_bytes -= _segments.back()->file.size();
+      _segments.pop_back();
+      remove_file(path);
+    }
+    return error_code::success;
+  }
+
+  int segment_spool::append(const uint8_t* data, size_t size, api_status* status) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const size_t span = record_span(size);
+    if (_segments.empty() || _segments.back()->write_offset + span > _segments.back()->file.size()) {
+      const size_t segment_size = (std::max)(_segment_size, SEGMENT_HEADER_SIZE + span);
+      if (_disk_bytes + segment_size > _max_bytes) {
+        RETURN_ERROR_LS(_trace, status, spool_full) << " Spool:" << _directory << "/" << _prefix;
+      }
+      std::unique_ptr<segment> seg;
+      const int result = open_segment(_next_sequence, segment_size, true, seg, status);
+      if (result != error_code::success) {
+        // don't leave a partly allocated segment behind
+        seg.reset();
+        remove_file(segment_path(_next_sequence));
+        return result;
+      }
+      ++_next_sequence;
+      _disk_bytes += seg->file.size();
+      _segments.push_back(std::move(seg));
+      remove_replayed_segments();
+    }
+
+    segment& tail = *_segments.back();
+    uint8_t* base = tail.file.data();
+    record_header* header = header_at(base, tail.write_offset);
+    std::memcpy(base + tail.write_offset + sizeof(record_header), data, size);
+    header->size = static_cast<uint32_t>(size);
+    // the state goes last: a record cut short by a crash still reads as empty
+    header->state = RECORD_PENDING;
+    if (tail.pending_records++ == 0) {
+      tail.read_offset = tail.write_offset;
+    }
+    tail.write_offset += span;
+    ++_pending_records;
+    _pending_bytes += size;
+    return error_code::success;
+  }
+
+  bool segment_spool::front(const uint8_t*& data, size_t& size) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& seg : _segments) {
+      if (seg->pending_records > 0) {
+        const record_header* header = header_at(seg->file.data(), seg->read_offset);
+        data = seg->file.data() + seg->read_offset + sizeof(record_header);
+        size = header->size;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void segment_spool::pop_front() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& seg : _segments) {
+      if (seg->pending_records > 0) {
+        record_header* header = header_at(seg->file.data(), seg->read_offset);
+        header->state = RECORD_REPLAYED;
+        --_pending_records;
+        _pending_bytes -= header->size;
+        seg->read_offset += record_span(header->size);
+        --seg->pending_records;
+        break;
+      }
+    }
+    remove_replayed_segments();
+  }
+
+  void segment_spool::remove_replayed_segments() {
+    while (_segments.size() > 1 && _segments.front()->pending_records == 0) {
+      const auto path = _segments.front()->path;
+      _disk_bytes -= _segments.front()->file.size();
+      // unmapped before it is removed
+      _segments.pop_front();
+      if (!remove_file(path)) {
+        TRACE_WARN(_trace, "Unable to remove the replayed spool segment " + path);
+      }
+    }
+  }
+
+  bool segment_spool::empty() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending_records == 0;
+  }
+
+  size_t segment_spool::pending_bytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _pending_bytes;
+  }
+
+  size_t segment_spool::disk_bytes() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _disk_bytes;
+  }
+}}}
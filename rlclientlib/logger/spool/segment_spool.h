@@ -0,0 +1,72 @@
+#pragma once
+
+#include "mapped_file.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace reinforcement_learning {
+  class api_status;
+  class i_trace;
+}
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  // Append only store of records in memory mapped segment files <directory>/<prefix>.<sequence>.spool.
+  // Records are replayed in the order they were appended and marked as replayed in place, so that a new process
+  // resumes where the previous one stopped. A segment file is deleted once all its records are replayed.
+  // append can be called from any thread, front and pop_front from a single replay thread.
+  class segment_spool {
+  public:
+    // segment_size and max_bytes are in bytes, a record bigger than segment_size gets a segment of its own
+    segment_spool(std::string directory, std::string prefix, size_t segment_size, size_t max_bytes, i_trace* trace);
+
+    segment_spool(const segment_spool&) = delete;
+    segment_spool& operator=(const segment_spool&) = delete;
+
+    // picks up the segments left by a previous process
+    int init(api_status* status);
+
+    // fails with spool_full when a new segment would go over max_bytes
+    int append(const uint8_t* data, size_t size, api_status* status);
+
+    // oldest record not replayed yet, the pointer stays valid until pop_front, returns false when there is none
+    bool front(const uint8_t*& data, size_t& size);
+    void pop_front();
+
+    bool empty() const;
+    size_t pending_bytes() const;    // size of the records not replayed yet
+    size_t disk_bytes() const;       // size of the segment files
+
+  private:
+    struct segment {
+      uint64_t sequence;
+      std::string path;
+      mapped_file file;
+      size_t read_offset;     // first record not replayed
+      size_t write_offset;    // end of the records
+      size_t pending_records;
+    };
+
+    int open_segment(uint64_t sequence, size_t size, bool create, std::unique_ptr<segment>& seg, api_status* status);
+    std::string segment_path(uint64_t sequence) const;
+    // deletes the replayed segments at the front, never the one being written
+    void remove_replayed_segments();
+
+    const std::string _directory;
+    const std::string _prefix;
+    const size_t _segment_size;
+    const size_t _max_bytes;
+    i_trace* _trace;
+
+    mutable std::mutex _mutex;
+    std::deque<std::unique_ptr<segment>> _segments;    // the last one is being written
+    uint64_t _next_sequence = 0;
+    size_t _pending_records = 0;
+    size_t _pending_bytes = 0;
+    size_t _disk_bytes = 0;
+  };
+}}}
@@ -0,0 +1,169 @@
+#include "spool_sender.h"
+#include "api_status.h"
+#include "data_buffer.h"
+#include "err_constants.h"
+#include "error_callback_fn.h"
+#include "logger/preamble.h"
+#include "trace_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  namespace {
+    // how often the sender thread goes back to the spool when the replay rate or a backoff holds it
+    const std::chrono::milliseconds REPLAY_TICK(10);
+    const std::chrono::milliseconds MIN_REPLAY_BACKOFF(100);
+    const std::chrono::milliseconds MAX_REPLAY_BACKOFF(30000);
+  }
+
+  spool_sender::spool_sender(i_sender* sender, const utility::spool_config& config, const std::string& prefix,
+    i_trace* trace, error_callback_fn* perror_cb)
+    : _sender(sender)
+    , _spool(config.directory, prefix, config.segment_size, config.max_disk_bytes, trace)
+    , _send_deadline(std::chrono::milliseconds(config.send_deadline_ms))
+    , _max_pending(static_cast<size_t>((std::max)(config.max_pending_batches, 0)))
+    , _replay_bytes_per_sec(config.replay_bytes_per_sec)
+    , _trace(trace)
+    , _perror_cb(perror_cb)
+    , _replay_backoff(MIN_REPLAY_BACKOFF) {}
+
+  spool_sender::~spool_sender() {
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (!_running) return;
+      _running = false;
+    }
+    // the thread sends what is pending before it exits, the spool is left for the next process
+    _cv.notify_all();
+    _thread.join();
+  }
+
+  int spool_sender::init(const utility::configuration& config, api_status* status) {
+    RETURN_IF_FAIL(_spool.init(status));
+    if (!_spool.empty()) {
+      TRACE_INFO(_trace, "Replaying " + std::to_string(_spool.pending_bytes()) + " bytes left in the spool");
+    }
+    _replay_refill = clock::now();
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    try {
+      _running = true;
+      _thread = std::thread(&spool_sender::run, this);
+    }
+    catch (const std::exception& e) {
+      _running = false;
+      RETURN_ERROR_LS(_trace, status, background_thread_start) << " (spool sender)" << e.what();
+    }
+    return error_code::success;
+  }
+
+  int spool_sender::v_send(const buffer& data, api_status* status) {
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      if (_running && _pending.size() < _max_pending) {
+        _pending.push_back({ data, clock::now() });
+        lock.unlock();
+        _cv.notify_one();
+        return error_code::success;
+      }
+    }
+    // the sender thread is behind, keep the batch on disk rather than waiting for it
+    RETURN_IF_FAIL(spill(data, status));
+    {
+      // so that the sender thread can't miss the notification between its check of the spool and its wait
+      std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _cv.notify_one();
+    return error_code::success;
+  }
+
+  int spool_sender::spill(const buffer& data, api_status* status) {
+    return _spool.append(data->preamble_begin(), data->buffer_filled_size(), status);
+  }
+
+  void spool_sender::run() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (;;) {
+      if (!_pending.empty()) {
+        auto batch = std::move(_pending.front());
+        _pending.pop_front();
+        lock.unlock();
+        send_pending(batch);
+        lock.lock();
+        continue;
+      }
+      if (!_running) break;
+
+      // the spooled batches only go when nothing newer is waiting
+      lock.unlock();
+      const bool replayed = replay_one();
+      lock.lock();
+      if (!replayed) {
+        const auto has_batches = [this] { return !_pending.empty() || !_running; };
+        if (_spool.empty()) {
+          _cv.wait(lock, [this, &has_batches] { return has_batches() || !_spool.empty(); });
+        }
+        else {
+          _cv.wait_for(lock, REPLAY_TICK, has_batches);
+        }
+      }
+    }
+  }
+
+  void spool_sender::send_pending(pending_batch& batch) {
+    if (clock::now() - batch.queued <= _send_deadline) {
+      api_status status;
+      if (_sender->send(batch.data, &status) == error_code::success) {
+        return;
+      }
+      ERROR_CALLBACK(_perror_cb, status);
+    }
+    // too late or failed, the batch is replayed later
+    api_status status;
+    if (spill(batch.data, &status) != error_code::success) {
+      ERROR_CALLBACK(_perror_cb, status);
+    }
+  }
+
+  bool spool_sender::replay_one() {
+    const auto now = clock::now();
+    if (now < _replay_not_before) return false;
+
+    const uint8_t* data;
+    size_t size;
+    if (!_spool.front(data, size)) return false;
+
+    if (_replay_bytes_per_sec > 0) {
+      // token bucket holding up to a second of replay
+      const double elapsed = std::chrono::duration<double>(now - _replay_refill).count();
+      _replay_allowance = (std::min)(_replay_allowance + elapsed * _replay_bytes_per_sec, static_cast<double>(_replay_bytes_per_sec));
+      _replay_refill = now;
+      if (_replay_allowance <= 0.) return false;
+      _replay_allowance -= static_cast<double>(size);
+    }
+
+    const size_t preamble_size = preamble::size();
+    if (size <= preamble_size) {
+      TRACE_WARN(_trace, "Skipping a spooled batch without body");
+      _spool.pop_front();
+      return true;
+    }
+    auto db = std::make_shared<utility::data_buffer>(size - preamble_size);
+    std::memcpy(db->raw_begin(), data, size);
+    db->set_body_endoffset(size);
+
+    api_status status;
+    if (_sender->send(db, &status) != error_code::success) {
+      // the sender is still down, the same batch is tried again later
+      TRACE_WARN(_trace, "Spool replay failed: " + std::string(status.get_error_msg()));
+      _replay_not_before = now + _replay_backoff;
+      _replay_backoff = (std::min)(_replay_backoff * 2, std::chrono::duration_cast<clock::duration>(MAX_REPLAY_BACKOFF));
+      return false;
+    }
+    _replay_backoff = MIN_REPLAY_BACKOFF;
+    _spool.pop_front();
+    return true;
+  }
+}}}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "segment_spool.h"
+#include "sender.h"
+#include "utility/config_helper.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace reinforcement_learning {
+  class error_callback_fn;
+  class i_trace;
+}
+
+namespace reinforcement_learning { namespace logger { namespace spool {
+  // Sends through the wrapped sender from a thread of its own, so that a slow sender doesn't hold the batcher.
+  // A batch (preamble included) that can't be sent in time, because the pending batches are full, it waited more than
+  // send_deadline_ms or the send failed, goes to a segment_spool on local disk instead. The spooled batches are
+  // replayed through the wrapped sender whenever no newer batch is waiting, at most replay_bytes_per_sec.
+  // Batches still spooled at shutdown are replayed by the next process using the same directory.
+  class spool_sender : public i_sender {
+  public:
+    // takes ownership of sender, which is already initialized. The segment files are named after prefix.
+    spool_sender(i_sender* sender, const utility::spool_config& config, const std::string& prefix, i_trace* trace,
+      error_callback_fn* perror_cb);
+    ~spool_sender();
+
+    spool_sender(const spool_sender&) = delete;
+    spool_sender& operator=(const spool_sender&) = delete;
+
+    int init(const utility::configuration& config, api_status* status) override;
+
+  protected:
+    int v_send(const buffer& data, api_status* status) override;
+
+  private:
+    using clock = std::chrono::steady_clock;
+
+    struct pending_batch {
+      buffer data;
+      clock::time_point queued;
+    };
+
+    void run();
+    void send_pending(pending_batch& batch);
+    // replays the oldest spooled batch when the rate allows it, returns false when it has to wait
+    bool replay_one();
+    int spill(const buffer& data, api_status* status);
+
+    std::unique_ptr<i_sender> _sender;
+    segment_spool _spool;
+    const clock::duration _send_deadline;
+    const size_t _max_pending;
+    const size_t _replay_bytes_per_sec;
+    i_trace* _trace;
+    error_callback_fn* _perror_cb;
+
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::deque<pending_batch> _pending;
+    bool _running = false;
+    std::thread _thread;
+
+    // replay state, only used by the sender thread
+    double _replay_allowance = 0.;    // bytes the replay can send right now
+    clock::time_point _replay_refill;
+    clock::time_point _replay_not_before;
+    clock::duration _replay_backoff;
+  };
+}}}
@@ -8,13 +8,14 @@
 namespace e = exploration;
 namespace reinforcement_learning {
 
-int populate_response(size_t chosen_action_index, std::vector<int>& action_ids, std::vector<float>& pdf, std::string&& model_id, ranking_response& response, i_trace* trace_logger, api_status* status) {
+int populate_response(size_t chosen_action_index, std::vector<int>& action_ids, std::vector<float>& pdf, const std::string& model_id, ranking_response& response, i_trace* trace_logger, api_status* status) {
   for ( size_t idx = 0; idx < pdf.size(); ++idx ) {
     response.push_back(action_ids[idx], pdf[idx]);
   }
 
   RETURN_IF_FAIL(response.set_chosen_action_id(action_ids[chosen_action_index]));
-  response.set_model_id(std::move(model_id));
+  // copied into the existing capacity so that a reused response does not allocate
+  response.set_model_id(model_id.c_str());
   return error_code::success;
 }
 
@@ -105,7 +106,7 @@ int populate_multi_slot_response_detailed(const std::vector<std::vector<uint32_t
   return error_code::success;
 }
 
-int sample_and_populate_response(uint64_t rnd_seed, std::vector<int>& action_ids, std::vector<float>& pdf, std::string&& model_id, ranking_response& response, i_trace* trace_logger, api_status* status) {
+int sample_and_populate_response(uint64_t rnd_seed, std::vector<int>& action_ids, std::vector<float>& pdf, const std::string& model_id, ranking_response& response, i_trace* trace_logger, api_status* status) {
     try {
       // Pick a slot using the pdf. NOTE: sample_after_normalizing() can change the pdf
       uint32_t chosen_index;
@@ -115,7 +116,7 @@ int sample_and_populate_response(uint64_t rnd_seed, std::vector<int>& action_ids
         RETURN_ERROR_LS(trace_logger, status, exploration_error) << scode;
       }
 
-      RETURN_IF_FAIL(populate_response(chosen_index, action_ids, pdf, std::move(model_id), response, trace_logger, status));
+      RETURN_IF_FAIL(populate_response(chosen_index, action_ids, pdf, model_id, response, trace_logger, status));
 
       // Swap values in first position with values in chosen index
       scode = e::swap_chosen(std::begin(response), std::end(response), chosen_index);
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include <flatbuffers/flatbuffers.h>
+#include "logger/batch_compressor.h"
+#include "logger/compression_level_controller.h"
 #include "logger/flatbuffer_allocator.h"
 #include "generated/v1/OutcomeEvent_generated.h"
 #include "generated/v1/RankingEvent_generated.h"
@@ -14,6 +16,7 @@
 
 #include "logger/message_type.h"
 #include "utility/config_helper.h"
+#include "constants.h"
 #include "err_constants.h"
 
 using namespace reinforcement_learning::messages::flatbuff;
@@ -224,6 +227,15 @@ namespace reinforcement_learning { namespace logger {
 
     fb_collection_serializer(buffer_t& buffer, const char* content_encoding, int /*dummy*/) : fb_collection_serializer(buffer, content_encoding) {}
 
+    // the batch is compressed with compressor (when not null) if the event type supports it, the level and ratio of
+    // level_controller (when not null) are recorded in the batch metadata
+    fb_collection_serializer(buffer_t& buffer, const char* content_encoding, int /*dummy*/, batch_compressor* compressor,
+      const compression_level_controller* level_controller = nullptr)
+      : fb_collection_serializer(buffer, content_encoding) {
+      _compressor = compressor;
+      _level_controller = level_controller;
+    }
+
     int add(event_t& evt, api_status* status = nullptr) {
       flatbuffers::Offset<typename serializer_t::fb_event_t> offset;
       RETURN_IF_FAIL(serializer_t::serialize(evt, _builder, offset, status));
@@ -248,6 +260,11 @@ namespace reinforcement_learning { namespace logger {
       return;
     }
 
+    //replaces the finished batch by its compressed form
+    int compress_batch(api_status* status) {
+      return error_code::success;
+    }
+
     int finalize(api_status* status) {
       auto event_offsets = _builder.CreateVector(_event_offsets);
       create_header();
@@ -256,6 +273,9 @@ namespace reinforcement_learning { namespace logger {
       add_header(batch_builder);
       auto batch_offset = batch_builder.Finish();
       _builder.Finish(batch_offset);
+      if (_compressor != nullptr) {
+        RETURN_IF_FAIL(compress_batch(status));
+      }
       // Where does the body of the data begin in relation to the start
       // of the raw buffer
       const auto offset = _builder.GetBufferPointer() - _buffer.raw_begin();
@@ -271,6 +291,8 @@ namespace reinforcement_learning { namespace logger {
     buffer_t& _buffer;
     const char* _content_encoding;
     flatbuffers::Offset<v2::BatchMetadata> _batch_metadata_offset;
+    batch_compressor* _compressor = nullptr;
+    const compression_level_controller* _level_controller = nullptr;
   };
 
   template <>
@@ -283,10 +305,15 @@ namespace reinforcement_learning { namespace logger {
       return evt.get_payload().size();
     }
 
-    static int serialize(generic_event& evt, flatbuffers::FlatBufferBuilder& outter_builder,
+    // The Event is a flatbuffer nested in the byte vector of the SerializedEvent. Instead of building it in a
+    // temporary builder and copying it, it is built in place in the batch builder: aligned like the start of a
+    // standalone buffer and finished like one, its bytes are then turned into the vector by prefixing their length.
+    static int serialize(generic_event& evt, flatbuffers::FlatBufferBuilder& builder,
       flatbuffers::Offset<fb_event_t>& ret_val, api_status* status) {
-
-      flatbuffers::FlatBufferBuilder builder;
+      builder.Align(sizeof(flatbuffers::largest_scalar_t));
+      const auto event_end = builder.GetSize();
+      // the nested tables can't point to vtables outside of the nested buffer
+      builder.DedupVtables(false);
 
       const auto& ts = evt.get_client_time_gmt();
       v2::TimeStamp client_ts(ts.year, ts.month, ts.day, ts.hour,
@@ -298,15 +325,22 @@ namespace reinforcement_learning { namespace logger {
         evt.get_app_id(),
         evt.get_payload_type(), 
         evt.get_pass_prob(),
-        evt.get_encoding());
+        evt.get_encoding(),
+        evt.get_dictionary_id());
 
       const auto& buffer = evt.get_payload();
       const auto payload_offset = builder.CreateVector(buffer.data(), buffer.size());
-      builder.Finish(v2::CreateEvent(builder, meta_offset, payload_offset));
+      const auto event_offset = v2::CreateEvent(builder, meta_offset, payload_offset);
+
+      // same as FlatBufferBuilder::Finish
+      builder.PreAlign(sizeof(flatbuffers::uoffset_t), sizeof(flatbuffers::largest_scalar_t));
+      builder.PushElement(builder.ReferTo(event_offset.o));
+      builder.DedupVtables(true);
 
-      auto event_buff = builder.Release();
-      const auto evt_offset = outter_builder.CreateVector(event_buff.data(), event_buff.size());
-      ret_val = v2::CreateSerializedEvent(outter_builder, evt_offset);
+      // the size is aligned, so the length is pushed right in front of the event bytes
+      const auto event_size = static_cast<flatbuffers::uoffset_t>(builder.GetSize() - event_end);
+      const flatbuffers::Offset<flatbuffers::Vector<uint8_t>> evt_offset(builder.PushElement(event_size));
+      ret_val = v2::CreateSerializedEvent(builder, evt_offset);
 
       return error_code::success;
     }
@@ -329,7 +363,9 @@ namespace reinforcement_learning { namespace logger {
 
   template <>
   inline void fb_collection_serializer<generic_event>::create_header() {
-    _batch_metadata_offset = v2::CreateBatchMetadataDirect(_builder, _content_encoding);
+    _batch_metadata_offset = _level_controller == nullptr
+      ? v2::CreateBatchMetadataDirect(_builder, _content_encoding)
+      : v2::CreateBatchMetadataDirect(_builder, _content_encoding, nullptr, _level_controller->level(), _level_controller->ratio());
     return;
   }
 
@@ -337,4 +373,23 @@ namespace reinforcement_learning { namespace logger {
   inline void fb_collection_serializer<generic_event>::add_header(typename serializer_t::batch_builder_t& batch_builder) {
     batch_builder.add_metadata(_batch_metadata_offset);
   }
+
+  // The whole EventBatch becomes a single zstd frame, wrapped in an EventBatch that only holds the metadata and
+  // the frame. The builder is reused, its storage is the data buffer of the batch.
+  template <>
+  inline int fb_collection_serializer<generic_event>::compress_batch(api_status* status) {
+    RETURN_IF_FAIL(_compressor->compress(_builder.GetBufferPointer(), _builder.GetSize(), status));
+
+    _builder.Clear();
+    const auto& compressed = _compressor->output();
+    const auto compressed_offset = _builder.CreateVector(compressed.data(), compressed.size());
+    const auto metadata_offset = _level_controller == nullptr
+      ? v2::CreateBatchMetadataDirect(_builder, _content_encoding, value::BATCH_COMPRESSION_ZSTD)
+      : v2::CreateBatchMetadataDirect(_builder, _content_encoding, value::BATCH_COMPRESSION_ZSTD, _level_controller->level(), _level_controller->ratio());
+    v2::EventBatchBuilder batch_builder(_builder);
+    batch_builder.add_metadata(metadata_offset);
+    batch_builder.add_compressed_batch(compressed_offset);
+    _builder.Finish(batch_builder.Finish());
+    return error_code::success;
+  }
 }}
@@ -4,6 +4,8 @@
 
 #include "ranking_event.h"
 #include "data_buffer.h"
+#include "logger/batch_compressor.h"
+#include "logger/compression_level_controller.h"
 #include "logger/message_type.h"
 #include "api_status.h"
 #include "utility/data_buffer_streambuf.h"
@@ -97,6 +99,9 @@ namespace reinforcement_learning { namespace logger {
     }
 
     json_collection_serializer(buffer_t& buffer, const char* content_encoding, int /*dummy*/) : json_collection_serializer(buffer, content_encoding) {}
+    // json batches are never compressed
+    json_collection_serializer(buffer_t& buffer, const char* content_encoding, int /*dummy*/, batch_compressor* /*compressor*/,
+      const compression_level_controller* /*level_controller*/ = nullptr) : json_collection_serializer(buffer, content_encoding) {}
 
     int add(event_t& evt, api_status* status=nullptr) {
       RETURN_IF_FAIL(serializer_t::serialize(evt, _ostream, status));
@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <vector>
 
 #include <flatbuffers/flatbuffers.h>
@@ -12,6 +13,7 @@
 #include "continuous_action_response.h"
 #include "data_buffer.h"
 #include "logger/message_type.h"
+#include "logger/flatbuffer_allocator.h"
 #include "api_status.h"
 #include "utility/data_buffer_streambuf.h"
 #include "learning_mode.h"
@@ -35,20 +37,33 @@ namespace reinforcement_learning {
       const generic_event::payload_type_t type = pt;
     };
 
+    // Cleared builder owned by the calling thread. Its blocks come from the pooled allocator, so the released
+    // payloads are recycled once the batcher is done with them and a warmed up thread does not allocate.
+    inline flatbuffers::FlatBufferBuilder& get_thread_builder() {
+      static thread_local flatbuffers::FlatBufferBuilder fbb(1024, &pooled_flatbuffer_allocator::get_instance());
+      fbb.Clear();
+      return fbb;
+    }
+
     struct cb_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_CB> {
       static generic_event::payload_buffer_t event(const char* context, unsigned int flags, v2::LearningModeType learning_mode, const ranking_response& response) {
-        flatbuffers::FlatBufferBuilder fbb;
-        std::vector<uint64_t> action_ids;
-        std::vector<float> probabilities;
+        auto& fbb = get_thread_builder();
+
+        // vectors are written straight into the builder, in the same order as CreateCbEventDirect
+        uint64_t* action_ids_ptr;
+        const auto action_ids = fbb.CreateUninitializedVector(response.size(), &action_ids_ptr);
+        for (auto const& r : response) {
+          *action_ids_ptr++ = r.action_id + 1;
+        }
+        const auto context_vec = fbb.CreateVector(reinterpret_cast<const uint8_t*>(context), strlen(context));
+        float* probabilities_ptr;
+        const auto probabilities = fbb.CreateUninitializedVector(response.size(), &probabilities_ptr);
         for (auto const& r : response) {
-          action_ids.push_back(r.action_id + 1);
-          probabilities.push_back(r.probability);
+          *probabilities_ptr++ = r.probability;
         }
-        std::vector<unsigned char> _context;
-        std::string context_str(context);
-        copy(context_str.begin(), context_str.end(), std::back_inserter(_context));
+        const auto model_id = fbb.CreateString(response.get_model_id());
 
-        auto fb = v2::CreateCbEventDirect(fbb, flags & action_flags::DEFERRED, &action_ids, &_context, &probabilities, response.get_model_id(), learning_mode);
+        auto fb = v2::CreateCbEvent(fbb, flags & action_flags::DEFERRED, action_ids, context_vec, probabilities, model_id, learning_mode);
         fbb.Finish(fb);
         return fbb.Release();
       }
@@ -56,13 +71,12 @@ namespace reinforcement_learning {
 
     struct ca_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_CA> {
       static generic_event::payload_buffer_t event(const char* context, unsigned int flags, const continuous_action_response& response) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
 
-        std::vector<unsigned char> _context;
-        std::string context_str(context);
-        copy(context_str.begin(), context_str.end(), std::back_inserter(_context));
+        const auto context_vec = fbb.CreateVector(reinterpret_cast<const uint8_t*>(context), strlen(context));
+        const auto model_id = fbb.CreateString(response.get_model_id());
 
-        auto fb = v2::CreateCaEventDirect(fbb, flags & action_flags::DEFERRED, response.get_chosen_action(), &_context, response.get_chosen_action_pdf_value(), response.get_model_id());
+        auto fb = v2::CreateCaEvent(fbb, flags & action_flags::DEFERRED, response.get_chosen_action(), context_vec, response.get_chosen_action_pdf_value(), model_id);
         fbb.Finish(fb);
         return fbb.Release();
       }
@@ -72,18 +86,23 @@ namespace reinforcement_learning {
       static generic_event::payload_buffer_t event(const char* context, unsigned int flags, const std::vector<std::vector<uint32_t>>& action_ids,
         const std::vector<std::vector<float>>& pdfs, const std::string& model_version, const std::vector<std::string>& slot_ids,
         const std::vector<int>& baseline_actions, v2::LearningModeType learning_mode) {
-        flatbuffers::FlatBufferBuilder fbb;
-        std::vector<flatbuffers::Offset<v2::SlotEvent>> slots;
+        auto& fbb = get_thread_builder();
+        static thread_local std::vector<flatbuffers::Offset<v2::SlotEvent>> slots;
+        slots.clear();
         for (size_t i = 0; i < action_ids.size(); i++)
         {
-          slots.push_back(v2::CreateSlotEventDirect(fbb, &action_ids[i], &pdfs[i], slot_ids[i].c_str()));
+          const auto slot_action_ids = fbb.CreateVector(action_ids[i]);
+          const auto slot_pdf = fbb.CreateVector(pdfs[i]);
+          const auto slot_id = fbb.CreateString(slot_ids[i]);
+          slots.push_back(v2::CreateSlotEvent(fbb, slot_action_ids, slot_pdf, slot_id));
         }
 
-        std::vector<unsigned char> _context;
-        std::string context_str(context);
-        copy(context_str.begin(), context_str.end(), std::back_inserter(_context));
+        const auto context_vec = fbb.CreateVector(reinterpret_cast<const uint8_t*>(context), strlen(context));
+        const auto slots_vec = fbb.CreateVector(slots);
+        const auto model_id = fbb.CreateString(model_version);
+        const auto baseline_actions_vec = fbb.CreateVector(baseline_actions);
 
-        auto fb = v2::CreateMultiSlotEventDirect(fbb, &_context, &slots, model_version.c_str(), flags & action_flags::DEFERRED, &baseline_actions, learning_mode);
+        auto fb = v2::CreateMultiSlotEvent(fbb, context_vec, slots_vec, model_id, flags & action_flags::DEFERRED, baseline_actions_vec, learning_mode);
         fbb.Finish(fb);
         return fbb.Release();
       }
@@ -108,7 +127,7 @@ namespace reinforcement_learning {
 
     struct outcome_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_Outcome> {
       static generic_event::payload_buffer_t numeric_event(float outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = v2::CreateNumericOutcome(fbb, outcome).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_numeric, evt);
         fbb.Finish(fb);
@@ -116,7 +135,7 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t string_event(const char* outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = fbb.CreateString(outcome).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_literal, evt);
         fbb.Finish(fb);
@@ -124,7 +143,7 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t numeric_event(int index, float outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = v2::CreateNumericOutcome(fbb, outcome).Union();
         const auto idx = v2::CreateNumericIndex(fbb, index).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_numeric, evt, v2::IndexValue_numeric, idx);
@@ -133,7 +152,7 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t numeric_event(const char* index, float outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = v2::CreateNumericOutcome(fbb, outcome).Union();
         const auto idx = fbb.CreateString(index).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_numeric, evt, v2::IndexValue_literal, idx);
@@ -142,7 +161,7 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t string_event(int index, const char* outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = fbb.CreateString(outcome).Union();
         const auto idx = v2::CreateNumericIndex(fbb, index).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_literal, evt, v2::IndexValue_numeric, idx);
@@ -151,7 +170,7 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t string_event(const char* index, const char* outcome) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto evt = fbb.CreateString(outcome).Union();
         const auto idx = fbb.CreateString(index).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_literal, evt, v2::IndexValue_literal, idx);
@@ -160,14 +179,14 @@ namespace reinforcement_learning {
       }
 
       static generic_event::payload_buffer_t report_action_taken() {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_NONE, 0, v2::IndexValue_NONE, 0, true);
         fbb.Finish(fb);
         return fbb.Release();
       }
 
       static generic_event::payload_buffer_t report_action_taken(const char* index) {
-        flatbuffers::FlatBufferBuilder fbb;
+        auto& fbb = get_thread_builder();
         const auto idx = fbb.CreateString(index).Union();
         auto fb = v2::CreateOutcomeEvent(fbb, v2::OutcomeValue_NONE, 0, v2::IndexValue_literal, idx, true);
         fbb.Finish(fb);
@@ -177,19 +196,26 @@ namespace reinforcement_learning {
 
     struct multistep_serializer : payload_serializer<generic_event::payload_type_t::PayloadType_MultiStep> {
       static generic_event::payload_buffer_t event(const char* context, const char* previous_id, unsigned int flags, const ranking_response& response) {
-        flatbuffers::FlatBufferBuilder fbb;
-        std::vector<uint64_t> action_ids;
-        std::vector<float> probabilities;
+        auto& fbb = get_thread_builder();
+
+        // same layout as cb_serializer, in the same order as CreateMultiStepEventDirect
+        const auto event_id = fbb.CreateString(response.get_event_id());
+        const auto previous = previous_id != nullptr ? fbb.CreateString(previous_id) : 0;
+        uint64_t* action_ids_ptr;
+        const auto action_ids = fbb.CreateUninitializedVector(response.size(), &action_ids_ptr);
+        for (auto const& r : response) {
+          *action_ids_ptr++ = r.action_id + 1;
+        }
+        const auto context_vec = fbb.CreateVector(reinterpret_cast<const uint8_t*>(context), strlen(context));
+        float* probabilities_ptr;
+        const auto probabilities = fbb.CreateUninitializedVector(response.size(), &probabilities_ptr);
         for (auto const& r : response) {
-          action_ids.push_back(r.action_id + 1);
-          probabilities.push_back(r.probability);
+          *probabilities_ptr++ = r.probability;
         }
-        std::vector<unsigned char> _context;
-        std::string context_str(context);
-        copy(context_str.begin(), context_str.end(), std::back_inserter(_context));
+        const auto model_id = fbb.CreateString(response.get_model_id());
 
-        auto fb = v2::CreateMultiStepEventDirect(fbb, response.get_event_id(), previous_id, &action_ids,
-          &_context, &probabilities, response.get_model_id(), flags & action_flags::DEFERRED);
+        auto fb = v2::CreateMultiStepEvent(fbb, event_id, previous, action_ids,
+          context_vec, probabilities, model_id, flags & action_flags::DEFERRED);
         fbb.Finish(fb);
         return fbb.Release();
       }
@@ -19,6 +19,16 @@ namespace reinforcement_learning
     }
   }
 
+  file_durability_enum to_file_durability_enum(const char *durability) {
+    if (_stricmp(durability, value::FILE_DURABILITY_BATCH) == 0) {
+      return file_durability_enum::BATCH;
+    } else if (_stricmp(durability, value::FILE_DURABILITY_INTERVAL) == 0) {
+      return file_durability_enum::INTERVAL;
+    } else {
+      return file_durability_enum::NONE;
+    }
+  }
+
 namespace utility {
 
 static int get_int(const configuration &config, const char *section, const char *property, int defval)
@@ -66,9 +76,19 @@ async_batcher_config get_batcher_config(const configuration &config, const char
   res.send_high_water_mark = get_int(config, section, name::SEND_HIGH_WATER_MARK, 198 * 1024);
   res.send_batch_interval_ms = get_int(config, section, name::SEND_BATCH_INTERVAL_MS, 1000);
   res.send_queue_max_capacity = get_int(config, section, name::SEND_QUEUE_MAX_CAPACITY_KB, 16 * 1024) * 1024;
+  res.send_queue_max_events = get_int(config, section, name::SEND_QUEUE_MAX_EVENTS, value::DEFAULT_SEND_QUEUE_MAX_EVENTS);
+  res.send_queue_flush_fraction = get_float(config, section, name::SEND_QUEUE_FLUSH_FRACTION, value::DEFAULT_SEND_QUEUE_FLUSH_FRACTION);
+  res.batcher_shards = get_int(config, section, name::SEND_BATCHER_SHARDS, value::DEFAULT_SEND_BATCHER_SHARDS);
   res.queue_mode = to_queue_mode_enum(get_str(config, section, name::QUEUE_MODE, value::QUEUE_MODE_DROP));
   res.batch_content_encoding = config.get_bool(section, name::USE_DEDUP, false) ? value::CONTENT_ENCODING_DEDUP : value::CONTENT_ENCODING_IDENTITY;
+  res.use_batch_compression = config.get_bool(section, name::USE_BATCH_COMPRESSION, false);
+  res.batch_compression_level = get_int(config, section, name::ZSTD_COMPRESSION_LEVEL, value::DEFAULT_ZSTD_COMPRESSION_LEVEL);
+  res.adaptive_compression_level = config.get_bool(section, name::ZSTD_ADAPTIVE_LEVEL, false);
+  res.min_compression_level = get_int(config, section, name::ZSTD_MIN_COMPRESSION_LEVEL, value::DEFAULT_ZSTD_MIN_COMPRESSION_LEVEL);
+  res.max_compression_level = get_int(config, section, name::ZSTD_MAX_COMPRESSION_LEVEL, value::DEFAULT_ZSTD_MAX_COMPRESSION_LEVEL);
   res.subsample_rate = get_float(config, section, name::SUBSAMPLE_RATE, 1.f);
+  res.buffer_pool_max_bytes = static_cast<size_t>(get_int(config, section, name::BUFFER_POOL_MAX_KB, value::DEFAULT_BUFFER_POOL_MAX_KB)) * 1024;
+  res.buffer_pool_idle_ms = get_int(config, section, name::BUFFER_POOL_IDLE_MS, value::DEFAULT_BUFFER_POOL_IDLE_MS);
   return res;
 }
 
@@ -76,6 +96,55 @@ async_batcher_config::async_batcher_config():
   send_high_water_mark(198 * 1024),
   send_batch_interval_ms(1000),
   send_queue_max_capacity(16 * 1024 * 1024),
-  queue_mode(queue_mode_enum::DROP) {}
+  send_queue_max_events(value::DEFAULT_SEND_QUEUE_MAX_EVENTS),
+  send_queue_flush_fraction(value::DEFAULT_SEND_QUEUE_FLUSH_FRACTION),
+  batcher_shards(value::DEFAULT_SEND_BATCHER_SHARDS),
+  shard(0),
+  queue_mode(queue_mode_enum::DROP),
+  batch_content_encoding(value::CONTENT_ENCODING_IDENTITY),
+  use_batch_compression(false),
+  batch_compression_level(value::DEFAULT_ZSTD_COMPRESSION_LEVEL),
+  adaptive_compression_level(false),
+  min_compression_level(value::DEFAULT_ZSTD_MIN_COMPRESSION_LEVEL),
+  max_compression_level(value::DEFAULT_ZSTD_MAX_COMPRESSION_LEVEL),
+  buffer_pool_max_bytes(static_cast<size_t>(value::DEFAULT_BUFFER_POOL_MAX_KB) * 1024),
+  buffer_pool_idle_ms(value::DEFAULT_BUFFER_POOL_IDLE_MS) {}
+
+spool_config get_spool_config(const configuration &config, const char *section)
+{
+  spool_config res;
+  res.directory = get_str(config, section, name::SPOOL_DIRECTORY, "");
+  res.segment_size = static_cast<size_t>(get_int(config, section, name::SPOOL_SEGMENT_SIZE_KB, value::DEFAULT_SPOOL_SEGMENT_SIZE_KB)) * 1024;
+  res.max_disk_bytes = static_cast<size_t>(get_int(config, section, name::SPOOL_MAX_DISK_MB, value::DEFAULT_SPOOL_MAX_DISK_MB)) * 1024 * 1024;
+  res.send_deadline_ms = get_int(config, section, name::SPOOL_SEND_DEADLINE_MS, value::DEFAULT_SPOOL_SEND_DEADLINE_MS);
+  res.max_pending_batches = get_int(config, section, name::SPOOL_MAX_PENDING_BATCHES, value::DEFAULT_SPOOL_MAX_PENDING_BATCHES);
+  res.replay_bytes_per_sec = static_cast<size_t>(get_int(config, section, name::SPOOL_REPLAY_KB_PER_SEC, value::DEFAULT_SPOOL_REPLAY_KB_PER_SEC)) * 1024;
+  return res;
+}
+
+spool_config::spool_config():
+  segment_size(static_cast<size_t>(value::DEFAULT_SPOOL_SEGMENT_SIZE_KB) * 1024),
+  max_disk_bytes(static_cast<size_t>(value::DEFAULT_SPOOL_MAX_DISK_MB) * 1024 * 1024),
+  send_deadline_ms(value::DEFAULT_SPOOL_SEND_DEADLINE_MS),
+  max_pending_batches(value::DEFAULT_SPOOL_MAX_PENDING_BATCHES),
+  replay_bytes_per_sec(static_cast<size_t>(value::DEFAULT_SPOOL_REPLAY_KB_PER_SEC) * 1024) {}
+
+file_sender_config get_file_sender_config(const configuration &config, const char *section)
+{
+  file_sender_config res;
+  res.durability = to_file_durability_enum(get_str(config, section, name::FILE_DURABILITY, value::FILE_DURABILITY_NONE));
+  res.sync_interval_ms = get_int(config, section, name::FILE_SYNC_INTERVAL_MS, value::DEFAULT_FILE_SYNC_INTERVAL_MS);
+  res.rotate_size = static_cast<size_t>(get_int(config, section, name::FILE_ROTATE_SIZE_KB, 0)) * 1024;
+  res.rotate_interval_ms = get_int(config, section, name::FILE_ROTATE_INTERVAL_MS, 0);
+  res.max_pending_bytes = static_cast<size_t>(get_int(config, section, name::FILE_MAX_PENDING_KB, value::DEFAULT_FILE_MAX_PENDING_KB)) * 1024;
+  return res;
+}
+
+file_sender_config::file_sender_config():
+  durability(file_durability_enum::NONE),
+  sync_interval_ms(value::DEFAULT_FILE_SYNC_INTERVAL_MS),
+  rotate_size(0),
+  rotate_interval_ms(0),
+  max_pending_bytes(static_cast<size_t>(value::DEFAULT_FILE_MAX_PENDING_KB) * 1024) {}
 
 }}
@@ -1,6 +1,8 @@
 #pragma once
 #include "configuration.h"
 
+#include <string>
+
 namespace reinforcement_learning {
   //this enum sets the behavior of the queue managed by the async_batcher
   enum class queue_mode_enum {
@@ -8,6 +10,13 @@ namespace reinforcement_learning {
     BLOCK//queue block if it is full
   };
 
+  //this enum sets when async_file_logger forces the written batches to disk
+  enum class file_durability_enum {
+    NONE,//left to the operating system (default)
+    INTERVAL,//at most sync_interval_ms after they were written
+    BATCH//before send returns
+  };
+
   // Section constants to be used with get_batcher_config
   const char *const OBSERVATION_SECTION = "observation";
   const char *const INTERACTION_SECTION = "interaction";
@@ -18,12 +27,49 @@ namespace utility {
     int send_high_water_mark;
     int send_batch_interval_ms;
     int send_queue_max_capacity;
+    int send_queue_max_events;    // number of slots of the event queue
+    // the batcher flushes as soon as the queued bytes reach min(send_high_water_mark, send_queue_flush_fraction * send_queue_max_capacity)
+    // instead of waiting for send_batch_interval_ms. 0 = timer only, the default 1 flushes at the high water mark
+    float send_queue_flush_fraction;
+    int batcher_shards;           // number of batchers sharing the sender (see sharded_async_batcher)
+    int shard;                    // index of the batcher among them, set by create_sharded_batcher
     queue_mode_enum queue_mode;
     // bool use_compression;
     // bool use_dedup;
     const char *batch_content_encoding;
+    bool use_batch_compression;   // zstd compress the whole serialized batch
+    int batch_compression_level;
+    // the level of the batch and per event compression follows the queue pressure within [min, max] (see compression_level_controller)
+    bool adaptive_compression_level;
+    int min_compression_level;
+    int max_compression_level;
     float subsample_rate = 1.f;   // percentage of kept events. 0 = drop all events, 1 = keep all events
+    size_t buffer_pool_max_bytes; // batch buffers kept for reuse (see object_pool)
+    int buffer_pool_idle_ms;      // pooled batch buffers unused that long are freed
   };
 
   async_batcher_config get_batcher_config(const configuration& config, const char* section);
+
+  struct spool_config {
+    spool_config();
+    std::string directory;          // empty = no spool
+    size_t segment_size;            // bytes of a segment file
+    size_t max_disk_bytes;          // all the segment files of the spool
+    int send_deadline_ms;           // a batch not sent after that long goes to the spool
+    int max_pending_batches;        // batches waiting for the sender, the next ones go to the spool
+    size_t replay_bytes_per_sec;    // 0 = as fast as the sender takes them
+  };
+
+  spool_config get_spool_config(const configuration& config, const char* section);
+
+  struct file_sender_config {
+    file_sender_config();
+    file_durability_enum durability;
+    int sync_interval_ms;           // used with the INTERVAL durability
+    size_t rotate_size;             // bytes, the file is rotated once it is that big. 0 = no size rotation
+    int rotate_interval_ms;         // the file is rotated that long after its first batch. 0 = no time rotation
+    size_t max_pending_bytes;       // send waits while that much is waiting for the writer
+  };
+
+  file_sender_config get_file_sender_config(const configuration& config, const char* section);
 }}
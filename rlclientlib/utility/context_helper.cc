@@ -16,64 +16,19 @@ namespace reinforcement_learning { namespace utility {
 
   const auto multi = "_multi";
   const auto slots = "_slots";
-  const auto event_id = "_id";
   const auto slot_id = "_id";
 
-  /**
-   * \brief Get the event IDs from the slots entries in the context json string.
-   * 
-   * \param context   : String with context json
-   * \param event_ids : Reference to the mapping from slot index to event ID string, results will be
-   *                    put in here
-   * \param trace     : Pointer to the trace logger
-   * \param status    : Pointer to api_status object that contains an error code and error description in
-   *                    case of failure
-   * \return  error_code::success if there are no errors.  If there are errors then the error code is
-   *          returned.
-   */
-  int get_event_ids(const char* context, std::map<size_t, std::string>& event_ids, i_trace* trace, api_status* status) {
-    try {
-      rj::Document obj;
-      obj.Parse(context);
-
-      if (obj.HasParseError()) {
-        RETURN_ERROR_LS(trace, status, json_parse_error) << "JSON parse error: " << rj::GetParseError_En(obj.GetParseError()) << " (" << obj.GetErrorOffset() << ")";
-      }
-
-      const rj::Value::ConstMemberIterator& itr = obj.FindMember(slots);
-      if (itr != obj.MemberEnd() && itr->value.IsArray()) {
-        const auto& arr = itr->value.GetArray();
-        for (rj::SizeType i = 0; i < arr.Size(); ++i) {
-          const auto& current = arr[i];
-          const auto member_itr = current.FindMember(event_id);
-          if(member_itr != current.MemberEnd() && member_itr->value.IsString()) {
-            const auto event_id_string = std::string(member_itr->value.GetString());
-            event_ids[i] = std::string{ event_id_string.begin(), event_id_string.end() };
-          }
-        }
-
-        return error_code::success;
-      }
-      RETURN_ERROR_LS(trace, status, json_no_slots_found);
-    }
-    catch ( const std::exception& e ) {
-      RETURN_ERROR_LS(trace, status, json_parse_error) << e.what();
-    }
-    catch ( ... ) {
-      RETURN_ERROR_LS(trace, status, json_parse_error) << error_code::unknown_s;
-    }
-  }
-
   struct MessageHandler : public rj::BaseReaderHandler<rj::UTF8<>, MessageHandler> {
-    rj::InsituStringStream &_is;
+    rj::StringStream &_is;
     ContextInfo &_info;
     int _level = 0;
     int _array_level = 0;
     bool _is_multi = false;
     bool _is_slots = false;
+    bool _is_slot_id = false;
     size_t _item_start = 0;
 
-    MessageHandler(rj::InsituStringStream &is, ContextInfo &info) : 
+    MessageHandler(rj::StringStream &is, ContextInfo &info) :
       _is(is),
       _info(info),
       _level(0),
@@ -88,11 +43,28 @@ namespace reinforcement_learning { namespace utility {
         _is_multi = !strcmp(str, multi);
         _is_slots = !strcmp(str, slots);
       }
+      // "_id" member of a slot object (nested objects are not considered)
+      _is_slot_id = _is_slots && _level == 2 && _array_level == 1 && !strcmp(str, slot_id);
+      return true;
+    }
+
+    bool String(const char* str, rj::SizeType length, bool copy)
+    {
+      if(_is_slot_id) {
+        _info.slot_ids[_info.slots.size()] = std::string(str, length);
+      }
+      return Default();
+    }
+
+    bool Default()
+    {
+      _is_slot_id = false;
       return true;
     }
 
     bool StartObject()
     {
+      _is_slot_id = false;
       if((_is_multi | _is_slots) && _level == 1 && _array_level == 1)
         _item_start = _is.Tell() - 1;
 
@@ -116,6 +88,7 @@ namespace reinforcement_learning { namespace utility {
 
     bool StartArray()
     {
+      _is_slot_id = false;
       ++_array_level;
       return true;
     }
@@ -129,15 +102,18 @@ namespace reinforcement_learning { namespace utility {
 
   int get_context_info(const char *context, ContextInfo &info, i_trace* trace, api_status* status)
   {
-    std::string copy(context);
     info.actions.clear();
     info.slots.clear();
+    info.slot_ids.clear();
 
-    rj::InsituStringStream iss((char*)copy.c_str());
-    MessageHandler mh(iss, info);
+    // The context is only read: rapidjson's SAX reader scans it in place and only buffers the strings it
+    // reports, so neither the context nor the slot objects are copied.
+    rj::StringStream ss(context);
+    MessageHandler mh(ss, info);
 
-    rj::Reader reader;
-    auto res = reader.Parse<rj::kParseInsituFlag>(iss, mh);
+    // the reader allocates its parse stack on first use and keeps it, so reuse one per thread
+    static thread_local rj::Reader reader;
+    auto res = reader.Parse(ss, mh);
     if(res.IsError()) {
       std::ostringstream os;
       os << "JSON parse error: " << rj::GetParseError_En(res.Code()) << " (" << res.Offset() << ")";
@@ -145,31 +121,4 @@ namespace reinforcement_learning { namespace utility {
     }
     return error_code::success;
   }
-
-  int get_slot_ids(const char* context, const ContextInfo::index_vector_t& slots, std::map<size_t, std::string>& slot_ids, i_trace* trace, api_status* status)
-  {
-    for(size_t i = 0; i < slots.size(); i++)
-    {
-      try {
-        rj::Document obj;
-        obj.Parse(std::string(context + slots[i].first, slots[i].second).c_str());
-
-        if (obj.HasParseError()) {
-          RETURN_ERROR_LS(trace, status, json_parse_error) << "JSON parse error: " << rj::GetParseError_En(obj.GetParseError()) << " (" << obj.GetErrorOffset() << ")";
-        }
-
-        const rj::Value::ConstMemberIterator& itr = obj.FindMember(slot_id);
-        if (itr != obj.MemberEnd() && itr->value.IsString()) {
-          slot_ids[i] = std::string(itr->value.GetString());
-        }
-      }
-      catch ( const std::exception& e ) {
-        RETURN_ERROR_LS(trace, status, json_parse_error) << e.what();
-      }
-      catch ( ... ) {
-        RETURN_ERROR_LS(trace, status, json_parse_error) << error_code::unknown_s;
-      }
-    }
-    return error_code::success;
-  }
 }}
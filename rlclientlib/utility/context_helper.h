@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <map>
+#include <string>
 #include <utility>
 
 namespace reinforcement_learning {
@@ -18,9 +19,10 @@ namespace reinforcement_learning {
       index_vector_t actions;
       //! The index to each element in the _slots array
       index_vector_t slots;
+      //! The "_id" of each element in the _slots array that provides one (slot or event id), keyed by slot index
+      std::map<size_t, std::string> slot_ids;
   };
 
-  int get_event_ids(const char* context, std::map<size_t, std::string>& event_ids, i_trace* trace, api_status* status);
+  //! Single (copy-free) pass over the context json collecting action ranges, slot ranges and slot ids.
   int get_context_info(const char* context, ContextInfo &info, i_trace* trace = nullptr, api_status* status = nullptr);
-  int get_slot_ids(const char* context, const ContextInfo::index_vector_t& slots, std::map<size_t, std::string>& slot_ids, i_trace* trace = nullptr, api_status* status = nullptr);
 }}
@@ -19,6 +19,10 @@ namespace reinforcement_learning {
       _body_endoffset = _preamble_size;
     }
 
+    size_t data_buffer::capacity() const {
+      return _buffer.capacity();
+    }
+
     data_buffer::value_type* data_buffer::raw_begin() {
       return _buffer.data();
     }
@@ -0,0 +1,125 @@
+#include "executor.h"
+
+#include <algorithm>
+
+namespace reinforcement_learning {
+  namespace utility {
+    namespace {
+      // identifies the executor worker running on the current thread, if any
+      thread_local const executor* current_executor = nullptr;
+      thread_local size_t current_worker = 0;
+    }
+
+    executor::executor(size_t thread_count) {
+      if (thread_count == 0) {
+        thread_count = std::max<size_t>(1, std::thread::hardware_concurrency());
+      }
+
+      for (size_t i = 0; i < thread_count; ++i) {
+        _queues.emplace_back(new worker_queue());
+      }
+      for (size_t i = 0; i < thread_count; ++i) {
+        _workers.emplace_back(&executor::run, this, i);
+      }
+    }
+
+    executor::~executor() {
+      {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _stop = true;
+      }
+      _idle_cv.notify_all();
+
+      for (auto& worker : _workers) {
+        worker.join();
+      }
+    }
+
+    void executor::submit(task_t task) {
+      const size_t index = current_executor == this
+        ? current_worker
+        : _next.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+      {
+        std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+        _queues[index]->tasks.push_back(std::move(task));
+      }
+      ++_pending;
+
+      // a worker parks after announcing itself and re-checking _pending, so either it sees the task or we see it
+      if (_parked > 0) {
+        std::lock_guard<std::mutex> lock(_idle_mutex);
+        _idle_cv.notify_one();
+      }
+    }
+
+    size_t executor::thread_count() const {
+      return _workers.size();
+    }
+
+    bool executor::try_reserve() {
+      size_t pending = _pending.load();
+      while (pending > 0) {
+        if (_pending.compare_exchange_weak(pending, pending - 1)) {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    bool executor::try_pop(size_t index, task_t& task) {
+      // oldest task of the own deque first, then the most recent task of another worker
+      for (size_t i = 0; i < _queues.size(); ++i) {
+        auto& queue = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+          continue;
+        }
+
+        if (i == 0) {
+          task = std::move(queue.tasks.front());
+          queue.tasks.pop_front();
+        }
+        else {
+          task = std::move(queue.tasks.back());
+          queue.tasks.pop_back();
+        }
+        return true;
+      }
+      return false;
+    }
+
+    void executor::run(size_t index) {
+      current_executor = this;
+      current_worker = index;
+
+      while (true) {
+        if (!try_reserve()) {
+          std::unique_lock<std::mutex> lock(_idle_mutex);
+          ++_parked;
+          _idle_cv.wait(lock, [this] { return _stop || _pending > 0; });
+          --_parked;
+          if (_stop && _pending == 0) {
+            // stopped and drained
+            return;
+          }
+          continue;
+        }
+
+        // the reserved task was pushed before it was counted, but other workers may take it from under a scan and
+        // leave us a task in a deque that was already visited, so keep looking until one is found
+        task_t task;
+        while (!try_pop(index, task)) {
+          std::this_thread::yield();
+        }
+
+        try {
+          task();
+        }
+        catch (...) {
+          // tasks report their failures through their own completion path
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace reinforcement_learning {
+  namespace utility {
+
+    // Fixed size work-stealing thread pool.
+    // Every worker owns a task deque. Tasks submitted from a worker stay on its own deque, other submissions are
+    // spread round-robin, and a worker that runs dry steals from the others before going to sleep.
+    class executor {
+    public:
+      using task_t = std::function<void()>;
+
+      // thread_count == 0 uses one worker per hardware thread
+      explicit executor(size_t thread_count);
+      // Runs the tasks that are still queued, then joins the workers.
+      ~executor();
+
+      void submit(task_t task);
+      size_t thread_count() const;
+
+      executor(const executor&) = delete;
+      executor(executor&&) = delete;
+      executor& operator=(const executor&) = delete;
+      executor& operator=(executor&&) = delete;
+
+    private:
+      struct worker_queue {
+        std::mutex mutex;
+        std::deque<task_t> tasks;
+      };
+
+      void run(size_t index);
+      bool try_reserve();
+      bool try_pop(size_t index, task_t& task);
+
+    private:
+      std::vector<std::unique_ptr<worker_queue>> _queues;
+      std::vector<std::thread> _workers;
+      std::atomic<size_t> _next{ 0 };
+
+      // queued tasks no worker has reserved yet, a reservation is always backed by a task in some deque
+      std::atomic<size_t> _pending{ 0 };
+      // workers parked on _idle_cv, submit only takes _idle_mutex to wake one of them
+      std::atomic<size_t> _parked{ 0 };
+      std::mutex _idle_mutex;
+      std::condition_variable _idle_cv;
+      bool _stop = false;
+    };
+  }
+}
@@ -1,35 +1,148 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <mutex>
+#include <vector>
+#include "constants.h"
 #include "data_buffer.h"
 
 namespace reinforcement_learning {
   namespace utility {
 
+    struct object_pool_stats {
+      uint64_t hits = 0;          // acquire served by a pooled object
+      uint64_t misses = 0;        // acquire had to allocate
+      uint64_t dropped = 0;       // released objects freed because the pool was full
+      uint64_t trimmed = 0;       // pooled objects freed by trim after staying unused
+      size_t pooled_bytes = 0;
+      size_t pooled_objects = 0;
+    };
+
+    // Recycles objects by the power of two class of their capacity, so that acquire picks one about as large as
+    // what is asked for rather than whichever was released last.
+    // At most max_pooled_bytes are kept, the objects released beyond that are freed, and trim() frees the ones
+    // unused for idle_ms so that what a traffic spike allocated goes back once it is over.
+    // Each class keeps the last object released to it in a slot taken and filled with atomic exchanges, its mutex is
+    // only taken when the slot is already empty (acquire) or full (release).
+    // Object needs reset(), capacity() and a constructor from a size.
     template<typename Object>
     class object_pool {
-
     public:
-      std::shared_ptr<Object> acquire();
-      void release(Object*);
+      explicit object_pool(size_t max_pooled_bytes = static_cast<size_t>(value::DEFAULT_BUFFER_POOL_MAX_KB) * 1024,
+        int idle_ms = value::DEFAULT_BUFFER_POOL_IDLE_MS);
       ~object_pool();
 
+      // an object of at least min_capacity bytes when there is one in the pool, else the largest smaller one, else a
+      // new one
+      std::shared_ptr<Object> acquire(size_t min_capacity = 0);
+      void release(Object*);
+      // frees the pooled objects unused for idle_ms
+      void trim();
+      object_pool_stats stats() const;
+
+      object_pool(const object_pool&) = delete;
+      object_pool& operator=(const object_pool&) = delete;
+
+    private:
+      using clock = std::chrono::steady_clock;
+
+      static const size_t MIN_CLASS_SHIFT = 10;   // 1 KB
+      static const size_t CLASS_COUNT = 20;       // the last class takes everything from 512 MB
+
+      struct pooled {
+        Object* object;
+        clock::time_point released;
+      };
+
+      struct size_class {
+        std::atomic<Object*> slot{ nullptr };
+        std::atomic<size_t> count{ 0 };           // slot included
+        std::atomic<clock::rep> last_used{ 0 };
+        std::mutex mutex;
+        std::vector<pooled> objects;              // oldest first
+      };
+
+      // class holding the objects of that capacity
+      static size_t size_class_of(size_t capacity);
+      // first class whose objects are all at least that large
+      static size_t size_class_above(size_t capacity);
+
+      Object* take(size_class& c, clock::rep now);
+
     private:
       bool _pool_invalid = false;
-      std::vector<Object*> _pool;
-      std::mutex _mutex;
+      const size_t _max_pooled_bytes;
+      const clock::duration _idle;
+      std::array<size_class, CLASS_COUNT> _classes;
+      std::atomic<size_t> _pooled_bytes{ 0 };
+      std::atomic<uint64_t> _hits{ 0 };
+      std::atomic<uint64_t> _misses{ 0 };
+      std::atomic<uint64_t> _dropped{ 0 };
+      std::atomic<uint64_t> _trimmed{ 0 };
     };
 
     template <typename Object>
-    std::shared_ptr<Object> object_pool<Object>::acquire() {
-      std::lock_guard<std::mutex> lock(_mutex);
-      Object* ptr;
+    object_pool<Object>::object_pool(size_t max_pooled_bytes, int idle_ms)
+      : _max_pooled_bytes(max_pooled_bytes)
+      , _idle(std::chrono::milliseconds(idle_ms)) {}
+
+    template <typename Object>
+    size_t object_pool<Object>::size_class_of(size_t capacity) {
+      size_t shift = MIN_CLASS_SHIFT;
+      while (shift - MIN_CLASS_SHIFT < CLASS_COUNT - 1 && (capacity >> (shift + 1)) != 0) {
+        ++shift;
+      }
+      return shift - MIN_CLASS_SHIFT;
+    }
 
-      if (_pool.empty()) {
-        ptr = new Object();
+    template <typename Object>
+    size_t object_pool<Object>::size_class_above(size_t capacity) {
+      const size_t c = size_class_of(capacity);
+      // capacity is not the lower bound of its class
+      if (c + 1 < CLASS_COUNT && capacity > (static_cast<size_t>(1) << (c + MIN_CLASS_SHIFT))) {
+        return c + 1;
+      }
+      return c;
+    }
+
+    template <typename Object>
+    Object* object_pool<Object>::take(size_class& c, clock::rep now) {
+      if (c.count.load(std::memory_order_relaxed) == 0) return nullptr;
+      Object* ptr = c.slot.exchange(nullptr, std::memory_order_acquire);
+      if (ptr == nullptr) {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (c.objects.empty()) return nullptr;
+        ptr = c.objects.back().object;
+        c.objects.pop_back();
+      }
+      c.count.fetch_sub(1, std::memory_order_relaxed);
+      c.last_used.store(now, std::memory_order_relaxed);
+      _pooled_bytes.fetch_sub(ptr->capacity(), std::memory_order_relaxed);
+      return ptr;
+    }
+
+    template <typename Object>
+    std::shared_ptr<Object> object_pool<Object>::acquire(size_t min_capacity) {
+      const auto now = clock::now().time_since_epoch().count();
+      const size_t first = size_class_above(min_capacity);
+      Object* ptr = nullptr;
+      for (size_t c = first; ptr == nullptr && c < CLASS_COUNT; ++c) {
+        ptr = take(_classes[c], now);
+      }
+      // a smaller object still saves the allocation of the object itself
+      for (size_t c = first; ptr == nullptr && c > 0; --c) {
+        ptr = take(_classes[c - 1], now);
+      }
+
+      if (ptr == nullptr) {
+        _misses.fetch_add(1, std::memory_order_relaxed);
+        ptr = min_capacity > 0 ? new Object(min_capacity) : new Object();
       }
       else {
-        ptr = _pool.back();
-        _pool.pop_back();
+        _hits.fetch_add(1, std::memory_order_relaxed);
         ptr->reset();
       }
       return std::shared_ptr<Object>(ptr, [this](Object* pobject) {
@@ -41,19 +154,81 @@ namespace reinforcement_learning {
     void object_pool<Object>::release(Object* pobj) {
       // In some test scenarios the pool is destroyed
       // before the object is released
-      if(_pool_invalid) return;
+      if (_pool_invalid) return;
+
+      const size_t bytes = pobj->capacity();
+      if (_pooled_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > _max_pooled_bytes) {
+        _pooled_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        delete pobj;
+        return;
+      }
+
+      const auto now = clock::now();
+      auto& c = _classes[size_class_of(bytes)];
+      c.last_used.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+      c.count.fetch_add(1, std::memory_order_relaxed);
+      Object* empty = nullptr;
+      if (!c.slot.compare_exchange_strong(empty, pobj, std::memory_order_release, std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        c.objects.push_back({ pobj, now });
+      }
+    }
+
+    template <typename Object>
+    void object_pool<Object>::trim() {
+      const auto cutoff = clock::now() - _idle;
+      std::vector<Object*> idle;
+      for (auto& c : _classes) {
+        if (c.count.load(std::memory_order_relaxed) == 0) continue;
+        {
+          std::lock_guard<std::mutex> lock(c.mutex);
+          // the slot holds the object released last, it is idle once the whole class is
+          if (c.last_used.load(std::memory_order_relaxed) < cutoff.time_since_epoch().count()) {
+            Object* ptr = c.slot.exchange(nullptr, std::memory_order_acquire);
+            if (ptr != nullptr) idle.push_back(ptr);
+          }
+          auto it = c.objects.begin();
+          while (it != c.objects.end() && it->released < cutoff) {
+            idle.push_back(it->object);
+            ++it;
+          }
+          c.objects.erase(c.objects.begin(), it);
+        }
+        c.count.fetch_sub(idle.size(), std::memory_order_relaxed);
+        for (auto ptr : idle) {
+          _pooled_bytes.fetch_sub(ptr->capacity(), std::memory_order_relaxed);
+          delete ptr;
+        }
+        _trimmed.fetch_add(idle.size(), std::memory_order_relaxed);
+        idle.clear();
+      }
+    }
 
-      std::lock_guard<std::mutex> lock(_mutex);
-      _pool.emplace_back(pobj);
+    template <typename Object>
+    object_pool_stats object_pool<Object>::stats() const {
+      object_pool_stats res;
+      res.hits = _hits.load(std::memory_order_relaxed);
+      res.misses = _misses.load(std::memory_order_relaxed);
+      res.dropped = _dropped.load(std::memory_order_relaxed);
+      res.trimmed = _trimmed.load(std::memory_order_relaxed);
+      res.pooled_bytes = _pooled_bytes.load(std::memory_order_relaxed);
+      for (const auto& c : _classes) {
+        res.pooled_objects += c.count.load(std::memory_order_relaxed);
+      }
+      return res;
     }
 
     template <typename Object>
     object_pool<Object>::~object_pool() {
-      for (auto ptr : _pool) {
-        delete ptr;
+      for (auto& c : _classes) {
+        delete c.slot.load();
+        for (const auto& p : c.objects) {
+          delete p.object;
+        }
       }
       _pool_invalid = true;
     }
 
   }
-}
\ No newline at end of file
+}
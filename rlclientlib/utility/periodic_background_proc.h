@@ -30,6 +30,9 @@ namespace reinforcement_learning {
       ~periodic_background_proc();
       void stop();
 
+      // Run the next iteration now instead of waiting for the end of the interval
+      void wake();
+
       // Cannot copy, assign
       periodic_background_proc(const periodic_background_proc&) = delete;
       periodic_background_proc(periodic_background_proc&&) = delete;
@@ -100,6 +103,11 @@ namespace reinforcement_learning {
       }
     }
 
+    template <typename BgProc>
+    void periodic_background_proc<BgProc>::wake() {
+      _sleeper.wake();
+    }
+
     template <typename BGProc>
     periodic_background_proc<BGProc>::~periodic_background_proc() {
       stop();
@@ -0,0 +1,63 @@
+#include "timer_queue.h"
+
+namespace reinforcement_learning {
+  namespace utility {
+    timer_queue::timer_queue()
+      : _thread(&timer_queue::run, this) {}
+
+    timer_queue::~timer_queue() {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+      }
+      _cv.notify_all();
+      _thread.join();
+    }
+
+    std::shared_ptr<timer_queue> timer_queue::shared() {
+      static std::mutex mutex;
+      static std::weak_ptr<timer_queue> instance;
+      std::lock_guard<std::mutex> lock(mutex);
+      auto queue = instance.lock();
+      if (!queue) {
+        queue = std::make_shared<timer_queue>();
+        instance = queue;
+      }
+      return queue;
+    }
+
+    void timer_queue::schedule(clock::duration delay, task_t task) {
+      {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _entries.push({ clock::now() + delay, _next_sequence++, std::move(task) });
+      }
+      // the new task may be due before the one the thread waits for
+      _cv.notify_one();
+    }
+
+    size_t timer_queue::size() {
+      std::lock_guard<std::mutex> lock(_mutex);
+      return _entries.size();
+    }
+
+    void timer_queue::run() {
+      std::unique_lock<std::mutex> lock(_mutex);
+      while (!_stop) {
+        if (_entries.empty()) {
+          _cv.wait(lock);
+          continue;
+        }
+        const auto deadline = _entries.top().deadline;
+        if (clock::now() < deadline) {
+          _cv.wait_until(lock, deadline);
+          continue;
+        }
+        auto task = _entries.top().task;
+        _entries.pop();
+        lock.unlock();
+        task();
+        lock.lock();
+      }
+    }
+  }
+}
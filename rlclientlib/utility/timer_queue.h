@@ -0,0 +1,62 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace reinforcement_learning {
+  namespace utility {
+
+    // Runs tasks once their delay has elapsed, in deadline order, on a single background thread.
+    // Tasks should be short since they hold back the ones due after them. Tasks still waiting at destruction are
+    // dropped.
+    class timer_queue {
+    public:
+      using clock = std::chrono::steady_clock;
+      using task_t = std::function<void()>;
+
+      timer_queue();
+      ~timer_queue();
+
+      // the queue shared by the whole process, created on first use and stopped once its last holder releases it
+      static std::shared_ptr<timer_queue> shared();
+
+      void schedule(clock::duration delay, task_t task);
+      // tasks waiting for their deadline
+      size_t size();
+
+      timer_queue(const timer_queue&) = delete;
+      timer_queue(timer_queue&&) = delete;
+      timer_queue& operator=(const timer_queue&) = delete;
+      timer_queue& operator=(timer_queue&&) = delete;
+
+    private:
+      struct entry {
+        clock::time_point deadline;
+        uint64_t sequence;    // keeps the scheduling order of tasks due at the same time
+        task_t task;
+      };
+
+      struct later {
+        bool operator()(const entry& a, const entry& b) const {
+          return a.deadline > b.deadline || (a.deadline == b.deadline && a.sequence > b.sequence);
+        }
+      };
+
+      void run();
+
+    private:
+      std::mutex _mutex;
+      std::condition_variable _cv;
+      std::priority_queue<entry, std::vector<entry>, later> _entries;
+      uint64_t _next_sequence = 0;
+      bool _stop = false;
+      std::thread _thread;
+    };
+  }
+}
@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace reinforcement_learning { namespace utility {
@@ -9,8 +14,8 @@ namespace reinforcement_learning { namespace utility {
     TObject * _val;
 
   public:
-    pooled_object(TObject* obj, int pversion)
-      : _val(obj), version(pversion)
+    pooled_object(TObject* obj, int pversion, std::shared_ptr<std::atomic<int>> pcount)
+      : _val(obj), version(pversion), count(std::move(pcount))
     { }
 
     pooled_object(const pooled_object&) = delete;
@@ -26,6 +31,8 @@ namespace reinforcement_learning { namespace utility {
     inline TObject* val() { return _val; }
 
     const int version;
+    // live objects of the generation this object was created from
+    const std::shared_ptr<std::atomic<int>> count;
   };
 
   template<typename TObject, typename TFactory>
@@ -54,120 +61,229 @@ namespace reinforcement_learning { namespace utility {
     TObject* get() { return _obj->val(); }
   };
 
+  // Pool of versioned objects optimized for many concurrent request threads.
+  // Idle objects live in per-thread shards of atomic slots, so the steady state get_or_create/return_to_pool
+  // cycle of a thread only touches its own shard and never takes a lock.
+  // Model updates follow an RCU scheme: objects of the new version are pre-warmed before an atomic epoch
+  // (version) bump publishes them, stale objects are detected with a single atomic load and handed to a
+  // background reclaimer thread, so neither construction nor teardown happens on a request thread.
   template<typename TObject, typename TFactory>
-  class versioned_object_pool_unsafe {
-    int _version;
-    std::vector<pooled_object<TObject>*> _pool;
-    TFactory* _factory;
-    int _used_objects;
-    int _objects_count;
+  class versioned_object_pool {
+    using object_t = pooled_object<TObject>;
+
+    // factory, version and live object count are swapped together so that new objects are never mislabeled
+    // and every object is counted against the generation that created it
+    struct generation {
+      generation(TFactory* pfactory, int pversion)
+        : factory(pfactory), version(pversion), objects_count(std::make_shared<std::atomic<int>>(0)) {}
+      std::unique_ptr<TFactory> factory;
+      const int version;
+      const std::shared_ptr<std::atomic<int>> objects_count;
+    };
+
+    static const size_t SLOTS_PER_SHARD = 4;
+    // shards a request thread steals from when its own shard is empty
+    static const size_t STEAL_SHARDS = 2;
+    struct shard {
+      std::atomic<object_t*> slots[SLOTS_PER_SHARD];
+      // keep shards of different threads on different cache lines
+      char padding[64];
+    };
+
+    std::shared_ptr<generation> _generation;
+    std::atomic<int> _version;
+    size_t _shards_count;
+    std::unique_ptr<shard[]> _shards;
+
+    // only used on the slow paths (stale or overflowing objects, factory updates)
+    std::mutex _retired_mutex;
+    std::condition_variable _retired_cv;
+    std::vector<object_t*> _retired;
+    bool _stop_reclaimer{ false };
+    std::mutex _update_mutex;
+    std::thread _reclaimer;
 
   public:
-    versioned_object_pool_unsafe(TFactory* factory, int objects_count, int version)
-      : _version(version)
-      , _factory(factory)
-      , _used_objects(0)
-      , _objects_count(objects_count)
+    versioned_object_pool(TFactory* factory, int init_size = 0)
+      : _generation(std::make_shared<generation>(factory, 0))
+      , _version(0)
+      , _shards_count((std::max)(1u, std::thread::hardware_concurrency()))
+      , _shards(new shard[_shards_count])
     {
-      if (factory != nullptr) {
-        for (int i = 0; i < _objects_count; ++i) {
-          _pool.emplace_back(new pooled_object<TObject>((*_factory)(), _version));
+      for (size_t i = 0; i < _shards_count; ++i) {
+        for (auto& slot : _shards[i].slots) {
+          slot.store(nullptr, std::memory_order_relaxed);
         }
       }
-    }
 
-    versioned_object_pool_unsafe(TFactory* factory)
-      : versioned_object_pool_unsafe(factory, 0, 0)
-    { }
+      if (factory != nullptr) {
+        populate(*_generation, init_size);
+      }
 
-    versioned_object_pool_unsafe(const versioned_object_pool_unsafe&) = delete;
-    versioned_object_pool_unsafe& operator=(const versioned_object_pool_unsafe& other) = delete;
-    versioned_object_pool_unsafe(versioned_object_pool_unsafe&& other) = delete;
+      _reclaimer = std::thread(&versioned_object_pool::reclaim_loop, this);
+    }
+
+    versioned_object_pool(const versioned_object_pool&) = delete;
+    versioned_object_pool& operator=(const versioned_object_pool& other) = delete;
+    versioned_object_pool(versioned_object_pool&& other) = delete;
 
-    ~versioned_object_pool_unsafe() {
-      // delete factory
-      delete _factory;
-      _factory = nullptr;
+    ~versioned_object_pool() {
+      {
+        std::lock_guard<std::mutex> lock(_retired_mutex);
+        _stop_reclaimer = true;
+      }
+      _retired_cv.notify_one();
+      _reclaimer.join();
 
-      // delete each pool object
-      for (auto&& obj : _pool)
-        delete obj;
-      _pool.clear();
+      for (size_t i = 0; i < _shards_count; ++i) {
+        for (auto& slot : _shards[i].slots) {
+          delete slot.exchange(nullptr);
+        }
+      }
+      free_retired();
     }
 
     pooled_object<TObject>* get_or_create() {
-      if (_pool.size() == 0) {
-        _used_objects++;
-        _objects_count++;
-        return new pooled_object<TObject>((*_factory)(), _version);
+      const int version = _version.load(std::memory_order_acquire);
+      const size_t home = thread_shard();
+
+      // look in the thread's own shard first, then steal from the first shards, where pre-warmed
+      // objects are placed, so a miss costs a bounded number of probes whatever the shard count
+      object_t* obj = take(_shards[home], version);
+      for (size_t s = 0; obj == nullptr && s < (std::min)(STEAL_SHARDS, _shards_count); ++s) {
+        if (s != home) obj = take(_shards[s], version);
       }
+      if (obj != nullptr) return obj;
 
-      auto back = _pool.back();
-      _pool.pop_back();
-
-      return back;
+      // miss: create an object out of one generation snapshot and count it against that generation
+      const auto gen = std::atomic_load(&_generation);
+      ++*gen->objects_count;
+      return new object_t((*gen->factory)(), gen->version, gen->objects_count);
     }
 
     void return_to_pool(pooled_object<TObject>* obj) {
-      if (_version == obj->version) {
-        _pool.emplace_back(obj);
-        return;
+      if (obj->version != _version.load(std::memory_order_acquire)) {
+        retire(obj);
+      }
+      else if (!try_place(obj, thread_shard())) {
+        // the shards are full, the object no longer counts towards the next pre-warm
+        retire_counted(obj);
       }
-
-      delete obj;
     }
 
-    int size() const {
-      return _objects_count;
+    // takes owner-ship of factory (and will free using delete)
+    // Objects of the new version are created before the swap, so request threads never wait on object creation.
+    void update_factory(TFactory* new_factory) {
+      std::lock_guard<std::mutex> lock(_update_mutex);
+      const int version = _version.load() + 1;
+      // objects beyond what the shards hold would be retired as soon as they are placed
+      const int capacity = static_cast<int>(_shards_count * SLOTS_PER_SHARD);
+      const auto current = std::atomic_load(&_generation);
+      const int objects_count = (std::max)(0, (std::min)(current->objects_count->load(), capacity));
+
+      auto gen = std::make_shared<generation>(new_factory, version);
+      std::vector<object_t*> fresh;
+      fresh.reserve(objects_count);
+      for (int i = 0; i < objects_count; ++i) {
+        fresh.push_back(new object_t((*gen->factory)(), version, gen->objects_count));
+      }
+      // objects created by get_or_create while the new ones were being built count against the old generation
+      gen->objects_count->store(objects_count);
+
+      std::atomic_store(&_generation, gen);
+      _version.store(version, std::memory_order_release);
+
+      // evict stale idle objects and publish the fresh ones
+      for (size_t s = 0; s < _shards_count; ++s) {
+        for (auto& slot : _shards[s].slots) {
+          object_t* obj = slot.load(std::memory_order_relaxed);
+          if (obj != nullptr && obj->version != version) {
+            obj = slot.exchange(nullptr);
+            if (obj != nullptr && obj->version != version) retire(obj);
+            else if (obj != nullptr && !try_place(obj, s)) retire_counted(obj);
+          }
+        }
+      }
+      for (auto obj : fresh) {
+        if (!try_place(obj, 0)) retire_counted(obj);
+      }
     }
 
-    int version() const {
-      return _version;
+  private:
+    void populate(generation& gen, int count) {
+      for (int i = 0; i < count; ++i) {
+        auto obj = new object_t((*gen.factory)(), gen.version, gen.objects_count);
+        if (try_place(obj, 0)) ++*gen.objects_count;
+        else retire(obj);
+      }
     }
-  };
 
-  template<typename TObject, typename TFactory>
-  class versioned_object_pool {
-    std::mutex _mutex;
-    using impl_type = versioned_object_pool_unsafe<TObject, TFactory>;
-    std::unique_ptr<impl_type> _impl;
-
-  public:
-    versioned_object_pool(TFactory* factory, int init_size = 0)
-    : _impl(new impl_type(factory, init_size, 0))
-    { }
+    // take an object of the given version out of a shard, stale ones found on the way are retired
+    object_t* take(shard& sh, int version) {
+      for (size_t i = SLOTS_PER_SHARD; i-- > 0;) {
+        if (sh.slots[i].load(std::memory_order_relaxed) == nullptr) continue;
+        object_t* obj = sh.slots[i].exchange(nullptr, std::memory_order_acquire);
+        if (obj == nullptr) continue;
+        if (obj->version == version) return obj;
+        retire(obj);
+      }
+      return nullptr;
+    }
 
-    versioned_object_pool(const versioned_object_pool&) = delete;
-    versioned_object_pool& operator=(const versioned_object_pool& other) = delete;
-    versioned_object_pool(versioned_object_pool&& other) = delete;
+    bool try_place(object_t* obj, size_t home) {
+      for (size_t s = 0; s < _shards_count; ++s) {
+        auto& sh = _shards[(home + s) % _shards_count];
+        for (auto& slot : sh.slots) {
+          object_t* expected = nullptr;
+          if (slot.load(std::memory_order_relaxed) == nullptr &&
+              slot.compare_exchange_strong(expected, obj, std::memory_order_release, std::memory_order_relaxed)) {
+            return true;
+          }
+        }
+      }
+      return false;
+    }
 
-    ~versioned_object_pool() {
-      std::lock_guard<std::mutex> lock(_mutex);
-      _impl.reset();
+    // hand an object over to the reclaimer thread, destruction (i.e. VW::finish) never runs on the caller
+    void retire(object_t* obj) {
+      {
+        std::lock_guard<std::mutex> lock(_retired_mutex);
+        _retired.push_back(obj);
+      }
+      _retired_cv.notify_one();
     }
 
-    pooled_object<TObject>* get_or_create() {
-      std::lock_guard<std::mutex> lock(_mutex);
-      return _impl->get_or_create();
+    // retire an object of the current version, it no longer counts towards its generation
+    void retire_counted(object_t* obj) {
+      --*obj->count;
+      retire(obj);
     }
 
-    void return_to_pool(pooled_object<TObject>* obj) {
-      std::lock_guard<std::mutex> lock(_mutex);
-      _impl->return_to_pool(obj);
+    void reclaim_loop() {
+      std::unique_lock<std::mutex> lock(_retired_mutex);
+      while (!_stop_reclaimer) {
+        _retired_cv.wait(lock, [this] { return _stop_reclaimer || !_retired.empty(); });
+        std::vector<object_t*> retired;
+        retired.swap(_retired);
+        lock.unlock();
+        for (auto obj : retired) delete obj;
+        lock.lock();
+      }
     }
 
-    // takes owner-ship of factory (and will free using delete) - !!!!THREAD-UNSAFE!!!!
-    void update_factory(TFactory* new_factory) {
-      int objects_count = 0;
-      int version = 0;
+    void free_retired() {
+      std::vector<object_t*> retired;
       {
-        std::lock_guard<std::mutex> lock(_mutex);
-        objects_count = _impl->size();
-        version = _impl->version() + 1;
+        std::lock_guard<std::mutex> lock(_retired_mutex);
+        retired.swap(_retired);
       }
-      std::unique_ptr<impl_type> new_impl(new impl_type(new_factory, objects_count, version));
-      std::lock_guard<std::mutex> lock(_mutex);
-      _impl.swap(new_impl);
+      for (auto obj : retired) delete obj;
+    }
+
+    size_t thread_shard() const {
+      static std::atomic<size_t> next_index(0);
+      static thread_local const size_t index = next_index++;
+      return index % _shards_count;
     }
   };
 }}
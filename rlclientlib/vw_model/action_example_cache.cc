@@ -0,0 +1,68 @@
+#include "action_example_cache.h"
+
+// VW headers
+#include "example.h"
+#include "hash.h"
+
+#include <cstring>
+
+namespace reinforcement_learning {
+  action_example_cache::action_example_cache(size_t capacity)
+    : _capacity(capacity)
+  {}
+
+  action_example_cache::~action_example_cache()
+  {
+    for (auto& e : _entries) {
+      free_example(e.ex);
+    }
+  }
+
+  example* action_example_cache::get(const char* action, size_t len)
+  {
+    const auto it = _index.find(uniform_hash(action, len, 0));
+    if (it == _index.end()) {
+      return nullptr;
+    }
+
+    // the hash only narrows the lookup down, collisions are resolved against the action json itself
+    const auto& e = *it->second;
+    if (e.action.size() != len || memcmp(e.action.data(), action, len) != 0) {
+      return nullptr;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    return e.ex;
+  }
+
+  void action_example_cache::put(const char* action, size_t len, example* ex)
+  {
+    if (_capacity == 0) {
+      free_example(ex);
+      return;
+    }
+
+    const uint64_t hash = uniform_hash(action, len, 0);
+    const auto it = _index.find(hash);
+    if (it != _index.end()) {
+      // colliding action, the most recent one wins
+      free_example(it->second->ex);
+      _entries.erase(it->second);
+      _index.erase(it);
+    }
+    else if (_entries.size() >= _capacity) {
+      free_example(_entries.back().ex);
+      _index.erase(_entries.back().hash);
+      _entries.pop_back();
+    }
+
+    _entries.push_front({ hash, std::string(action, len), ex });
+    _index[hash] = _entries.begin();
+  }
+
+  size_t action_example_cache::size() const { return _entries.size(); }
+
+  size_t action_example_cache::capacity() const { return _capacity; }
+
+  void action_example_cache::free_example(example* ex) { VW::dealloc_examples(ex, 1); }
+}
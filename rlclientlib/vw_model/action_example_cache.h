@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+struct example;
+
+namespace reinforcement_learning {
+
+  // Bounded LRU cache of parsed action examples keyed by the content hash of the action json.
+  // Parsed features depend on the parse options of the vw instance that produced them, so a cache belongs to
+  // a single safe_vw and is dropped together with it when the pool moves to a new model version.
+  class action_example_cache {
+  public:
+    explicit action_example_cache(size_t capacity);
+    ~action_example_cache();
+
+    action_example_cache(const action_example_cache&) = delete;
+    action_example_cache& operator=(const action_example_cache&) = delete;
+
+    // Returns the cached example for the action json, or nullptr on a miss.
+    // The example is only valid until the next call to put().
+    example* get(const char* action, size_t len);
+
+    // Takes ownership of ex, evicting the least recently used entry when the cache is full.
+    void put(const char* action, size_t len, example* ex);
+
+    size_t size() const;
+    size_t capacity() const;
+
+  private:
+    struct entry {
+      uint64_t hash;
+      std::string action;
+      example* ex;
+    };
+    using entry_list = std::list<entry>;
+
+    static void free_example(example* ex);
+
+    const size_t _capacity;
+    // most recently used first
+    entry_list _entries;
+    std::unordered_map<uint64_t, entry_list::iterator> _index;
+  };
+}
@@ -60,6 +60,27 @@ namespace reinforcement_learning { namespace model_management {
     return error_code::not_supported;
   }
 
+  int pdf_model::choose_rank_batch(
+    const std::vector<uint64_t>& rnd_seeds,
+    const std::vector<const char*>& features,
+    std::vector<std::vector<int>>& action_ids,
+    std::vector<std::vector<float>>& action_pdfs,
+    std::string& model_version,
+    api_status* status) {
+    action_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    for (size_t i = 0; i < features.size(); ++i) {
+      RETURN_IF_FAIL(choose_rank(rnd_seeds[i], features[i], action_ids[i], action_pdfs[i], model_version, status));
+    }
+    return error_code::success;
+  }
+
+  // Not supported.
+  int pdf_model::request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<std::vector<std::string>>& slot_ids, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, api_status* status)
+  {
+    return error_code::not_supported;
+  }
+
   model_type_t pdf_model::model_type() const
   {
     return model_type_t::CB;
@@ -20,6 +20,8 @@ namespace reinforcement_learning { namespace model_management {
     int request_decision(const std::vector<const char*>& event_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     int request_multi_slot_decision(const char *event_id, const std::vector<std::string>& slot_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     int choose_rank_multistep(uint64_t rnd_seed, const char* features, const episode_history& history, std::vector<int>& action_ids, std::vector<float>& action_pdf, std::string& model_version, api_status* status = nullptr) override;
+    int choose_rank_batch(const std::vector<uint64_t>& rnd_seeds, const std::vector<const char*>& features, std::vector<std::vector<int>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
+    int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<std::vector<std::string>>& slot_ids, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     model_type_t model_type() const override;
   private:
     std::unique_ptr<safe_vw> _vw;
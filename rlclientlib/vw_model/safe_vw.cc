@@ -1,4 +1,5 @@
 #include "safe_vw.h"
+#include "err_constants.h"
 
 // VW headers
 #include "example.h"
@@ -7,6 +8,7 @@
 #include "v_array.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 namespace mm = reinforcement_learning::model_management;
@@ -14,6 +16,16 @@ namespace mm = reinforcement_learning::model_management;
 namespace reinforcement_learning {
   static const std::string SEED_TAG = "seed=";
 
+  // VW's json parser works in-situ, so const contexts have to be copied. The per-thread buffer only grows
+  // to the largest context seen by the thread and is reused afterwards, so steady state parsing does not allocate.
+  static char* copy_to_scratch(const char* context, size_t& context_len)
+  {
+    static thread_local std::vector<char> scratch;
+    context_len = strlen(context);
+    scratch.assign(context, context + context_len + 1);
+    return scratch.data();
+  }
+
   safe_vw::safe_vw(const std::shared_ptr<safe_vw>& master) : _master(master)
   {
     _vw = VW::seed_vw_model(_master->_vw, "", nullptr, nullptr);
@@ -46,6 +58,7 @@ namespace reinforcement_learning {
     for (auto&& ex : _example_pool) {
       VW::dealloc_examples(ex, 1);
     }
+    _action_cache.reset();
 
     // cleanup VW instance
     reset_source(*_vw, _vw->num_bits);
@@ -75,6 +88,62 @@ namespace reinforcement_learning {
 
   example& safe_vw::get_or_create_example_f(void* vw) { return *(((safe_vw*)vw)->get_or_create_example()); }
 
+  void safe_vw::enable_action_cache(size_t capacity)
+  {
+    _action_cache.reset(capacity > 0 ? new action_example_cache(capacity) : nullptr);
+  }
+
+  bool safe_vw::parse_with_action_cache(char* context, size_t context_len, v_array<example*>& examples)
+  {
+    if (utility::get_context_info(context, _context_info) != error_code::success || _context_info.actions.empty()) {
+      return false;
+    }
+
+    // resolve the actions first, the in-situ parse below overwrites the context
+    _action_examples.clear();
+    for (const auto& range : _context_info.actions) {
+      const char* action = context + range.first;
+      example* cached = _action_cache->get(action, range.second);
+      if (cached == nullptr) {
+        cached = parse_action(action, range.second);
+        _action_cache->put(action, range.second, cached);
+      }
+
+      example* ex = get_or_create_example();
+      VW::copy_example_data(_vw->audit, ex, cached);
+      _action_examples.push_back(ex);
+    }
+
+    // only the shared section is left to parse, the _multi array is blanked out in place
+    const size_t actions_begin = _context_info.actions.front().first;
+    const size_t actions_end = _context_info.actions.back().first + _context_info.actions.back().second;
+    memset(context + actions_begin, ' ', actions_end - actions_begin);
+
+    VW::read_line_json_s<false>(*_vw, examples, context, context_len + 1, get_or_create_example_f, this);
+
+    for (auto&& ex : _action_examples) {
+      examples.push_back(ex);
+    }
+    return true;
+  }
+
+  example* safe_vw::parse_action(const char* action, size_t action_len)
+  {
+    // an action object parses to the same features as a context without _multi
+    _action_scratch.assign(action, action + action_len);
+    _action_scratch.push_back('\0');
+
+    v_array<example*> examples;
+    examples.push_back(get_or_create_example());
+
+    VW::read_line_json_s<false>(*_vw, examples, _action_scratch.data(), action_len + 1, get_or_create_example_f, this);
+
+    for (size_t i = 1; i < examples.size(); ++i) {
+      _example_pool.emplace_back(examples[i]);
+    }
+    return examples[0];
+  }
+
   void safe_vw::parse_context_with_pdf(const char* context, std::vector<int>& actions, std::vector<float>& scores)
   {
     DecisionServiceInteraction interaction;
@@ -82,9 +151,10 @@ namespace reinforcement_learning {
     v_array<example*> examples;
     examples.push_back(get_or_create_example());
 
-    std::vector<char> line_vec(context, context + strlen(context) + 1);
+    size_t context_len;
+    char* line = copy_to_scratch(context, context_len);
 
-    VW::read_line_decision_service_json<false>(*_vw, examples, &line_vec[0], line_vec.size(), false, get_or_create_example_f, this, &interaction);
+    VW::read_line_decision_service_json<false>(*_vw, examples, line, context_len + 1, false, get_or_create_example_f, this, &interaction);
 
     // finalize example
     VW::setup_examples(*_vw, examples);
@@ -105,18 +175,27 @@ namespace reinforcement_learning {
 
   void safe_vw::rank(const char* context, std::vector<int>& actions, std::vector<float>& scores)
   {
-    v_array<example*> examples;
-    examples.push_back(get_or_create_example());
+    size_t context_len;
+    char* line = copy_to_scratch(context, context_len);
+    rank_in_situ(line, context_len, actions, scores);
+  }
 
-    std::vector<char> line_vec(context, context + strlen(context) + 1);
+  void safe_vw::rank_in_situ(char* context, size_t context_len, std::vector<int>& actions, std::vector<float>& scores)
+  {
+    auto& examples = _rank_examples;
+    examples.clear();
+    examples.push_back(get_or_create_example());
 
-    VW::read_line_json_s<false>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    if (!_action_cache || !parse_with_action_cache(context, context_len, examples)) {
+      VW::read_line_json_s<false>(*_vw, examples, context, context_len + 1, get_or_create_example_f, this);
+    }
 
     // finalize example
     VW::setup_examples(*_vw, examples);
 
     // TODO: refactor setup_examples/read_line_json_s to take in multi_ex
-    multi_ex examples2(examples.begin(), examples.end());
+    auto& examples2 = _rank_multi_ex;
+    examples2.assign(examples.begin(), examples.end());
 
     _vw->predict(examples2);
 
@@ -137,13 +216,18 @@ namespace reinforcement_learning {
   }
 
   void safe_vw::choose_continuous_action(const char* context, float& action, float& pdf_value)
+  {
+    size_t context_len;
+    char* line = copy_to_scratch(context, context_len);
+    choose_continuous_action_in_situ(line, context_len, action, pdf_value);
+  }
+
+  void safe_vw::choose_continuous_action_in_situ(char* context, size_t context_len, float& action, float& pdf_value)
   {
     v_array<example*> examples;
     examples.push_back(get_or_create_example());
 
-    std::vector<char> line_vec(context, context + strlen(context) + 1);
-
-    VW::read_line_json_s<false>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    VW::read_line_json_s<false>(*_vw, examples, context, context_len + 1, get_or_create_example_f, this);
 
     // finalize example
     VW::setup_examples(*_vw, examples);
@@ -160,13 +244,18 @@ namespace reinforcement_learning {
   }
 
   void safe_vw::rank_decisions(const std::vector<const char*>& event_ids, const char* context, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores)
+  {
+    size_t context_len;
+    char* line = copy_to_scratch(context, context_len);
+    rank_decisions_in_situ(event_ids, line, context_len, actions, scores);
+  }
+
+  void safe_vw::rank_decisions_in_situ(const std::vector<const char*>& event_ids, char* context, size_t context_len, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores)
   {
     v_array<example*> examples;
     examples.push_back(get_or_create_example());
 
-    std::vector<char> line_vec(context, context + strlen(context) + 1);
-
-    VW::read_line_json_s<false>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    VW::read_line_json_s<false>(*_vw, examples, context, context_len + 1, get_or_create_example_f, this);
 
     // In order to control the seed for the sampling of each slot the event id + app id is passed in as the seed using the example tag.
     for(int i = 0; i < event_ids.size(); i++)
@@ -206,13 +295,18 @@ namespace reinforcement_learning {
   }
 
   void safe_vw::rank_multi_slot_decisions(const char* event_id, const std::vector<std::string>& slot_ids, const char* context, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores)
+  {
+    size_t context_len;
+    char* line = copy_to_scratch(context, context_len);
+    rank_multi_slot_decisions_in_situ(event_id, slot_ids, line, context_len, actions, scores);
+  }
+
+  void safe_vw::rank_multi_slot_decisions_in_situ(const char* event_id, const std::vector<std::string>& slot_ids, char* context, size_t context_len, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores)
   {
     v_array<example*> examples;
     examples.push_back(get_or_create_example());
 
-    std::vector<char> line_vec(context, context + strlen(context) + 1);
-
-    VW::read_line_json_s<false>(*_vw, examples, &line_vec[0], line_vec.size(), get_or_create_example_f, this);
+    VW::read_line_json_s<false>(*_vw, examples, context, context_len + 1, get_or_create_example_f, this);
     // In order to control the seed for the sampling of each slot the event id + app id is passed in as the seed using the example tag.
     for(uint32_t i = 0; i < slot_ids.size(); i++)
     {
@@ -353,7 +447,27 @@ safe_vw_factory::safe_vw_factory(const model_management::model_data&& master_dat
   : _master_data(master_data), _command_line(command_line)
   {}
 
-safe_vw* safe_vw_factory::operator()() 
+void safe_vw_factory::share_weights()
+{
+  if (!_master) {
+    _master.reset(create_standalone());
+  }
+}
+
+void safe_vw_factory::set_action_cache_capacity(size_t capacity)
+{
+  _action_cache_capacity = capacity;
+}
+
+safe_vw* safe_vw_factory::operator()()
+{
+  // seed_vw_model shares the master's weights
+  std::unique_ptr<safe_vw> vw(_master ? new safe_vw(_master) : create_standalone());
+  vw->enable_action_cache(_action_cache_capacity);
+  return vw.release();
+}
+
+safe_vw* safe_vw_factory::create_standalone()
 {
     if (_master_data.data() && _command_line.size() > 0)
     {
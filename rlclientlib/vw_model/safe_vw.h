@@ -4,6 +4,8 @@
 #include <memory>
 #include "vw.h"
 #include "model_mgmt.h"
+#include "action_example_cache.h"
+#include "utility/context_helper.h"
 
 namespace reinforcement_learning {
 
@@ -13,9 +15,22 @@ namespace reinforcement_learning {
     vw* _vw;
     std::vector<example*> _example_pool;
 
+    // parsed action examples reused across rank calls, only set when the cache is enabled
+    std::unique_ptr<action_example_cache> _action_cache;
+    utility::ContextInfo _context_info;
+    std::vector<example*> _action_examples;
+    std::vector<char> _action_scratch;
+
+    // example lists reused by rank() so that steady state ranking does not allocate
+    v_array<example*> _rank_examples;
+    multi_ex _rank_multi_ex;
+
     example* get_or_create_example();
     static example& get_or_create_example_f(void* vw);
 
+    bool parse_with_action_cache(char* context, size_t context_len, v_array<example*>& examples);
+    example* parse_action(const char* action, size_t action_len);
+
   public:
     safe_vw(const std::shared_ptr<safe_vw>& master);
     safe_vw(const char* model_data, size_t len, const std::string& vw_parameters);
@@ -24,6 +39,11 @@ namespace reinforcement_learning {
 
     ~safe_vw();
 
+    // Cache up to capacity parsed action examples (0 disables the cache). Actions seen before are copied from
+    // the cache on rank() and only the shared section of the context is parsed.
+    void enable_action_cache(size_t capacity);
+
+    // The const context overloads copy the context into a reusable per-thread scratch buffer before parsing.
     void parse_context_with_pdf(const char* context, std::vector<int>& actions, std::vector<float>& scores);
     void rank(const char* context, std::vector<int>& actions, std::vector<float>& scores);
     void choose_continuous_action(const char* context, float& action, float& pdf_value);
@@ -32,6 +52,13 @@ namespace reinforcement_learning {
     // Used for slates
     void rank_multi_slot_decisions(const char* event_id, const std::vector<std::string>& slot_ids, const char* context, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores);
 
+    // In-situ variants: the null terminated context (context_len excludes the terminator) is parsed in place
+    // without any copy, its content is undefined after the call.
+    void rank_in_situ(char* context, size_t context_len, std::vector<int>& actions, std::vector<float>& scores);
+    void choose_continuous_action_in_situ(char* context, size_t context_len, float& action, float& pdf_value);
+    void rank_decisions_in_situ(const std::vector<const char*>& event_ids, char* context, size_t context_len, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores);
+    void rank_multi_slot_decisions_in_situ(const char* event_id, const std::vector<std::string>& slot_ids, char* context, size_t context_len, std::vector<std::vector<uint32_t>>& actions, std::vector<std::vector<float>>& scores);
+
     const char* id() const;
 
     bool is_compatible(const std::string& args) const;
@@ -46,6 +73,11 @@ namespace reinforcement_learning {
   class safe_vw_factory {
     model_management::model_data _master_data;
     std::string _command_line;
+    // when set, every instance is seeded from this master and shares its (read-only) weights
+    std::shared_ptr<safe_vw> _master;
+    size_t _action_cache_capacity = 0;
+
+    safe_vw* create_standalone();
 
   public:
     // model_data is copied and stored in the factory object.
@@ -55,6 +87,13 @@ namespace reinforcement_learning {
     safe_vw_factory(const model_management::model_data& master_data, const std::string& command_line);
     safe_vw_factory(const model_management::model_data&& master_data, const std::string& command_line);
 
+    // Load the model once into a master instance. Objects created afterwards only own their example and
+    // scratch state, so the pool size no longer multiplies the model memory.
+    void share_weights();
+
+    // Capacity of the parsed action cache of every object created afterwards (0 disables it).
+    void set_action_cache_capacity(size_t capacity);
+
     safe_vw* operator()();
   };
 }
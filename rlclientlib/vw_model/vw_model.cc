@@ -10,10 +10,23 @@ namespace reinforcement_learning { namespace model_management {
 
   vw_model::vw_model(i_trace* trace_logger, const utility::configuration& config)
     : _initial_command_line(config.get(name::MODEL_VW_INITIAL_COMMAND_LINE, "--cb_explore_adf --json --quiet --epsilon 0.0 --first_only --id N/A"))
-    , _vw_pool(new safe_vw_factory(_initial_command_line), config.get_int(name::VW_POOL_INIT_SIZE, value::DEFAULT_VW_POOL_INIT_SIZE))
+    , _shared_weights(config.get_bool(name::VW_POOL_SHARED_WEIGHTS, value::DEFAULT_VW_POOL_SHARED_WEIGHTS))
+    , _action_cache_capacity(config.get_int(name::VW_ACTION_CACHE_CAPACITY, value::DEFAULT_VW_ACTION_CACHE_CAPACITY))
+    , _vw_pool(make_factory(new safe_vw_factory(_initial_command_line)), config.get_int(name::VW_POOL_INIT_SIZE, value::DEFAULT_VW_POOL_INIT_SIZE))
     , _trace_logger(trace_logger) {
   }
 
+  safe_vw_factory* vw_model::make_factory(safe_vw_factory* factory) const {
+    std::unique_ptr<safe_vw_factory> guard(factory);
+    if (_action_cache_capacity > 0) {
+      guard->set_action_cache_capacity(_action_cache_capacity);
+    }
+    if (_shared_weights) {
+      guard->share_weights();
+    }
+    return guard.release();
+  }
+
   int vw_model::update(const model_data& data, bool& model_ready, api_status* status) {
     try {
       TRACE_INFO(_trace_logger, utility::concat("Received new model data. With size ", data.data_sz()));
@@ -35,7 +48,7 @@ namespace reinforcement_learning { namespace model_management {
         std::unique_ptr<safe_vw> test_vw((*factory)());
         if (test_vw->is_compatible(_initial_command_line)) {
           // safe_vw_factory will create a copy of the model data to use for vw object construction.
-          _vw_pool.update_factory(factory.release());
+          _vw_pool.update_factory(make_factory(factory.release()));
           model_ready = true;
         }
         else {
@@ -151,6 +164,65 @@ namespace reinforcement_learning { namespace model_management {
     }
   }
 
+  int vw_model::choose_rank_batch(
+    const std::vector<uint64_t>& rnd_seeds,
+    const std::vector<const char*>& features,
+    std::vector<std::vector<int>>& action_ids,
+    std::vector<std::vector<float>>& action_pdfs,
+    std::string& model_version,
+    api_status* status) {
+    try {
+      // A single pooled instance serves the whole batch
+      pooled_vw vw(_vw_pool, _vw_pool.get_or_create());
+
+      action_ids.resize(features.size());
+      action_pdfs.resize(features.size());
+      for (size_t i = 0; i < features.size(); ++i) {
+        vw->rank(features[i], action_ids[i], action_pdfs[i]);
+      }
+
+      model_version = vw->id();
+
+      return error_code::success;
+    }
+    catch ( const std::exception& e) {
+      RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << e.what();
+    }
+    catch ( ... ) {
+      RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << "Unknown error";
+    }
+  }
+
+  int vw_model::request_multi_slot_decision_batch(
+    const std::vector<const char*>& event_ids,
+    const std::vector<std::vector<std::string>>& slot_ids,
+    const std::vector<const char*>& features,
+    std::vector<std::vector<std::vector<uint32_t>>>& actions_ids,
+    std::vector<std::vector<std::vector<float>>>& action_pdfs,
+    std::string& model_version,
+    api_status* status) {
+    try {
+      // A single pooled instance serves the whole batch
+      pooled_vw vw(_vw_pool, _vw_pool.get_or_create());
+
+      actions_ids.resize(features.size());
+      action_pdfs.resize(features.size());
+      for (size_t i = 0; i < features.size(); ++i) {
+        vw->rank_multi_slot_decisions(event_ids[i], slot_ids[i], features[i], actions_ids[i], action_pdfs[i]);
+      }
+
+      model_version = vw->id();
+
+      return error_code::success;
+    }
+    catch ( const std::exception& e) {
+      RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << e.what();
+    }
+    catch ( ... ) {
+      RETURN_ERROR_LS(_trace_logger, status, model_rank_error) << "Unknown error";
+    }
+  }
+
   model_type_t vw_model::model_type() const
   {
     return safe_vw::get_model_type(_initial_command_line);
@@ -22,10 +22,16 @@ namespace reinforcement_learning { namespace model_management {
     int request_decision(const std::vector<const char*>& event_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     int request_multi_slot_decision(const char *event_id, const std::vector<std::string>& slot_ids, const char* features, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     int choose_rank_multistep(uint64_t rnd_seed, const char *features, const episode_history &history, std::vector<int> &action_ids, std::vector<float> &action_pdf, std::string &model_version, api_status *status = nullptr) override;
+    int choose_rank_batch(const std::vector<uint64_t>& rnd_seeds, const std::vector<const char*>& features, std::vector<std::vector<int>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
+    int request_multi_slot_decision_batch(const std::vector<const char*>& event_ids, const std::vector<std::vector<std::string>>& slot_ids, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, api_status* status = nullptr) override;
     model_type_t model_type() const override;
 
   private:
+    safe_vw_factory* make_factory(safe_vw_factory* factory) const;
+
     const std::string _initial_command_line;
+    const bool _shared_weights;
+    const int _action_cache_capacity;
 	const std::string _upgrade_to_CCB_vw_commandline_options{ "--ccb_explore_adf --json --quiet" };
 
     using vw_ptr = std::shared_ptr<safe_vw>;
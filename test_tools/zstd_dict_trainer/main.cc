@@ -0,0 +1,212 @@
+// Trains a zstd dictionary for the interaction payloads from logs written by the file sender (interaction.file_name).
+// The client compresses with it when zstd.dictionary_file is set, the external parser needs it through
+// --zstd_dictionary to decompress these events.
+#include <boost/program_options.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <flatbuffers/flatbuffers.h>
+
+#define ZDICT_STATIC_LINKING_ONLY
+#include "zdict.h"
+#include "zstd.h"
+
+#include "../../rlclientlib/logger/preamble.h"
+#include "../../rlclientlib/logger/message_type.h"
+#include "../../rlclientlib/generated/v2/Event_generated.h"
+#include "../../rlclientlib/generated/v2/Metadata_generated.h"
+
+// namespace aliases
+namespace po = boost::program_options;
+namespace rlog = reinforcement_learning::logger;
+namespace v2 = reinforcement_learning::messages::flatbuff::v2;
+////
+
+// Keeps a uniform sample of at most capacity payloads out of all the ones added (reservoir sampling)
+class payload_sampler {
+public:
+  payload_sampler(size_t capacity, unsigned int seed) : _capacity(capacity), _rng(seed) {}
+
+  void add(const uint8_t* data, size_t size) {
+    ++_seen;
+    if (_samples.size() < _capacity) {
+      _samples.emplace_back(data, data + size);
+      return;
+    }
+    std::uniform_int_distribution<size_t> dist(0, _seen - 1);
+    const size_t slot = dist(_rng);
+    if (slot < _capacity) {
+      _samples[slot].assign(data, data + size);
+    }
+  }
+
+  size_t seen() const { return _seen; }
+  const std::vector<std::vector<uint8_t>>& samples() const { return _samples; }
+
+private:
+  const size_t _capacity;
+  std::mt19937 _rng;
+  size_t _seen = 0;
+  std::vector<std::vector<uint8_t>> _samples;
+};
+
+bool decompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out) {
+  const auto content_size = ZSTD_getFrameContentSize(data, size);
+  if (content_size == ZSTD_CONTENTSIZE_ERROR || content_size == ZSTD_CONTENTSIZE_UNKNOWN) {
+    return false;
+  }
+  out.resize(static_cast<size_t>(content_size));
+  const size_t res = ZSTD_decompress(out.data(), out.size(), data, size);
+  if (ZSTD_isError(res)) {
+    return false;
+  }
+  out.resize(res);
+  return true;
+}
+
+void sample_batch(const v2::EventBatch& batch, payload_sampler& sampler, size_t& skipped) {
+  if (batch.compressed_batch() != nullptr) {
+    std::vector<uint8_t> inner;
+    if (!decompress(batch.compressed_batch()->data(), batch.compressed_batch()->size(), inner)) {
+      ++skipped;
+      return;
+    }
+    sample_batch(*flatbuffers::GetRoot<v2::EventBatch>(inner.data()), sampler, skipped);
+    return;
+  }
+  if (batch.events() == nullptr) return;
+
+  std::vector<uint8_t> payload;
+  for (const auto* serialized : *batch.events()) {
+    if (serialized->payload() == nullptr) continue;
+    const auto* evt = flatbuffers::GetRoot<v2::Event>(serialized->payload()->data());
+    const auto* meta = evt->meta();
+    if (meta == nullptr || evt->payload() == nullptr || meta->payload_type() == v2::PayloadType_Outcome) continue;
+
+    // payloads compressed without a dictionary are sampled as the client serialized them
+    if (meta->encoding() == v2::EventEncoding_Zstd) {
+      if (meta->dictionary_id() != 0 || !decompress(evt->payload()->data(), evt->payload()->size(), payload)) {
+        ++skipped;
+        continue;
+      }
+      sampler.add(payload.data(), payload.size());
+    }
+    else {
+      sampler.add(evt->payload()->data(), evt->payload()->size());
+    }
+  }
+}
+
+bool sample_file(const std::string& file, payload_sampler& sampler, size_t& skipped) {
+  std::ifstream in(file, std::ios::binary);
+  if (!in) {
+    std::cerr << "Unable to open file: " << file << std::endl;
+    return false;
+  }
+
+  std::vector<uint8_t> msg;
+  uint8_t raw_preamble[rlog::preamble::size()];
+  while (in.read(reinterpret_cast<char*>(raw_preamble), rlog::preamble::size())) {
+    rlog::preamble p;
+    p.read_from_bytes(raw_preamble, rlog::preamble::size());
+    msg.resize(p.msg_size);
+    if (!in.read(reinterpret_cast<char*>(msg.data()), p.msg_size)) {
+      std::cerr << "Truncated message in file: " << file << std::endl;
+      return false;
+    }
+    if (p.msg_type != rlog::message_type::fb_generic_event_collection) continue;
+
+    flatbuffers::Verifier verifier(msg.data(), msg.size());
+    if (!v2::VerifyEventBatchBuffer(verifier)) {
+      ++skipped;
+      continue;
+    }
+    sample_batch(*v2::GetEventBatch(msg.data()), sampler, skipped);
+  }
+  return true;
+}
+
+po::variables_map process_cmd_line(const int argc, char** argv, po::options_description& desc) {
+  desc.add_options()
+    ("help", "produce help message")
+    ("input,i", po::value<std::vector<std::string>>()->multitoken()->required(), "File sender logs (protocol v2) to sample")
+    ("output,o", po::value<std::string>()->required(), "Dictionary file written")
+    ("dict-size", po::value<size_t>()->default_value(110 * 1024), "Maximum dictionary size in bytes")
+    ("max-samples", po::value<size_t>()->default_value(100000), "Payloads sampled uniformly across the inputs")
+    ("dict-id", po::value<unsigned int>()->default_value(0), "Dictionary id recorded in the events, random when 0")
+    ("level", po::value<int>()->default_value(0), "Compression level the dictionary is tuned for, zstd default when 0")
+    ("seed", po::value<unsigned int>()->default_value(0), "Sampling seed")
+    ;
+
+  po::variables_map vm;
+  store(parse_command_line(argc, argv, desc), vm);
+  if (vm.count("help") == 0) {
+    notify(vm);
+  }
+  return vm;
+}
+
+int main(int argc, char** argv) {
+  try {
+    po::options_description desc("Options");
+    const auto vm = process_cmd_line(argc, argv, desc);
+    if (vm.count("help") > 0) {
+      std::cout << desc << std::endl;
+      return 0;
+    }
+
+    payload_sampler sampler(vm["max-samples"].as<size_t>(), vm["seed"].as<unsigned int>());
+    size_t skipped = 0;
+    for (const auto& file : vm["input"].as<std::vector<std::string>>()) {
+      if (!sample_file(file, sampler, skipped)) return -1;
+    }
+
+    const auto& samples = sampler.samples();
+    std::cout << "payloads: " << sampler.seen() << ", sampled: " << samples.size() << ", skipped: " << skipped << std::endl;
+    if (samples.empty()) {
+      std::cerr << "No interaction payload to train on" << std::endl;
+      return -1;
+    }
+
+    std::vector<uint8_t> content;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+      content.insert(content.end(), sample.begin(), sample.end());
+      sizes.push_back(sample.size());
+    }
+
+    ZDICT_fastCover_params_t params = {};
+    params.d = 8;
+    params.steps = 4;
+    params.zParams.compressionLevel = vm["level"].as<int>();
+    params.zParams.dictID = vm["dict-id"].as<unsigned int>();
+
+    std::vector<uint8_t> dictionary(vm["dict-size"].as<size_t>());
+    const size_t dictionary_size = ZDICT_optimizeTrainFromBuffer_fastCover(dictionary.data(), dictionary.size(),
+      content.data(), sizes.data(), static_cast<unsigned int>(sizes.size()), &params);
+    if (ZDICT_isError(dictionary_size)) {
+      std::cerr << "Training failed: " << ZDICT_getErrorName(dictionary_size) << std::endl;
+      return -1;
+    }
+
+    std::ofstream out(vm["output"].as<std::string>(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(dictionary.data()), dictionary_size);
+    if (!out) {
+      std::cerr << "Unable to write file: " << vm["output"].as<std::string>() << std::endl;
+      return -1;
+    }
+    std::cout << "dictionary: " << dictionary_size << " bytes, id "
+      << ZDICT_getDictID(dictionary.data(), dictionary_size) << std::endl;
+  }
+  catch (const std::exception& e) {
+    std::cout << "Error: " << e.what() << std::endl;
+    return -1;
+  }
+  return 0;
+}
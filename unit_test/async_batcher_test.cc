@@ -3,12 +3,17 @@
 #   define BOOST_TEST_MODULE Main
 #endif
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <set>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "data_buffer.h"
 #include "err_constants.h"
 #include "serialization/json_serializer.h"
 #include "logger/async_batcher.h"
+#include "logger/sharded_async_batcher.h"
 #include "sender.h"
 #include "vw_math.h"
 
@@ -22,10 +27,12 @@ public:
 
   int send(const uint16_t msg_type, const buffer& db, api_status* status = nullptr) override {
     items.emplace_back(reinterpret_cast<char*>(db->body_begin()));
+    ++sent;
     return error_code::success;
   };
   int init(api_status* status) override { return error_code::success; };
   i_sender* sender;
+  std::atomic<size_t> sent{ 0 }; // batches in items, safe to poll from the test thread
 };
 
 class test_undroppable_event : public event {
@@ -75,6 +82,19 @@ public:
   std::string get_event_id() { return _seed_id; }
 };
 
+// event whose size estimate is half of what it takes in a batch
+class underestimated_event : public event {
+public:
+  underestimated_event() {}
+  underestimated_event(const std::string& id) : event(id.c_str(), timestamp{}) {}
+
+  underestimated_event(underestimated_event&& other) = default;
+  underestimated_event& operator=(underestimated_event&& other) = default;
+
+  bool try_drop(float drop_prob, int _drop_pass) override { return false; }
+  std::string get_event_id() { return _seed_id; }
+};
+
 namespace reinforcement_learning { namespace logger {
   template <>
   struct json_event_serializer<test_droppable_event> {
@@ -110,8 +130,37 @@ namespace reinforcement_learning { namespace logger {
 
     static size_t size_estimate(const config_drop_event& evt) { return 1; }
   };
+
+  template <>
+  struct json_event_serializer<underestimated_event> {
+    using serializer_t = json_event_serializer<underestimated_event>;
+
+    static int serialize(underestimated_event& evt, std::ostream& out, api_status* status) {
+      out << evt.get_event_id();
+      return error_code::success;
+    }
+
+    static size_t size_estimate(const underestimated_event& evt) {
+      return const_cast<underestimated_event&>(evt).get_event_id().size() / 2;
+    }
+  };
 }}
 
+// body capacity of the buffers given to capacity_probe_serializer, before the serializer touches them
+std::vector<size_t> batch_capacities;
+
+template <typename TEvent>
+struct capacity_probe_serializer : logger::json_collection_serializer<TEvent> {
+  capacity_probe_serializer(utility::data_buffer& buffer, const char* content_encoding, int& /*state*/,
+    logger::batch_compressor* /*compressor*/, const logger::compression_level_controller* /*level_controller*/)
+    : logger::json_collection_serializer<TEvent>(record(buffer), content_encoding) {}
+
+  static utility::data_buffer& record(utility::data_buffer& buffer) {
+    batch_capacities.push_back(buffer.body_capacity());
+    return buffer;
+  }
+};
+
 void expect_no_error(const api_status& s, void* cntxt) {
   BOOST_ASSERT(s.get_error_code() == error_code::success);
   BOOST_FAIL("Should not get background error notifications");
@@ -181,6 +230,70 @@ BOOST_AUTO_TEST_CASE(flush_batches) {
   BOOST_CHECK_EQUAL(items[1], expected_batch_1);
 }
 
+//test that a batch is sent as soon as the high water mark is reached, without waiting for the timer
+BOOST_AUTO_TEST_CASE(flush_threshold) {
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_high_water_mark = 3; //bytes
+  config.send_batch_interval_ms = 100000;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_undroppable_event>
+      (s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr); // Allow periodic_background_proc to start waiting
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  batcher->append(test_undroppable_event("a"));
+  batcher->append(test_undroppable_event("b"));
+  batcher->append(test_undroppable_event("c")); //the queued bytes reach the flush threshold
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (s->sent < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  //the batches stay within the high water mark, "a" and "b" reach it and "c" starts the next one
+  BOOST_REQUIRE_EQUAL(s->sent.load(), 2);
+  BOOST_CHECK_EQUAL(items[0], "a\nb\n");
+  BOOST_CHECK_EQUAL(items[1], "c\n");
+  delete batcher;
+  BOOST_CHECK_EQUAL(items.size(), 2);
+}
+
+//test that by default the batcher flushes early only once the high water mark is queued, not before
+BOOST_AUTO_TEST_CASE(flush_threshold_default_is_high_water_mark) {
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_high_water_mark = 6; //bytes
+  config.send_queue_max_capacity = 8;
+  config.send_batch_interval_ms = 100000;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_undroppable_event>
+      (s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr); // Allow periodic_background_proc to start waiting
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  for (const char* id : { "a", "b", "c", "d" }) {
+    batcher->append(test_undroppable_event(id)); //half of the queue capacity, below the high water mark
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  BOOST_CHECK_EQUAL(s->sent.load(), 0);
+
+  batcher->append(test_undroppable_event("e"));
+  batcher->append(test_undroppable_event("f")); //the queued bytes reach the high water mark
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (s->sent < 1 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_GE(s->sent.load(), 1);
+  delete batcher;
+
+  std::string sent;
+  for (const auto& item : items) sent += item;
+  BOOST_CHECK_EQUAL(sent, "a\nb\nc\nd\ne\nf\n");
+}
+
 //test that the batcher flushes everything before deletion
 BOOST_AUTO_TEST_CASE(flush_after_deletion) {
   std::vector<std::string> items;
@@ -236,6 +349,33 @@ BOOST_AUTO_TEST_CASE(queue_overflow_do_not_drop_event) {
   BOOST_CHECK_EQUAL(expected_output, actual_output);
 }
 
+//test that DROP mode drops the events as they come in once the queue gets close to full
+BOOST_AUTO_TEST_CASE(queue_drop_mode_admission)
+{
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_high_water_mark = 262143;
+  config.send_batch_interval_ms = 100000;
+  config.send_queue_max_capacity = 10;
+  config.send_queue_flush_fraction = 0.f;
+  config.queue_mode = queue_mode_enum::DROP;
+  int dummy = 0;
+  auto batcher = new logger::async_batcher<test_droppable_event>(s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // every event takes 1 byte: they are all kept up to 80% of the queue, the next ones are sampled and
+  // test_droppable_event always loses the draw
+  for (int i = 0; i < 20; ++i) { batcher->append(test_droppable_event(std::to_string(i))); }
+  delete batcher;
+
+  BOOST_REQUIRE_EQUAL(items.size(), 1);
+  BOOST_CHECK_EQUAL(items[0], "0\n1\n2\n3\n4\n5\n6\n7\n8\n");
+}
+
 BOOST_AUTO_TEST_CASE(queue_config_drop_rate_test)
 {
   std::vector<std::string> items;
@@ -268,3 +408,74 @@ BOOST_AUTO_TEST_CASE(queue_config_drop_rate_test)
   BOOST_REQUIRE(!items.empty());
   BOOST_CHECK_EQUAL(items[0], "0.00\n0.69\n0.70\n");
 }
+
+//test that the shards of a sharded batcher all ship their events through the shared sender
+BOOST_AUTO_TEST_CASE(sharded_batcher_test)
+{
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_high_water_mark = 16;
+  config.send_batch_interval_ms = 10;
+  config.batcher_shards = 4;
+  int dummy = 0;
+  auto batcher = logger::create_sharded_batcher<test_undroppable_event>(s, config,
+    [&](logger::i_message_sender* shard_sender, const utility::async_batcher_config& shard_config) {
+      return new logger::async_batcher<test_undroppable_event>(shard_sender, watchdog, dummy, &error_fn, shard_config);
+    });
+  BOOST_REQUIRE_EQUAL(batcher->init(nullptr), error_code::success);
+
+  const int threads_count = 4;
+  const int n = 100;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < threads_count; ++t) {
+    threads.emplace_back([batcher, t]() {
+      for (int i = 0; i < n; ++i) {
+        batcher->append(test_undroppable_event(std::to_string(t * n + i)));
+      }
+    });
+  }
+  for (auto& thread : threads) { thread.join(); }
+  delete batcher;
+
+  std::set<std::string> ids;
+  for (const auto& item : items) {
+    std::istringstream batch(item);
+    std::string id;
+    while (std::getline(batch, id)) { ids.insert(id); }
+  }
+  BOOST_CHECK_EQUAL(ids.size(), threads_count * n);
+}
+
+//test that the batch buffers are reserved from the size estimates of their events, scaled by what the previous batches took
+BOOST_AUTO_TEST_CASE(batch_buffer_reserved_from_estimates)
+{
+  std::vector<std::string> items;
+  auto s = new message_sender(items);
+  error_callback_fn error_fn(expect_no_error, nullptr);
+  utility::watchdog watchdog(nullptr);
+  utility::async_batcher_config config;
+  config.send_batch_interval_ms = 100000;
+  int dummy = 0;
+  batch_capacities.clear();
+  auto batcher = new logger::async_batcher<underestimated_event, capacity_probe_serializer>(s, watchdog, dummy, &error_fn, config);
+  batcher->init(nullptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  // 40 bytes per event, the json batches stay within the first growth of their stream buffer
+  const int n = 40;
+  const std::string padding(36, 'x');
+  for (int i = 0; i < n; ++i) { batcher->append(underestimated_event(padding + std::to_string(1000 + i))); }
+  batcher->run_iteration(nullptr);
+  for (int i = 0; i < n; ++i) { batcher->append(underestimated_event(padding + std::to_string(2000 + i))); }
+  delete batcher;
+
+  BOOST_REQUIRE_EQUAL(items.size(), 2);
+  BOOST_REQUIRE_EQUAL(batch_capacities.size(), 2);
+  BOOST_CHECK_GE(batch_capacities[0], static_cast<size_t>(n * 20 * constants::INITIAL_BATCH_OVERHEAD));
+  // the events take twice their estimate, which the second batch is reserved for
+  BOOST_CHECK_GT(batch_capacities[1], batch_capacities[0]);
+  BOOST_CHECK_GE(batch_capacities[1], items[1].size());
+}
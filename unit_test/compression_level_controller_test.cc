@@ -0,0 +1,59 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include "logger/compression_level_controller.h"
+#include <boost/test/unit_test.hpp>
+
+using namespace reinforcement_learning::logger;
+
+BOOST_AUTO_TEST_CASE(compression_level_raised_under_queue_pressure) {
+  compression_level_controller controller(3, 1, 6);
+  BOOST_CHECK_EQUAL(controller.level(), 3);
+
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.1f, 0.3f), 4);
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.1f, 0.3f), 5);
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.1f, 0.3f), 6);
+  // capped at max_level
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.1f, 0.3f), 6);
+}
+
+BOOST_AUTO_TEST_CASE(compression_level_not_raised_when_payload_does_not_compress) {
+  compression_level_controller controller(3, 1, 6);
+  for (int i = 0; i < 20; ++i) {
+    controller.update(0.2f, 0.1f, 1.f);
+  }
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.1f, 1.f), 3);
+  BOOST_CHECK_GT(controller.ratio(), 0.9f);
+}
+
+BOOST_AUTO_TEST_CASE(compression_level_lowered_when_busy) {
+  compression_level_controller controller(3, 2, 6);
+
+  // busy wins over queue pressure
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.9f, 0.3f), 2);
+  // floored at min_level
+  BOOST_CHECK_EQUAL(controller.update(0.8f, 0.9f, 0.3f), 2);
+}
+
+BOOST_AUTO_TEST_CASE(compression_level_returns_to_configured_level) {
+  compression_level_controller controller(3, 1, 6);
+  controller.update(0.8f, 0.1f, 0.3f);
+  controller.update(0.8f, 0.1f, 0.3f);
+  BOOST_CHECK_EQUAL(controller.level(), 5);
+
+  // in between thresholds the level is kept
+  BOOST_CHECK_EQUAL(controller.update(0.3f, 0.1f, 0.3f), 5);
+  BOOST_CHECK_EQUAL(controller.update(0.f, 0.f, 0.3f), 4);
+  BOOST_CHECK_EQUAL(controller.update(0.f, 0.f, 0.3f), 3);
+  BOOST_CHECK_EQUAL(controller.update(0.f, 0.f, 0.3f), 3);
+}
+
+BOOST_AUTO_TEST_CASE(compression_level_configured_out_of_bounds) {
+  compression_level_controller controller(12, 1, 6);
+  BOOST_CHECK_EQUAL(controller.level(), 6);
+
+  compression_level_controller invalid_bounds(3, 0, -1);
+  BOOST_CHECK_EQUAL(invalid_bounds.level(), 1);
+}
@@ -5,6 +5,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include "dedup_internals.h"
+#include "zdict.h"
+
+#include <string>
+#include <vector>
 
 namespace r = reinforcement_learning;
 namespace err = reinforcement_learning::error_code;
@@ -269,6 +273,42 @@ BOOST_AUTO_TEST_CASE(dedup_state_and_bad_state)
   BOOST_CHECK_EQUAL(0, state.get_dict().get_object(id).size());
 }
 
+BOOST_AUTO_TEST_CASE(compression_with_dictionary)
+{
+  std::vector<char> samples;
+  std::vector<size_t> sample_sizes;
+  for(int i = 0; i < 2000; ++i) {
+    const auto sample = R"({"GUser":{"id":"u)" + std::to_string(i % 97) + R"(","major":"eng"},"_multi":[{"TAction":{"topic":"sports)"
+      + std::to_string(i % 13) + R"("}},{"TAction":{"topic":"politics"}}]})";
+    samples.insert(samples.end(), sample.begin(), sample.end());
+    sample_sizes.push_back(sample.size());
+  }
+  std::vector<char> dictionary(16 * 1024);
+  const auto dictionary_size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), samples.data(), sample_sizes.data(), (unsigned)sample_sizes.size());
+  BOOST_REQUIRE(!ZDICT_isError(dictionary_size));
+
+  r::zstd_compressor plain(1);
+  r::zstd_compressor compressor(1);
+  BOOST_CHECK_EQUAL(err::compression_error, compressor.load_dictionary("abc", 3, nullptr));
+  BOOST_CHECK_EQUAL(0, compressor.get_dictionary_id());
+  BOOST_CHECK_EQUAL(err::success, compressor.load_dictionary(dictionary.data(), dictionary_size, nullptr));
+  BOOST_CHECK_NE(0, compressor.get_dictionary_id());
+
+  const std::string input(samples.data(), sample_sizes[0]);
+  auto with_dictionary = str_to_buff(input.c_str());
+  auto without_dictionary = str_to_buff(input.c_str());
+  BOOST_CHECK_EQUAL(err::success, compressor.compress(with_dictionary, nullptr));
+  BOOST_CHECK_EQUAL(err::success, plain.compress(without_dictionary, nullptr));
+  BOOST_CHECK_LT(with_dictionary.size(), without_dictionary.size());
+  BOOST_CHECK_EQUAL(compressor.get_dictionary_id(), ZSTD_getDictID_fromFrame(with_dictionary.data(), with_dictionary.size()));
+
+  BOOST_CHECK_EQUAL(err::success, compressor.decompress(with_dictionary, nullptr));
+  BOOST_CHECK_EQUAL(input, (char*)with_dictionary.data());
+  // frames compressed without the dictionary still decompress
+  BOOST_CHECK_EQUAL(err::success, compressor.decompress(without_dictionary, nullptr));
+  BOOST_CHECK_EQUAL(input, (char*)without_dictionary.data());
+}
+
 BOOST_AUTO_TEST_CASE(dedup_enable_compression)
 {
   r::utility::configuration c;
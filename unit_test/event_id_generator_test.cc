@@ -0,0 +1,91 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "event_id_generators.h"
+
+using namespace reinforcement_learning;
+
+namespace {
+  bool is_uuid_format(const char* id) {
+    if (strlen(id) != 36) return false;
+    for (size_t i = 0; i < 36; ++i) {
+      const bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+      if (dash != (id[i] == '-')) return false;
+      if (!dash && !strchr("0123456789abcdef", id[i])) return false;
+    }
+    return true;
+  }
+}
+
+BOOST_AUTO_TEST_CASE(format_uuid_test)
+{
+  char buffer[EVENT_ID_MAX_SIZE];
+  BOOST_CHECK_EQUAL(format_uuid(0x0123456789abcdefULL, 0xfedcba9876543210ULL, buffer), 36);
+  BOOST_CHECK_EQUAL(std::string(buffer), "01234567-89ab-cdef-fedc-ba9876543210");
+}
+
+BOOST_AUTO_TEST_CASE(uuid4_event_id_generator_test)
+{
+  uuid4_event_id_generator generator;
+  std::set<std::string> ids;
+  char buffer[EVENT_ID_MAX_SIZE];
+  for (int i = 0; i < 1000; ++i) {
+    BOOST_CHECK_EQUAL(generator.generate(buffer), 36);
+    BOOST_CHECK(is_uuid_format(buffer));
+    // version and variant nibbles
+    BOOST_CHECK_EQUAL(buffer[14], '4');
+    BOOST_CHECK(strchr("89ab", buffer[19]) != nullptr);
+    ids.insert(buffer);
+  }
+  BOOST_CHECK_EQUAL(ids.size(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(counter_event_id_generator_test)
+{
+  counter_event_id_generator generator(0x42);
+  char buffer[EVENT_ID_MAX_SIZE];
+  generator.generate(buffer);
+  BOOST_CHECK_EQUAL(std::string(buffer), "00000000-0000-0042-0000-000000000000");
+  generator.generate(buffer);
+  BOOST_CHECK_EQUAL(std::string(buffer), "00000000-0000-0042-0000-000000000001");
+}
+
+BOOST_AUTO_TEST_CASE(event_id_generators_are_unique_across_threads)
+{
+  uuid4_event_id_generator uuid4;
+  counter_event_id_generator counter;
+  std::vector<i_event_id_generator*> generators = { &uuid4, &counter };
+
+  for (auto generator : generators) {
+    const int thread_count = 4;
+    const int ids_per_thread = 1000;
+    std::vector<std::vector<std::string>> ids(thread_count);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&, t]() {
+        char buffer[EVENT_ID_MAX_SIZE];
+        for (int i = 0; i < ids_per_thread; ++i) {
+          generator->generate(buffer);
+          ids[t].push_back(buffer);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    std::set<std::string> unique_ids;
+    for (const auto& thread_ids : ids) {
+      unique_ids.insert(thread_ids.begin(), thread_ids.end());
+    }
+    BOOST_CHECK_EQUAL(unique_ids.size(), thread_count * ids_per_thread);
+  }
+}
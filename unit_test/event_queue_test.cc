@@ -7,6 +7,9 @@
 #include "logger/event_queue.h"
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+#include <thread>
+
 using namespace reinforcement_learning;
 using namespace std;
 
@@ -22,10 +25,6 @@ public:
     return *this;
   }
 
-  bool try_drop(float drop_prob, int _drop_pass) override {
-    return _seed_id.substr(0, 4) == "drop";
-  }
-
   std::string get_event_id() {
     return _seed_id;
   }
@@ -53,38 +52,50 @@ BOOST_AUTO_TEST_CASE(push_pop_test) {
   BOOST_CHECK_EQUAL(queue.size(), 0);
 }
 
-BOOST_AUTO_TEST_CASE(prune_test) {
+BOOST_AUTO_TEST_CASE(push_batch_test) {
   event_queue<test_event> queue(30);
-  queue.push(test_event("no_drop_1"),10);
-  queue.push(test_event("drop_1"),10);
+  queue.push(test_event("1"), 10);
 
-  BOOST_CHECK_EQUAL(queue.size(), 2);
-  BOOST_CHECK_EQUAL(queue.capacity(), 20);
-  queue.prune(1.0); // drop should not work since current capacity is less than limit (20 < 30)
-  BOOST_CHECK_EQUAL(queue.size(), 2);
-  BOOST_CHECK_EQUAL(queue.capacity(), 20);
+  vector<test_event> batch;
+  batch.push_back(test_event("2"));
+  batch.push_back(test_event("3"));
+  queue.push_batch(batch, { 5, 7 });
 
-  queue.push(test_event("no_drop_2"),10);
-  queue.push(test_event("drop_2"),10);
-  queue.push(test_event("no_drop_3"),10);
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+  BOOST_CHECK_EQUAL(queue.capacity(), 22);
 
   test_event val;
+  queue.pop(&val);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "1");
+  queue.pop(&val);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "2");
+  queue.pop(&val);
+  BOOST_CHECK_EQUAL(val.get_event_id(), "3");
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+}
 
-  BOOST_CHECK_EQUAL(queue.size(), 5);
-  BOOST_CHECK_EQUAL(queue.capacity(), 50);
-  queue.prune(1.0); // drop should work since current capacity is more than limit (50 > 30)
-  BOOST_CHECK_EQUAL(queue.size(), 3);
-  BOOST_CHECK_EQUAL(queue.capacity(), 30);
+BOOST_AUTO_TEST_CASE(fill_test) {
+  // 4 slots of 100 bytes
+  event_queue<test_event> queue(100, 4);
+  BOOST_CHECK_EQUAL(queue.fill(), 0.f);
 
+  // the bytes are the bottleneck
+  queue.push(test_event("1"), 30);
+  BOOST_CHECK_CLOSE(queue.fill(), 0.3f, 0.001);
 
-  queue.pop(&val);
-  BOOST_CHECK_EQUAL(val.get_event_id(), "no_drop_1");
+  // the slots are
+  queue.push(test_event("2"), 1);
+  queue.push(test_event("3"), 1);
+  BOOST_CHECK_CLOSE(queue.fill(), 0.75f, 0.001);
 
-  queue.pop(&val);
-  BOOST_CHECK_EQUAL(val.get_event_id(), "no_drop_2");
+  // the bytes can go over the capacity
+  queue.push(test_event("4"), 118);
+  BOOST_CHECK_CLOSE(queue.fill(), 1.5f, 0.001);
+  BOOST_CHECK(queue.is_full());
 
-  queue.pop(&val);
-  BOOST_CHECK_EQUAL(val.get_event_id(), "no_drop_3");
+  test_event val;
+  while (queue.pop(&val)) {}
+  BOOST_CHECK_EQUAL(queue.fill(), 0.f);
 }
 
 BOOST_AUTO_TEST_CASE(queue_push_pop)
@@ -154,4 +165,104 @@ BOOST_AUTO_TEST_CASE(queue_capacity_test)
   test_event item;
   queue.pop(&item);
   BOOST_CHECK_EQUAL(queue.capacity(), 0);
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(queue_full_ring_test)
+{
+  // 3 slots are rounded up to 4
+  reinforcement_learning::event_queue<test_event> queue(1000, 3);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(queue.push(test_event(std::to_string(i)), 1));
+  }
+  BOOST_CHECK(queue.is_full());
+
+  // a rejected event is left untouched
+  test_event rejected("rejected");
+  BOOST_CHECK(!queue.push(rejected, 1));
+  BOOST_CHECK_EQUAL(rejected.get_event_id(), "rejected");
+
+  test_event item;
+  queue.pop(&item);
+  BOOST_CHECK(queue.push(rejected, 1));
+
+  // a batch only goes in when there is room for it
+  vector<test_event> batch;
+  batch.push_back(test_event("b1"));
+  batch.push_back(test_event("b2"));
+  BOOST_CHECK_EQUAL(queue.push_batch(batch, { 1, 1 }), 0);
+  queue.pop(&item);
+  queue.pop(&item);
+  BOOST_CHECK_EQUAL(queue.push_batch(batch, { 1, 1 }), 2);
+
+  vector<string> ids;
+  while (queue.pop(&item)) {
+    ids.push_back(item.get_event_id());
+  }
+  BOOST_REQUIRE_EQUAL(ids.size(), 4);
+  BOOST_CHECK_EQUAL(ids[0], "3");
+  BOOST_CHECK_EQUAL(ids[1], "rejected");
+  BOOST_CHECK_EQUAL(ids[2], "b1");
+  BOOST_CHECK_EQUAL(ids[3], "b2");
+}
+
+BOOST_AUTO_TEST_CASE(queue_concurrent_producers_test)
+{
+  reinforcement_learning::event_queue<test_event> queue(1 << 30, 64);
+  const int producers = 4;
+  const int events_per_producer = 5000;
+
+  vector<thread> threads;
+  for (int p = 0; p < producers; ++p) {
+    threads.emplace_back([&queue, p]() {
+      for (int i = 0; i < events_per_producer; ++i) {
+        test_event evt(to_string(p) + ":" + to_string(i));
+        while (!queue.push(evt, 1)) {
+          this_thread::yield();
+        }
+      }
+    });
+  }
+
+  // every event is popped exactly once
+  set<string> popped;
+  test_event item;
+  while (popped.size() < static_cast<size_t>(producers * events_per_producer)) {
+    if (queue.pop(&item)) {
+      BOOST_REQUIRE(popped.insert(item.get_event_id()).second);
+    }
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+  BOOST_CHECK_EQUAL(queue.capacity(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(queue_drain_test)
+{
+  reinforcement_learning::event_queue<test_event> queue(25);
+  queue.push(test_event("1"), 10);
+  queue.push(test_event("2"), 10);
+  queue.push(test_event("3"), 10);
+  BOOST_CHECK_EQUAL(queue.size(), 3);
+
+  // limited by the event count
+  vector<test_event> segment;
+  BOOST_CHECK_EQUAL(queue.drain(segment, 1, 1000), 1);
+  BOOST_CHECK_EQUAL(segment[0].get_event_id(), "1");
+
+  // limited by the bytes
+  segment.clear();
+  BOOST_CHECK_EQUAL(queue.drain(segment, 10, 15), 1);
+  BOOST_CHECK_EQUAL(segment[0].get_event_id(), "2");
+  BOOST_CHECK_EQUAL(queue.capacity(), 10);
+
+  // the first event is taken even when it is over the byte limit
+  segment.clear();
+  BOOST_CHECK_EQUAL(queue.drain(segment, 10, 5), 1);
+  BOOST_CHECK_EQUAL(segment[0].get_event_id(), "3");
+
+  BOOST_CHECK_EQUAL(queue.drain(segment, 10, 1000), 0);
+  BOOST_CHECK_EQUAL(queue.size(), 0);
+  BOOST_CHECK_EQUAL(queue.capacity(), 0);
+}
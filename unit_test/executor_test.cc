@@ -0,0 +1,99 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "utility/executor.h"
+
+using namespace reinforcement_learning::utility;
+
+BOOST_AUTO_TEST_CASE(executor_runs_all_tasks_before_destruction)
+{
+  std::atomic<int> count(0);
+  {
+    executor exec(4);
+    BOOST_CHECK_EQUAL(exec.thread_count(), 4);
+    for (int i = 0; i < 1000; ++i) {
+      exec.submit([&count]() { ++count; });
+    }
+  }
+  BOOST_CHECK_EQUAL(count, 1000);
+}
+
+BOOST_AUTO_TEST_CASE(executor_default_thread_count)
+{
+  executor exec(0);
+  BOOST_CHECK_GE(exec.thread_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(executor_nested_submit_and_stealing)
+{
+  // every task of the first worker spawns more work on its own deque, which idle workers have to steal
+  std::atomic<int> count(0);
+  std::promise<void> done;
+  const int total = 1 + 64 * 4;
+  {
+    executor exec(4);
+    exec.submit([&]() {
+      for (int i = 0; i < 64; ++i) {
+        exec.submit([&]() {
+          for (int j = 0; j < 4; ++j) {
+            if (++count == total) done.set_value();
+          }
+        });
+      }
+      if (++count == total) done.set_value();
+    });
+    BOOST_CHECK(done.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  }
+  BOOST_CHECK_EQUAL(count, total);
+}
+
+BOOST_AUTO_TEST_CASE(executor_survives_throwing_task)
+{
+  std::atomic<int> count(0);
+  {
+    executor exec(1);
+    exec.submit([]() { throw std::runtime_error("boom"); });
+    exec.submit([&count]() { ++count; });
+  }
+  BOOST_CHECK_EQUAL(count, 1);
+}
+
+BOOST_AUTO_TEST_CASE(executor_runs_all_tasks_from_many_producers)
+{
+  // producers and nested submissions race with idle workers parking and with the shutdown drain
+  const int producers = 8;
+  const int per_producer = 2000;
+  for (int round = 0; round < 20; ++round) {
+    std::atomic<int> count(0);
+    {
+      executor exec(4);
+      std::vector<std::thread> threads;
+      for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&exec, &count]() {
+          for (int i = 0; i < per_producer; ++i) {
+            if (i % 16 == 0) {
+              exec.submit([&exec, &count]() {
+                exec.submit([&count]() { ++count; });
+                ++count;
+              });
+            }
+            else {
+              exec.submit([&count]() { ++count; });
+            }
+            if (i % 256 == 0) std::this_thread::yield();
+          }
+        });
+      }
+      for (auto& t : threads) t.join();
+    }
+    BOOST_REQUIRE_EQUAL(count.load(), producers * (per_producer + per_producer / 16));
+  }
+}
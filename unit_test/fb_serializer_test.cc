@@ -138,6 +138,21 @@ BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_content_encoding) {
   BOOST_CHECK_EQUAL(batch_metadata.content_encoding()->c_str(), value::CONTENT_ENCODING_DEDUP);
 }
 
+BOOST_AUTO_TEST_CASE(generic_event_long_id) {
+  const timestamp ts;
+  const std::string short_id(EVENT_ID_MAX_SIZE - 1, 's');
+  const std::string long_id(EVENT_ID_MAX_SIZE * 2, 'l');
+
+  generic_event short_event(short_id.c_str(), ts, v2::PayloadType_CB, flatbuffers::DetachedBuffer(), event_content_type::IDENTITY, "app_id");
+  generic_event long_event(long_id.c_str(), ts, v2::PayloadType_CB, flatbuffers::DetachedBuffer(), event_content_type::IDENTITY, "app_id");
+  BOOST_CHECK_EQUAL(short_id, short_event.get_id());
+  BOOST_CHECK_EQUAL(long_id, long_event.get_id());
+
+  short_event = std::move(long_event);
+  BOOST_CHECK_EQUAL(long_id, short_event.get_id());
+  BOOST_CHECK_EQUAL("app_id", short_event.get_app_id());
+}
+
 BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_metadata) {
  data_buffer db;
  fb_collection_serializer<generic_event> collection_serializer(db, value::CONTENT_ENCODING_DEDUP);
@@ -168,3 +183,86 @@ BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_metadata) {
   BOOST_CHECK_EQUAL(metadata.app_id()->c_str(), "app_id");
  }
 }
+
+BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_nested_events) {
+  data_buffer db;
+  fb_collection_serializer<generic_event> collection_serializer(db, value::CONTENT_ENCODING_IDENTITY);
+  const timestamp ts;
+  cb_serializer serializer;
+  const std::vector<std::string> ids = { "a", "event_id_1", "event_id_22", std::string(EVENT_ID_MAX_SIZE * 2, 'l') };
+
+  std::vector<size_t> payload_sizes;
+  for (size_t i = 0; i < ids.size(); ++i) {
+    ranking_response rr(ids[i].c_str());
+    rr.set_model_id("model_id");
+    for (size_t a = 0; a <= i; ++a) { rr.push_back(a, 1.f / (i + 1)); }
+    auto buffer = serializer.event(std::string(i * 7 + 1, 'c').c_str(), action_flags::DEFAULT, v2::LearningModeType_Online, rr);
+    payload_sizes.push_back(buffer.size());
+    generic_event ge(ids[i].c_str(), ts, v2::PayloadType_CB, std::move(buffer), event_content_type::IDENTITY, "app_id");
+    BOOST_CHECK_EQUAL(error_code::success, collection_serializer.add(ge));
+  }
+  BOOST_CHECK_EQUAL(error_code::success, collection_serializer.finalize(nullptr));
+
+  flatbuffers::Verifier v(db.body_begin(), db.body_filled_size());
+  const v2::EventBatch *event_batch = v2::GetEventBatch(db.body_begin());
+  BOOST_REQUIRE(event_batch->Verify(v));
+
+  const auto& events = *(event_batch->events());
+  BOOST_REQUIRE_EQUAL(events.size(), ids.size());
+  for (size_t i = 0; i < events.size(); ++i) {
+    // every event must be a standalone flatbuffer
+    const auto* payload = events.Get(i)->payload();
+    flatbuffers::Verifier event_verifier(payload->data(), payload->size());
+    BOOST_REQUIRE(event_verifier.VerifyBuffer<v2::Event>(nullptr));
+    const v2::Event* event = flatbuffers::GetRoot<v2::Event>(payload->data());
+    BOOST_CHECK_EQUAL(event->meta()->id()->str(), ids[i]);
+    BOOST_CHECK_EQUAL(event->meta()->app_id()->str(), "app_id");
+    BOOST_CHECK_EQUAL(event->payload()->size(), payload_sizes[i]);
+    const auto* cb = flatbuffers::GetRoot<v2::CbEvent>(event->payload()->data());
+    BOOST_CHECK_EQUAL(cb->action_ids()->size(), i + 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(fb_serializer_generic_event_batch_compression) {
+  batch_compressor compressor(value::DEFAULT_ZSTD_COMPRESSION_LEVEL);
+  cb_serializer serializer;
+  const timestamp ts;
+
+  // the compressor is reused from one batch to the next
+  for (int batch = 0; batch < 2; ++batch) {
+    data_buffer db;
+    fb_collection_serializer<generic_event> collection_serializer(db, value::CONTENT_ENCODING_IDENTITY, 0, &compressor);
+    const int n = 10 * (batch + 1);
+    for (int i = 0; i < n; ++i) {
+      const auto id = "event_id_" + std::to_string(i);
+      ranking_response rr(id.c_str());
+      rr.set_model_id("model_id");
+      rr.push_back(0, 1.f);
+      auto buffer = serializer.event(R"({"shared":{"feature":"value"},"_multi":[{"action":1},{"action":2}]})", action_flags::DEFAULT, v2::LearningModeType_Online, rr);
+      generic_event ge(id.c_str(), ts, v2::PayloadType_CB, std::move(buffer), event_content_type::IDENTITY, "app_id");
+      BOOST_CHECK_EQUAL(error_code::success, collection_serializer.add(ge));
+    }
+    BOOST_CHECK_EQUAL(error_code::success, collection_serializer.finalize(nullptr));
+
+    flatbuffers::Verifier v(db.body_begin(), db.body_filled_size());
+    const v2::EventBatch* outer_batch = v2::GetEventBatch(db.body_begin());
+    BOOST_REQUIRE(outer_batch->Verify(v));
+    BOOST_CHECK(outer_batch->events() == nullptr);
+    BOOST_CHECK_EQUAL(outer_batch->metadata()->content_encoding()->c_str(), value::CONTENT_ENCODING_IDENTITY);
+    BOOST_CHECK_EQUAL(outer_batch->metadata()->batch_compression()->c_str(), value::BATCH_COMPRESSION_ZSTD);
+
+    std::vector<uint8_t> decompressed;
+    const auto* compressed = outer_batch->compressed_batch();
+    BOOST_REQUIRE_EQUAL(error_code::success, batch_compressor::decompress(compressed->data(), compressed->size(), decompressed, nullptr));
+    BOOST_CHECK_LT(compressed->size(), decompressed.size());
+
+    flatbuffers::Verifier inner_verifier(decompressed.data(), decompressed.size());
+    const v2::EventBatch* batch_events = v2::GetEventBatch(decompressed.data());
+    BOOST_REQUIRE(batch_events->Verify(inner_verifier));
+    BOOST_CHECK(batch_events->metadata()->batch_compression() == nullptr);
+    BOOST_REQUIRE_EQUAL(batch_events->events()->size(), n);
+    const auto* payload = batch_events->events()->Get(n - 1)->payload();
+    const auto* event = flatbuffers::GetRoot<v2::Event>(payload->data());
+    BOOST_CHECK_EQUAL(event->meta()->id()->str(), "event_id_" + std::to_string(n - 1));
+  }
+}
@@ -5,8 +5,14 @@
 
 #include <boost/test/unit_test.hpp>
 #include "logger/file/file_logger.h"
+#include "logger/file/async_file_logger.h"
+#include "logger/spool/mapped_file.h"
 #include "err_constants.h"
+#include <algorithm>
 #include <cstdio>
+#include <iterator>
+#include <string>
+#include <vector>
 
 namespace rl = reinforcement_learning;
 namespace rlog = reinforcement_learning::logger;
@@ -36,4 +42,123 @@ BOOST_AUTO_TEST_CASE(file_logger_test) {
 
   BOOST_CHECK(file_exists(file));
   remove(file.c_str());
-}
\ No newline at end of file
+}
+namespace {
+  rl::i_sender::buffer make_batch(const std::string& body) {
+    auto db = std::make_shared<rutil::data_buffer>(body.size());
+    std::copy(body.begin(), body.end(), db->body_begin());
+    db->set_body_endoffset(db->preamble_size() + body.size());
+    std::fill(db->preamble_begin(), db->body_begin(), static_cast<uint8_t>('#'));
+    return db;
+  }
+
+  std::string batch_bytes(const rl::i_sender::buffer& db) {
+    return std::string(reinterpret_cast<const char*>(db->preamble_begin()), db->buffer_filled_size());
+  }
+
+  std::string read_file(const std::string& file) {
+    std::ifstream f(file, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+  }
+
+  // the rotated files of file, in rotation order
+  std::vector<std::string> rotated_files(const std::string& file) {
+    std::vector<std::string> names;
+    rlog::spool::list_files(".", file + ".", names, nullptr);
+    std::sort(names.begin(), names.end());
+    return names;
+  }
+
+  void remove_files(const std::string& file) {
+    for (const auto& name : rotated_files(file)) remove(name.c_str());
+    remove(file.c_str());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(async_file_logger_writes_batches_in_order) {
+  const std::string file("async_file_logger_test");
+  remove_files(file);
+
+  std::string expected;
+  {
+    rlog::file::async_file_logger logger(file, rutil::file_sender_config(), nullptr, nullptr);
+    rutil::configuration config;
+    BOOST_CHECK_EQUAL(logger.init(config, nullptr), rerr::success);
+    for (int i = 0; i < 1000; ++i) {
+      const auto batch = make_batch("batch " + std::to_string(i));
+      expected += batch_bytes(batch);
+      BOOST_CHECK_EQUAL(logger.send(batch), rerr::success);
+    }
+  }
+
+  BOOST_CHECK(read_file(file) == expected);
+  BOOST_CHECK(rotated_files(file).empty());
+  remove_files(file);
+}
+
+BOOST_AUTO_TEST_CASE(async_file_logger_batch_durability) {
+  const std::string file("async_file_logger_durability_test");
+  remove_files(file);
+
+  rutil::file_sender_config sender_config;
+  sender_config.durability = rl::file_durability_enum::BATCH;
+  rlog::file::async_file_logger logger(file, sender_config, nullptr, nullptr);
+  rutil::configuration config;
+  BOOST_CHECK_EQUAL(logger.init(config, nullptr), rerr::success);
+
+  // send returns once the batch is written
+  std::string expected;
+  for (int i = 0; i < 3; ++i) {
+    const auto batch = make_batch("durable " + std::to_string(i));
+    expected += batch_bytes(batch);
+    BOOST_CHECK_EQUAL(logger.send(batch), rerr::success);
+    BOOST_CHECK(read_file(file) == expected);
+  }
+  remove_files(file);
+}
+
+BOOST_AUTO_TEST_CASE(async_file_logger_size_rotation) {
+  const std::string file("async_file_logger_rotation_test");
+  remove_files(file);
+
+  rutil::file_sender_config sender_config;
+  sender_config.rotate_size = 100;
+  std::vector<std::string> batches;
+  {
+    rlog::file::async_file_logger logger(file, sender_config, nullptr, nullptr);
+    rutil::configuration config;
+    BOOST_CHECK_EQUAL(logger.init(config, nullptr), rerr::success);
+    for (int i = 0; i < 10; ++i) {
+      const auto batch = make_batch(std::string(52, static_cast<char>('a' + i)));
+      batches.push_back(batch_bytes(batch));
+      BOOST_CHECK_EQUAL(logger.send(batch), rerr::success);
+    }
+  }
+
+  // the file is closed at shutdown too, every batch is in a rotated file
+  auto rotated = rotated_files(file);
+  BOOST_CHECK(!file_exists(file));
+  BOOST_REQUIRE(!rotated.empty());
+  std::string all;
+  for (const auto& name : rotated) {
+    const auto content = read_file(name);
+    BOOST_CHECK(!content.empty());
+    BOOST_CHECK_EQUAL(content.size() % batches[0].size(), 0);
+    all += content;
+  }
+  std::string expected;
+  for (const auto& batch : batches) expected += batch;
+  BOOST_CHECK(all == expected);
+
+  // a new process carries on after the existing rotated files
+  {
+    rlog::file::async_file_logger logger(file, sender_config, nullptr, nullptr);
+    rutil::configuration config;
+    BOOST_CHECK_EQUAL(logger.init(config, nullptr), rerr::success);
+    BOOST_CHECK_EQUAL(logger.send(make_batch("last")), rerr::success);
+  }
+  const auto after = rotated_files(file);
+  BOOST_REQUIRE_EQUAL(after.size(), rotated.size() + 1);
+  BOOST_CHECK(read_file(after.back()) == batch_bytes(make_batch("last")));
+  remove_files(file);
+}
@@ -13,6 +13,11 @@
 #include "utility/eventhub_http_authorization.h"
 #include "config_utility.h"
 
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+
 namespace reinforcement_learning {namespace utility {
   class data_buffer_streambuf;
 }}
@@ -33,6 +38,19 @@ void error_counter_func(const r::api_status&, void* counter) {
   static_cast<error_counter*>(counter)->_error_handler();
 }
 
+// keeps the retry tests short
+const std::chrono::milliseconds RETRY_MIN_DELAY(1);
+const std::chrono::milliseconds RETRY_MAX_DELAY(10);
+
+std::shared_ptr<u::data_buffer> make_message(const std::string& text) {
+  std::shared_ptr<u::data_buffer> db(new u::data_buffer());
+  u::data_buffer_streambuf sbuff(db.get());
+  std::ostream message(&sbuff);
+  message << text;
+  sbuff.finalize();
+  return db;
+}
+
 BOOST_AUTO_TEST_CASE(send_something_apim_authorization)
 {
   mock_http_client* http_client = new mock_http_client("localhost:8080");
@@ -115,7 +133,7 @@ BOOST_AUTO_TEST_CASE(retry_http_send_success)
   // Use scope to force destructor and therefore flushing of buffers.
   {
     //create a client
-    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, 8 /* retries */, nullptr, &error_callback);
+    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, 8 /* retries */, nullptr, &error_callback, RETRY_MIN_DELAY, RETRY_MAX_DELAY);
     reinforcement_learning::api_status ret;
 
     std::shared_ptr<u::data_buffer> db1(new u::data_buffer());
@@ -123,6 +141,7 @@ BOOST_AUTO_TEST_CASE(retry_http_send_success)
     std::ostream message1(&sbuff1);
 
     message1 << "message 1";
+    sbuff1.finalize();
     BOOST_CHECK_EQUAL(eh.send(db1, &ret), r::error_code::success);
   }
 
@@ -149,7 +168,7 @@ BOOST_AUTO_TEST_CASE(retry_http_send_fail)
   // Use scope to force destructor and therefore flushing of buffers.
   {
     //create a client
-    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, MAX_RETRIES, nullptr, &error_callback);
+    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, MAX_RETRIES, nullptr, &error_callback, RETRY_MIN_DELAY, RETRY_MAX_DELAY);
 
     r::api_status ret;
     std::shared_ptr<u::data_buffer> db1(new u::data_buffer());
@@ -157,6 +176,7 @@ BOOST_AUTO_TEST_CASE(retry_http_send_fail)
     std::ostream message1(&sbuff1);
 
     message1 << "message 1";
+    sbuff1.finalize();
     BOOST_CHECK_EQUAL(eh.send(db1, &ret), r::error_code::success);
   }
 
@@ -194,7 +214,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
   // Use scope to force destructor and therefore flushing of buffers.
   {
     //create a client
-    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, MAX_RETRIES, nullptr, &error_callback);
+    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 1, MAX_RETRIES, nullptr, &error_callback, RETRY_MIN_DELAY, RETRY_MAX_DELAY);
 
     r::api_status ret;
     std::shared_ptr<u::data_buffer> db1(new u::data_buffer());
@@ -202,6 +222,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
     std::ostream message1(&sbuff1);
     message1 << std::unitbuf;
     message1 << "message 1";
+    sbuff1.finalize();
     BOOST_CHECK_EQUAL(eh.send(db1, &ret), r::error_code::success);
 
     std::shared_ptr<u::data_buffer> db2(new u::data_buffer());
@@ -210,6 +231,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
 
     message2 << std::unitbuf;
     message2 << "message 2";
+    sbuff2.finalize();
     BOOST_CHECK_EQUAL(eh.send(db2, &ret), r::error_code::success);
 
     std::shared_ptr<u::data_buffer> db3(new u::data_buffer());
@@ -218,6 +240,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
 
     message3 << std::unitbuf;
     message3 << "message 3";
+    sbuff3.finalize();
     BOOST_CHECK_EQUAL(eh.send(db3, &ret), r::error_code::success);
 
     std::shared_ptr<u::data_buffer> db4(new u::data_buffer());
@@ -226,6 +249,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
 
     message4 << std::unitbuf;
     message4 << "message 4";
+    sbuff4.finalize();
     BOOST_CHECK_EQUAL(eh.send(db4, &ret), r::error_code::success);
 
     std::shared_ptr<u::data_buffer> db5(new u::data_buffer());
@@ -234,6 +258,7 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
 
     message5 << std::unitbuf;
     message5 << "message 5";
+    sbuff5.finalize();
     BOOST_CHECK_EQUAL(eh.send(db5, &ret), r::error_code::success);
   }
 
@@ -244,3 +269,58 @@ BOOST_AUTO_TEST_CASE(http_in_order_after_retry)
   BOOST_CHECK_EQUAL(received_messages[4], "message 5");
   BOOST_CHECK_EQUAL(counter._err_count, 0);
 }
+
+BOOST_AUTO_TEST_CASE(http_send_does_not_wait_for_the_window)
+{
+  mock_http_client* http_client = new mock_http_client("localhost:8080");
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> received(0);
+  http_client->set_responder(methods::POST, [released, &received](const http_request& message, http_response& resp) {
+    released.wait();
+    ++received;
+    resp.set_status_code(status_codes::Created);
+  });
+
+  error_counter counter;
+  r::error_callback_fn error_callback(&error_counter_func, &counter);
+  {
+    r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 2, 0, nullptr, &error_callback);
+    r::api_status ret;
+
+    // two requests in flight and two queued behind them, none of them is answered yet
+    for (int i = 0; i < 4; ++i) {
+      BOOST_CHECK_EQUAL(eh.send(make_message("message " + std::to_string(i)), &ret), r::error_code::success);
+    }
+    BOOST_CHECK_EQUAL(received, 0);
+    release.set_value();
+  }
+
+  BOOST_CHECK_EQUAL(received, 4);
+  BOOST_CHECK_EQUAL(counter._err_count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(http_buffer_released_on_completion)
+{
+  mock_http_client* http_client = new mock_http_client("localhost:8080");
+  http_client->set_responder(methods::POST, [](const http_request& message, http_response& resp) {
+    resp.set_status_code(status_codes::Created);
+  });
+
+  r::http_transport_client<r::eventhub_http_authorization> eh(http_client, 4, 0, nullptr, nullptr);
+  r::api_status ret;
+  std::weak_ptr<u::data_buffer> sent;
+  {
+    auto db = make_message("message");
+    sent = db;
+    BOOST_CHECK_EQUAL(eh.send(db, &ret), r::error_code::success);
+  }
+
+  // the client still runs, the buffer was let go when its request completed
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!sent.expired() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK(sent.expired());
+}
@@ -56,8 +56,8 @@ BOOST_AUTO_TEST_CASE(json_malformed) {
 BOOST_AUTO_TEST_CASE(event_ids_json_malformed) {
   const auto context = R"({"UserAgeq09898u)(**&^(*&^*^* })";
 
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
+  rlutil::ContextInfo info;
+  const auto scode = rlutil::get_context_info(context, info, nullptr, nullptr);
   BOOST_CHECK_EQUAL(scode, error_code::json_parse_error);
 }
 
@@ -72,10 +72,10 @@ BOOST_AUTO_TEST_CASE(event_ids_json_no_slots) {
     "_slots": [
     ]
   })";
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
+  rlutil::ContextInfo info;
+  const auto scode = rlutil::get_context_info(context, info, nullptr, nullptr);
   BOOST_CHECK_EQUAL(scode, error_code::success);
-  BOOST_CHECK_EQUAL(found.size(), 0);
+  BOOST_CHECK_EQUAL(info.slot_ids.size(), 0);
 }
 
 BOOST_AUTO_TEST_CASE(event_ids_json_basic) {
@@ -90,10 +90,11 @@ BOOST_AUTO_TEST_CASE(event_ids_json_basic) {
       {"_id":"test"}
     ]
   })";
-  std::map<size_t, std::string> found;
-  const auto scode = rlutil::get_event_ids(context, found, nullptr, nullptr);
+  rlutil::ContextInfo info;
+  const auto scode = rlutil::get_context_info(context, info, nullptr, nullptr);
   BOOST_CHECK_EQUAL(scode, error_code::success);
 
+  auto& found = info.slot_ids;
   BOOST_CHECK_EQUAL(found.size(), 1);
   BOOST_CHECK_EQUAL(found.count(0), 0);
   BOOST_CHECK_EQUAL(found.count(1), 1);
@@ -207,12 +208,9 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_test)
     ]
   })";
   rlutil::ContextInfo info;
-  auto scode = rlutil::get_context_info(context, info);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
+  const auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 2);
   BOOST_CHECK_EQUAL(slot_ids[0], "provided_slot_id_1");
@@ -234,12 +232,9 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_no_slot_ids_test)
     ]
   })";
   rlutil::ContextInfo info;
-  auto scode = rlutil::get_context_info(context, info);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
+  const auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 0);
 }
@@ -259,15 +254,33 @@ BOOST_AUTO_TEST_CASE(get_slot_ids_some_slots_missing)
     ]
   })";
   rlutil::ContextInfo info;
-  auto scode = rlutil::get_context_info(context, info);
-  BOOST_CHECK_EQUAL(scode, error_code::success);
-  std::map<size_t, std::string> slot_ids;
-
-  scode = rlutil::get_slot_ids(context, info.slots, slot_ids);
+  const auto scode = rlutil::get_context_info(context, info);
   BOOST_CHECK_EQUAL(scode, error_code::success);
+  auto& slot_ids = info.slot_ids;
 
   BOOST_CHECK_EQUAL(slot_ids.size(), 2);
   BOOST_CHECK_EQUAL(slot_ids[0], "provided_id_0");
   BOOST_CHECK_EQUAL(slot_ids[1], "");
   BOOST_CHECK_EQUAL(slot_ids[2], "provided_id_2");
 }
+
+BOOST_AUTO_TEST_CASE(slot_ids_ignore_nested_and_non_string_ids)
+{
+  auto const context = R"({
+    "_id":"not_a_slot",
+    "_multi":[
+      {"_id":"action_id"}
+    ],
+    "_slots": [
+      {"ns":{"_id":"nested"}},
+      {"_id":5},
+      {"_id":"slot_\"2\""}
+    ]
+  })";
+  rlutil::ContextInfo info;
+  const auto scode = rlutil::get_context_info(context, info);
+  BOOST_CHECK_EQUAL(scode, error_code::success);
+
+  BOOST_CHECK_EQUAL(info.slot_ids.size(), 1);
+  BOOST_CHECK_EQUAL(info.slot_ids[2], "slot_\"2\"");
+}
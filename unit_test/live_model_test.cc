@@ -4,6 +4,9 @@
 #   define BOOST_TEST_MODULE Main
 #endif
 
+#include <cstring>
+#include <functional>
+#include <future>
 #include <thread>
 #include <boost/test/unit_test.hpp>
 #include <vector>
@@ -18,6 +21,7 @@
 #include "model_mgmt.h"
 #include "str_util.h"
 #include "factory_resolver.h"
+#include "event_id_generator.h"
 #include "sampling.h"
 
 #include "mock_util.h"
@@ -109,6 +113,92 @@ namespace {
       return model;
   }
 
+  // the ready model fixture ranks the two actions of its contexts the same way for every call
+  void ready_model_rank(std::vector<int>& action_ids, std::vector<float>& action_pdfs) {
+    action_ids = { 1, 0 };
+    action_pdfs = { 0.8f, 0.2f };
+  }
+
+  // and picks action k for slot k
+  void ready_model_rank_slots(size_t slots_count, std::vector<std::vector<uint32_t>>& action_ids, std::vector<std::vector<float>>& action_pdfs) {
+    action_ids.resize(slots_count);
+    action_pdfs.resize(slots_count);
+    for (size_t k = 0; k < slots_count; ++k) {
+      action_ids[k] = { static_cast<uint32_t>(k) };
+      action_pdfs[k] = { 1.f };
+    }
+  }
+
+  // a mock model that is ready once refreshed and returns the same rankings from its single and batch calls
+  std::unique_ptr<fakeit::Mock<m::i_model>> get_ready_mock_model(r::model_management::model_type_t model_type) {
+      auto mock_model = get_mock_model(model_type);
+      When(Method((*mock_model), update)).AlwaysDo([](const m::model_data&, bool& model_ready, r::api_status*) {
+        model_ready = true;
+        return err::success;
+      });
+      When(Method((*mock_model), choose_rank)).AlwaysDo(
+        [](uint64_t, const char*, std::vector<int>& action_ids, std::vector<float>& action_pdfs, std::string& model_version, r::api_status*) {
+        ready_model_rank(action_ids, action_pdfs);
+        model_version = "model_id";
+        return err::success;
+      });
+      When(Method((*mock_model), choose_rank_batch)).AlwaysDo(
+        [](const std::vector<uint64_t>&, const std::vector<const char*>& features, std::vector<std::vector<int>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, r::api_status*) {
+        action_ids.resize(features.size());
+        action_pdfs.resize(features.size());
+        for (size_t i = 0; i < features.size(); ++i) {
+          ready_model_rank(action_ids[i], action_pdfs[i]);
+        }
+        model_version = "model_id";
+        return err::success;
+      });
+      When(Method((*mock_model), request_multi_slot_decision)).AlwaysDo(
+        [](const char*, const std::vector<std::string>& slot_ids, const char*, std::vector<std::vector<uint32_t>>& actions_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, r::api_status*) {
+        ready_model_rank_slots(slot_ids.size(), actions_ids, action_pdfs);
+        model_version = "model_id";
+        return err::success;
+      });
+      When(Method((*mock_model), request_multi_slot_decision_batch)).AlwaysDo(
+        [](const std::vector<const char*>&, const std::vector<std::vector<std::string>>& slot_ids, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, r::api_status*) {
+        actions_ids.resize(features.size());
+        action_pdfs.resize(features.size());
+        for (size_t i = 0; i < features.size(); ++i) {
+          ready_model_rank_slots(slot_ids[i].size(), actions_ids[i], action_pdfs[i]);
+        }
+        model_version = "model_id";
+        return err::success;
+      });
+      return mock_model;
+  }
+
+  // runs requests against a live_model whose mock model is ready, returns the interaction batches it sent
+  std::vector<std::string> run_with_ready_model(const u::configuration& config, r::model_management::model_type_t model_type,
+    const std::function<void(r::live_model&)>& requests) {
+      std::vector<buffer_data_t> recorded_observations;
+      auto mock_observation_sender = get_mock_sender(recorded_observations);
+      std::vector<buffer_data_t> recorded_interactions;
+      auto mock_interaction_sender = get_mock_sender(recorded_interactions);
+      auto mock_data_transport = get_mock_data_transport();
+      auto mock_model = get_ready_mock_model(model_type);
+
+      auto sender_factory = get_mock_sender_factory(mock_observation_sender.get(), mock_interaction_sender.get());
+      auto data_transport_factory = get_mock_data_transport_factory(mock_data_transport.get());
+      auto model_factory = get_mock_model_factory(mock_model.get());
+      {
+        r::live_model model = create_mock_live_model(config, data_transport_factory.get(), model_factory.get(), sender_factory.get());
+        r::api_status status;
+        BOOST_REQUIRE_EQUAL(model.init(&status), err::success);
+        BOOST_REQUIRE_EQUAL(model.refresh_model(&status), err::success);
+        requests(model);
+      }
+
+      std::vector<std::string> batches;
+      for (auto& buffer : recorded_interactions) {
+        batches.emplace_back(reinterpret_cast<const char*>(buffer.body_begin()), buffer.body_filled_size());
+      }
+      return batches;
+  }
+
 }
 
 BOOST_AUTO_TEST_CASE(schema_v1_with_bad_use_dedup) {
@@ -207,6 +297,222 @@ BOOST_AUTO_TEST_CASE(live_model_ranking_request) {
   BOOST_CHECK_EQUAL(status.get_error_msg(), "");
 }
 
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_batch) {
+  //create a simple ds configuration
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+
+  r::api_status status;
+
+  //create the ds live_model, and initialize it with the config
+  r::live_model ds = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK_EQUAL(ds.init(&status), err::success);
+
+  const std::vector<const char*> event_ids = { "event_id_1", "event_id_2", "event_id_3" };
+  const std::vector<const char*> contexts = { JSON_CONTEXT, JSON_CONTEXT, JSON_CONTEXT };
+
+  std::vector<r::ranking_response> responses;
+  BOOST_CHECK_EQUAL(ds.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, responses, &status), err::success);
+  BOOST_REQUIRE_EQUAL(responses.size(), 3);
+  for (size_t i = 0; i < responses.size(); ++i) {
+    BOOST_CHECK_EQUAL(responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK_EQUAL(responses[i].size(), 2);
+  }
+
+  // mismatched sizes and invalid entries are rejected
+  const std::vector<const char*> short_contexts = { JSON_CONTEXT };
+  BOOST_CHECK_EQUAL(ds.choose_rank_batch(event_ids, short_contexts, r::action_flags::DEFAULT, responses, &status), err::invalid_argument);
+  const std::vector<const char*> invalid_contexts = { JSON_CONTEXT, "", JSON_CONTEXT };
+  BOOST_CHECK_EQUAL(ds.choose_rank_batch(event_ids, invalid_contexts, r::action_flags::DEFAULT, responses, &status), err::invalid_argument);
+
+  // auto-generated event ids
+  BOOST_CHECK_EQUAL(ds.choose_rank_batch(contexts, r::action_flags::DEFAULT, responses, &status), err::success);
+  BOOST_REQUIRE_EQUAL(responses.size(), 3);
+  BOOST_CHECK(strcmp(responses[0].get_event_id(), responses[1].get_event_id()) != 0);
+}
+
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_batch_ready_model) {
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+  config.set(r::name::INTERACTION_SEND_BATCH_INTERVAL_MS, "100000"); // one batch sent on shutdown
+
+  const std::vector<const char*> event_ids = { "event_id_1", "event_id_2", "event_id_3" };
+  const std::vector<const char*> contexts = { JSON_CONTEXT, JSON_CONTEXT, JSON_CONTEXT };
+
+  std::vector<r::ranking_response> single_responses(event_ids.size());
+  const auto single_batches = run_with_ready_model(config, r::model_management::model_type_t::CB, [&](r::live_model& model) {
+    for (size_t i = 0; i < event_ids.size(); ++i) {
+      BOOST_CHECK_EQUAL(model.choose_rank(event_ids[i], contexts[i], single_responses[i]), err::success);
+    }
+  });
+
+  std::vector<r::ranking_response> batch_responses;
+  const auto batch_batches = run_with_ready_model(config, r::model_management::model_type_t::CB, [&](r::live_model& model) {
+    r::api_status status;
+    BOOST_CHECK_EQUAL(model.choose_rank_batch(event_ids, contexts, r::action_flags::DEFAULT, batch_responses, &status), err::success);
+  });
+
+  // the batch is ranked by the model, not by the explore only fallback, exactly like the single calls
+  BOOST_REQUIRE_EQUAL(batch_responses.size(), single_responses.size());
+  for (size_t i = 0; i < batch_responses.size(); ++i) {
+    BOOST_CHECK_EQUAL(batch_responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK_EQUAL(batch_responses[i].get_model_id(), "model_id");
+    BOOST_CHECK_EQUAL(single_responses[i].get_model_id(), "model_id");
+    size_t batch_chosen, single_chosen;
+    BOOST_CHECK_EQUAL(batch_responses[i].get_chosen_action_id(batch_chosen), err::success);
+    BOOST_CHECK_EQUAL(single_responses[i].get_chosen_action_id(single_chosen), err::success);
+    BOOST_CHECK_EQUAL(batch_chosen, single_chosen);
+    BOOST_REQUIRE_EQUAL(batch_responses[i].size(), single_responses[i].size());
+    for (size_t j = 0; j < batch_responses[i].size(); ++j) {
+      const auto batch_ap = *(batch_responses[i].begin() + j);
+      const auto single_ap = *(single_responses[i].begin() + j);
+      BOOST_CHECK_EQUAL(batch_ap.action_id, single_ap.action_id);
+      BOOST_CHECK_EQUAL(batch_ap.probability, single_ap.probability);
+    }
+  }
+
+  // and logs the same interactions
+  BOOST_REQUIRE_EQUAL(single_batches.size(), 1);
+  BOOST_REQUIRE_EQUAL(batch_batches.size(), 1);
+  BOOST_CHECK_EQUAL(batch_batches[0], single_batches[0]);
+}
+
+BOOST_AUTO_TEST_CASE(live_model_multi_slot_request_batch_ready_model) {
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::PROTOCOL_VERSION, "2");
+  config.set(r::name::MODEL_BACKGROUND_REFRESH, "false");
+  config.set(r::name::INTERACTION_SEND_BATCH_INTERVAL_MS, "100000"); // one batch sent on shutdown
+  config.set(r::name::TIME_PROVIDER_IMPLEMENTATION, r::value::NULL_TIME_PROVIDER); // no timestamps in the events
+
+  // the slot ids are given so that they are the same for both runs
+  const auto context = R"({"_multi":[{},{}],"_slots":[{"_id":"slot_1"},{"_id":"slot_2"}]})";
+  const std::vector<const char*> event_ids = { "event_id_1", "event_id_2", "event_id_3" };
+  const std::vector<const char*> contexts = { context, context, context };
+
+  std::vector<r::multi_slot_response> single_responses(event_ids.size());
+  const auto single_batches = run_with_ready_model(config, r::model_management::model_type_t::CCB, [&](r::live_model& model) {
+    r::api_status status;
+    for (size_t i = 0; i < event_ids.size(); ++i) {
+      BOOST_CHECK_EQUAL(model.request_multi_slot_decision(event_ids[i], contexts[i], r::action_flags::DEFAULT, single_responses[i], &status), err::success);
+    }
+  });
+
+  std::vector<r::multi_slot_response> batch_responses;
+  const auto batch_batches = run_with_ready_model(config, r::model_management::model_type_t::CCB, [&](r::live_model& model) {
+    r::api_status status;
+    BOOST_CHECK_EQUAL(model.request_multi_slot_decision_batch(event_ids, contexts, r::action_flags::DEFAULT, batch_responses, &status), err::success);
+  });
+
+  BOOST_REQUIRE_EQUAL(batch_responses.size(), single_responses.size());
+  for (size_t i = 0; i < batch_responses.size(); ++i) {
+    BOOST_CHECK_EQUAL(batch_responses[i].get_event_id(), event_ids[i]);
+    BOOST_CHECK_EQUAL(batch_responses[i].get_model_id(), "model_id");
+    BOOST_REQUIRE_EQUAL(batch_responses[i].size(), 2);
+    BOOST_REQUIRE_EQUAL(single_responses[i].size(), 2);
+    auto batch_it = batch_responses[i].begin();
+    auto single_it = single_responses[i].begin();
+    for (; batch_it != batch_responses[i].end(); ++batch_it, ++single_it) {
+      BOOST_CHECK_EQUAL((*batch_it).get_id(), (*single_it).get_id());
+      BOOST_CHECK_EQUAL((*batch_it).get_action_id(), (*single_it).get_action_id());
+      BOOST_CHECK_EQUAL((*batch_it).get_probability(), (*single_it).get_probability());
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(single_batches.size(), 1);
+  BOOST_REQUIRE_EQUAL(batch_batches.size(), 1);
+  BOOST_CHECK(batch_batches[0] == single_batches[0]);
+}
+
+BOOST_AUTO_TEST_CASE(live_model_ranking_request_async) {
+  //create a simple ds configuration
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::ASYNC_EXECUTOR_THREAD_COUNT, "2");
+
+  r::api_status status;
+
+  //create the ds live_model, and initialize it with the config
+  r::live_model ds = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK_EQUAL(ds.init(&status), err::success);
+
+  // the arguments are copied, so the caller's buffers can go away right after the call
+  std::string event_id = "event_id";
+  std::string context = JSON_CONTEXT;
+  // checks are done on the test thread, the callback runs on an executor thread
+  int callback_result = -1;
+  int callback_status = -1;
+  std::promise<r::ranking_response> done;
+  auto callback = [&](int result, r::ranking_response& response, const r::api_status& task_status) {
+    callback_result = result;
+    callback_status = task_status.get_error_code();
+    done.set_value(std::move(response));
+  };
+  BOOST_CHECK_EQUAL(ds.choose_rank_async(event_id.c_str(), context.c_str(), r::action_flags::DEFAULT, callback, &status), err::success);
+  event_id.assign("overwritten");
+  context.clear();
+
+  auto future = done.get_future();
+  BOOST_REQUIRE(future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  const auto response = future.get();
+  BOOST_CHECK_EQUAL(callback_result, err::success);
+  BOOST_CHECK_EQUAL(callback_status, err::success);
+  BOOST_CHECK_EQUAL(response.get_event_id(), "event_id");
+  BOOST_CHECK_EQUAL(response.size(), 2);
+
+  // auto-generated event id
+  std::promise<r::ranking_response> auto_done;
+  BOOST_CHECK_EQUAL(ds.choose_rank_async(JSON_CONTEXT, r::action_flags::DEFAULT,
+    [&auto_done](int, r::ranking_response& response, const r::api_status&) { auto_done.set_value(std::move(response)); }, &status), err::success);
+  auto auto_future = auto_done.get_future();
+  BOOST_REQUIRE(auto_future.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+  BOOST_CHECK(strlen(auto_future.get().get_event_id()) > 0);
+
+  // invalid arguments are reported synchronously and the callback is never invoked
+  BOOST_CHECK_EQUAL(ds.choose_rank_async("", JSON_CONTEXT, r::action_flags::DEFAULT, callback, &status), err::invalid_argument);
+  BOOST_CHECK_EQUAL(ds.choose_rank_async("event_id", JSON_CONTEXT, r::action_flags::DEFAULT, nullptr, &status), err::invalid_argument);
+}
+
+class fixed_event_id_generator : public r::i_event_id_generator {
+public:
+  size_t generate(char* buffer) override {
+    strcpy(buffer, "generated_id");
+    return strlen(buffer);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(live_model_custom_event_id_generator) {
+  r::event_id_generator_factory.register_type("FIXED_EVENT_ID_GENERATOR",
+    [](r::i_event_id_generator** retval, const u::configuration&, r::i_trace*, r::api_status*) {
+      *retval = new fixed_event_id_generator();
+      return err::success;
+    });
+
+  //create a simple ds configuration
+  u::configuration config;
+  cfg::create_from_json(JSON_CFG, config);
+  config.set(r::name::EH_TEST, "true");
+  config.set(r::name::EVENT_ID_GENERATOR_IMPLEMENTATION, "FIXED_EVENT_ID_GENERATOR");
+
+  r::api_status status;
+  r::live_model ds = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK_EQUAL(ds.init(&status), err::success);
+
+  r::ranking_response response;
+  BOOST_CHECK_EQUAL(ds.choose_rank(JSON_CONTEXT, response, &status), err::success);
+  BOOST_CHECK_EQUAL(response.get_event_id(), "generated_id");
+
+  // unknown implementations are rejected by init
+  config.set(r::name::EVENT_ID_GENERATOR_IMPLEMENTATION, "UNKNOWN_EVENT_ID_GENERATOR");
+  r::live_model invalid = create_mock_live_model(config, nullptr, nullptr, nullptr, r::model_management::model_type_t::CB);
+  BOOST_CHECK(invalid.init(&status) != err::success);
+}
+
 BOOST_AUTO_TEST_CASE(live_model_ranking_request_online_mode) {
   //create a simple ds configuration
   u::configuration config;
@@ -97,6 +97,22 @@ std::unique_ptr<fakeit::Mock<m::i_model>> get_mock_model(m::model_type_t model_t
     return r::error_code::success;
   };
 
+  const auto choose_rank_batch_fn =
+    [](const std::vector<uint64_t>&, const std::vector<const char*>& features, std::vector<std::vector<int>>& action_ids, std::vector<std::vector<float>>& action_pdfs, std::string& model_version, r::api_status*) {
+    action_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    model_version = "model_id";
+    return r::error_code::success;
+  };
+
+  const auto request_multi_slot_decision_batch_fn =
+    [](const std::vector<const char*>&, const std::vector<std::vector<std::string>>&, const std::vector<const char*>& features, std::vector<std::vector<std::vector<uint32_t>>>& actions_ids, std::vector<std::vector<std::vector<float>>>& action_pdfs, std::string& model_version, r::api_status*) {
+    actions_ids.resize(features.size());
+    action_pdfs.resize(features.size());
+    model_version = "model_id";
+    return r::error_code::success;
+  };
+
   const auto get_model_type = [model_type]() {
     return model_type;
   };
@@ -107,6 +123,8 @@ std::unique_ptr<fakeit::Mock<m::i_model>> get_mock_model(m::model_type_t model_t
   When(Method((*mock), request_decision)).AlwaysDo(request_decision_fn);
   When(Method((*mock), request_multi_slot_decision)).AlwaysDo(request_multi_slot_decision_fn);
   When(Method((*mock), choose_rank_multistep)).AlwaysDo(choose_rank_multistep_fn);
+  When(Method((*mock), choose_rank_batch)).AlwaysDo(choose_rank_batch_fn);
+  When(Method((*mock), request_multi_slot_decision_batch)).AlwaysDo(request_multi_slot_decision_batch_fn);
   When(Method((*mock), model_type)).AlwaysDo(get_model_type);
 
   Fake(Dtor((*mock)));
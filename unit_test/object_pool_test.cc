@@ -4,7 +4,15 @@
 #endif
 
 #include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "utility/versioned_object_pool.h"
+#include "utility/object_pool.h"
+#include "data_buffer.h"
 
 using namespace reinforcement_learning;
 using namespace reinforcement_learning::utility;
@@ -126,4 +134,234 @@ BOOST_AUTO_TEST_CASE(object_pool_init_size_test)
   BOOST_CHECK_EQUAL(guard3->_id, 2);
   BOOST_CHECK_EQUAL(new_factory->_count, 3);
 
-}
\ No newline at end of file
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_concurrent_update_factory)
+{
+  versioned_object_pool<my_object, my_object_factory> pool(new my_object_factory, 2);
+
+  // Boost.Test assertions are not thread safe, collect failures instead
+  std::atomic<int> failures(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&pool, &failures]() {
+      for (int i = 0; i < 10000; ++i) {
+        pooled_object_guard<my_object, my_object_factory> guard(pool, pool.get_or_create());
+        if (guard->_id < 0) ++failures;
+      }
+    });
+  }
+
+  // swap factories while request threads are running
+  for (int i = 0; i < 20; ++i) {
+    pool.update_factory(new my_object_factory);
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  BOOST_CHECK_EQUAL(failures, 0);
+
+  // idle objects all come from the latest factory
+  my_object_factory* factory = new my_object_factory;
+  pool.update_factory(factory);
+  const int created = factory->_count;
+  {
+    pooled_object_guard<my_object, my_object_factory> guard(pool, pool.get_or_create());
+    BOOST_CHECK_LT(guard->_id, created);
+  }
+  BOOST_CHECK_EQUAL(factory->_count, created);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_update_factory_prewarms_up_to_the_slots)
+{
+  using guard_t = pooled_object_guard<my_object, my_object_factory>;
+  versioned_object_pool<my_object, my_object_factory> pool(new my_object_factory);
+  const int capacity = static_cast<int>((std::max)(1u, std::thread::hardware_concurrency()) * 4);
+
+  // a burst holds more objects than the shards can keep, the extra ones are retired once returned
+  {
+    std::vector<std::unique_ptr<guard_t>> guards;
+    for (int i = 0; i < capacity + 10; ++i) {
+      guards.emplace_back(new guard_t(pool, pool.get_or_create()));
+    }
+  }
+
+  my_object_factory* factory = new my_object_factory;
+  pool.update_factory(factory);
+  BOOST_CHECK_EQUAL(factory->_count, capacity);
+
+  factory = new my_object_factory;
+  pool.update_factory(factory);
+  BOOST_CHECK_EQUAL(factory->_count, capacity);
+}
+
+class hooked_factory
+{
+public:
+  int _count;
+  std::function<void()> _on_create;
+
+  hooked_factory() : _count(0)
+  { }
+
+  my_object* operator()()
+  {
+    if (_on_create) {
+      auto on_create = std::move(_on_create);
+      _on_create = nullptr;
+      on_create();
+    }
+    return new my_object(_count++);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(object_pool_misses_during_update_count_against_their_generation)
+{
+  using guard_t = pooled_object_guard<my_object, hooked_factory>;
+  versioned_object_pool<my_object, hooked_factory> pool(new hooked_factory);
+  guard_t in_flight(pool, pool.get_or_create());
+
+  // another request misses while the new generation is being built, its object belongs to the old one
+  hooked_factory* factory = new hooked_factory;
+  factory->_on_create = [&pool] {
+    std::thread([&pool] { guard_t guard(pool, pool.get_or_create()); }).join();
+  };
+  pool.update_factory(factory);
+  BOOST_CHECK_EQUAL(factory->_count, 1);
+
+  // neither the evicted object nor the stale in-flight one inflates the next pre-warm
+  factory = new hooked_factory;
+  pool.update_factory(factory);
+  BOOST_CHECK_EQUAL(factory->_count, 1);
+}
+
+class tracked_object
+{
+public:
+  static std::atomic<int> destroyed;
+  static std::atomic<int> destroyed_on_caller;
+  std::thread::id _caller;
+
+  tracked_object() : _caller(std::this_thread::get_id())
+  { }
+
+  ~tracked_object()
+  {
+    if (std::this_thread::get_id() == _caller) ++destroyed_on_caller;
+    ++destroyed;
+  }
+};
+std::atomic<int> tracked_object::destroyed(0);
+std::atomic<int> tracked_object::destroyed_on_caller(0);
+
+class tracked_object_factory
+{
+public:
+  tracked_object* operator()()
+  {
+    return new tracked_object();
+  }
+};
+
+BOOST_AUTO_TEST_CASE(object_pool_stale_objects_reclaimed_in_background)
+{
+  tracked_object::destroyed = 0;
+  tracked_object::destroyed_on_caller = 0;
+  versioned_object_pool<tracked_object, tracked_object_factory> pool(new tracked_object_factory, 1);
+  {
+    pooled_object_guard<tracked_object, tracked_object_factory> guard(pool, pool.get_or_create());
+
+    // the new generation is pre-warmed by update_factory and the in-flight object becomes stale
+    pool.update_factory(new tracked_object_factory);
+  }
+
+  // the stale object returned above is destroyed by the reclaimer thread, not by this one
+  {
+    pooled_object_guard<tracked_object, tracked_object_factory> guard(pool, pool.get_or_create());
+  }
+  pool.update_factory(new tracked_object_factory);
+
+  // the stale in-flight object and the idle object evicted by the second update
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (tracked_object::destroyed < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_REQUIRE_EQUAL(tracked_object::destroyed, 2);
+  BOOST_CHECK_EQUAL(tracked_object::destroyed_on_caller, 0);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_reuses_the_smallest_large_enough_buffer)
+{
+  object_pool<data_buffer> pool(1024 * 1024, 60000);
+  {
+    auto small = pool.acquire(2 * 1024);
+    auto large = pool.acquire(64 * 1024);
+  }
+  BOOST_CHECK_EQUAL(pool.stats().misses, 2);
+  BOOST_CHECK_EQUAL(pool.stats().pooled_objects, 2);
+
+  auto medium = pool.acquire(16 * 1024);
+  BOOST_CHECK_GE(medium->capacity(), 16 * 1024);
+  auto any = pool.acquire();
+  BOOST_CHECK_LT(any->capacity(), 16 * 1024);
+
+  const auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.hits, 2);
+  BOOST_CHECK_EQUAL(stats.misses, 2);
+  BOOST_CHECK_EQUAL(stats.pooled_objects, 0);
+  BOOST_CHECK_EQUAL(stats.pooled_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_frees_buffers_over_the_cap)
+{
+  object_pool<data_buffer> pool(100 * 1024, 60000);
+  {
+    auto first = pool.acquire(64 * 1024);
+    auto second = pool.acquire(64 * 1024);
+  }
+  const auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.pooled_objects, 1);
+  BOOST_CHECK_EQUAL(stats.dropped, 1);
+  BOOST_CHECK_LE(stats.pooled_bytes, 100 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_trims_idle_buffers)
+{
+  object_pool<data_buffer> pool(1024 * 1024, 20);
+  {
+    auto first = pool.acquire(4 * 1024);
+    auto second = pool.acquire(4 * 1024);
+  }
+  pool.trim();
+  BOOST_CHECK_EQUAL(pool.stats().pooled_objects, 2);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  pool.trim();
+  const auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.trimmed, 2);
+  BOOST_CHECK_EQUAL(stats.pooled_objects, 0);
+  BOOST_CHECK_EQUAL(stats.pooled_bytes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_pool_released_from_other_threads)
+{
+  object_pool<data_buffer> pool(64 * 1024 * 1024, 60000);
+  const int count = 1000;
+  std::vector<std::thread> releasers;
+  for (int t = 0; t < 4; ++t) {
+    releasers.emplace_back([&pool] {
+      for (int i = 0; i < count; ++i) {
+        auto buffer = pool.acquire(1024 << (i % 4));
+        buffer->resize_body_region(1024 << (i % 4));
+      }
+    });
+  }
+  for (auto& t : releasers) t.join();
+
+  const auto stats = pool.stats();
+  BOOST_CHECK_EQUAL(stats.hits + stats.misses, 4 * count);
+  // at most one buffer per thread is out at a time
+  BOOST_CHECK_LE(stats.misses, 4);
+  BOOST_CHECK_EQUAL(stats.pooled_objects, stats.misses);
+}
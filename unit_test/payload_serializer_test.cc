@@ -51,6 +51,54 @@ BOOST_AUTO_TEST_CASE(cb_payload_serializer_test) {
   BOOST_CHECK_EQUAL(true, event->deferred_action());
 }
 
+BOOST_AUTO_TEST_CASE(cb_payload_serializer_back_to_back_test) {
+  // both payloads come from the same per-thread builder and must stay independent
+  cb_serializer serializer;
+  ranking_response rr1("event_id_1");
+  rr1.set_model_id("model_1");
+  rr1.push_back(0, 1.f);
+  ranking_response rr2("event_id_2");
+  rr2.set_model_id("model_2");
+  rr2.push_back(2, 0.5f);
+  rr2.push_back(1, 0.5f);
+
+  const auto buffer1 = serializer.event("context_1", 0, v2::LearningModeType_Online, rr1);
+  const auto buffer2 = serializer.event("context_2", 0, v2::LearningModeType_Online, rr2);
+  BOOST_CHECK(buffer1.data() != buffer2.data());
+
+  const auto event1 = v2::GetCbEvent(buffer1.data());
+  const auto event2 = v2::GetCbEvent(buffer2.data());
+  BOOST_CHECK_EQUAL("model_1", event1->model_id()->c_str());
+  BOOST_CHECK_EQUAL("model_2", event2->model_id()->c_str());
+  BOOST_CHECK_EQUAL(1, event1->action_ids()->size());
+  BOOST_CHECK_EQUAL(2, event2->action_ids()->size());
+  BOOST_CHECK_EQUAL(3, (*event2->action_ids())[0]);
+  BOOST_CHECK_EQUAL(false, event1->deferred_action());
+
+  std::string context;
+  copy(event2->context()->begin(), event2->context()->end(), std::back_inserter(context));
+  BOOST_CHECK_EQUAL("context_2", context.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(pooled_flatbuffer_allocator_test) {
+  pooled_flatbuffer_allocator allocator;
+
+  // freed blocks are handed out again for any size of the same class
+  auto* p1 = allocator.allocate(1000);
+  allocator.deallocate(p1, 1000);
+  auto* p2 = allocator.allocate(900);
+  BOOST_CHECK(p1 == p2);
+
+  auto* p3 = allocator.allocate(900);
+  BOOST_CHECK(p2 != p3);
+  allocator.deallocate(p2, 900);
+  allocator.deallocate(p3, 900);
+
+  // blocks bigger than the largest class are not pooled
+  auto* big = allocator.allocate(16 * 1024 * 1024);
+  allocator.deallocate(big, 16 * 1024 * 1024);
+}
+
 BOOST_AUTO_TEST_CASE(ca_payload_serializer_test)
 {
   ca_serializer serializer;
@@ -113,6 +161,38 @@ BOOST_AUTO_TEST_CASE(multi_slot_payload_serializer_test){
   BOOST_CHECK_EQUAL(false, event->deferred_action());
 }
 
+BOOST_AUTO_TEST_CASE(multistep_payload_serializer_test) {
+  multistep_serializer serializer;
+  ranking_response rr("event_id");
+  rr.set_model_id("model_id");
+  rr.push_back(1, 0.2f);
+  rr.push_back(0, 0.8f);
+
+  const auto buffer = serializer.event("my_context", "previous_id", action_flags::DEFERRED, rr);
+  // the next event reuses the same per-thread builder
+  const auto other = serializer.event("other_context", nullptr, action_flags::DEFAULT, rr);
+
+  const auto event = v2::GetMultiStepEvent(buffer.data());
+  BOOST_CHECK_EQUAL("event_id", event->event_id()->c_str());
+  BOOST_CHECK_EQUAL("previous_id", event->previous_id()->c_str());
+  BOOST_CHECK_EQUAL("model_id", event->model_id()->c_str());
+  BOOST_CHECK_EQUAL(true, event->deferred_action());
+
+  std::string context;
+  copy(event->context()->begin(), event->context()->end(), std::back_inserter(context));
+  BOOST_CHECK_EQUAL("my_context", context.c_str());
+
+  BOOST_REQUIRE_EQUAL(2, event->action_ids()->size());
+  BOOST_CHECK_EQUAL(2, (*event->action_ids())[0]);
+  BOOST_CHECK_EQUAL(1, (*event->action_ids())[1]);
+  BOOST_CHECK_CLOSE(0.2f, (*event->probabilities())[0], tolerance);
+  BOOST_CHECK_CLOSE(0.8f, (*event->probabilities())[1], tolerance);
+
+  const auto other_event = v2::GetMultiStepEvent(other.data());
+  BOOST_CHECK(other_event->previous_id() == nullptr);
+  BOOST_CHECK_EQUAL(false, other_event->deferred_action());
+}
+
 BOOST_AUTO_TEST_CASE(outcome_string_single_payload_serializer_test) {
   outcome_serializer serializer;
 
@@ -34,6 +34,54 @@ BOOST_AUTO_TEST_CASE(safe_vw_1)
     ranking_expected.begin(), ranking_expected.end());
 }
 
+BOOST_AUTO_TEST_CASE(safe_vw_rank_in_situ)
+{
+  safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  const std::string json = R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})";
+  std::vector<float> ranking_expected = { .8f, .1f, .1f };
+
+  // caller-owned mutable buffer, parsed in place
+  std::vector<char> buffer(json.begin(), json.end());
+  buffer.push_back('\0');
+
+  std::vector<int> actions;
+  std::vector<float> ranking;
+  vw.rank_in_situ(buffer.data(), json.size(), actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+  // const input goes through the per-thread scratch buffer and leaves the context untouched
+  vw.rank(json.c_str(), actions, ranking);
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+  BOOST_CHECK_EQUAL(json, R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})");
+}
+
+BOOST_AUTO_TEST_CASE(safe_vw_rank_with_action_cache)
+{
+  safe_vw vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  safe_vw cached_vw((const char*)cb_data_5_model, cb_data_5_model_len);
+  // smaller than the action count so that entries are evicted while a context is resolved
+  cached_vw.enable_action_cache(2);
+
+  const std::vector<std::string> contexts = {
+    R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})",
+    R"({"a":{"0":3,"5":1},"_multi":[{"b":{"0":3}},{"b":{"0":1}},{"b":{"0":4}}]})",
+    R"({"a":{"0":2},"_multi":[ {"b":{"0":2}} , {"b":{"0":5,"1":1}} ]})"
+  };
+
+  for (const auto& json : contexts) {
+    // first pass parses the actions, the second one is served from the cache
+    for (int pass = 0; pass < 2; ++pass) {
+      std::vector<int> actions, cached_actions;
+      std::vector<float> ranking, cached_ranking;
+      vw.rank(json.c_str(), actions, ranking);
+      cached_vw.rank(json.c_str(), cached_actions, cached_ranking);
+
+      BOOST_CHECK_EQUAL_COLLECTIONS(cached_actions.begin(), cached_actions.end(), actions.begin(), actions.end());
+      BOOST_CHECK_EQUAL_COLLECTIONS(cached_ranking.begin(), cached_ranking.end(), ranking.begin(), ranking.end());
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(factory_with_cb_model_and_ccb_arguments)
 {  
   const auto json = R"({ "GUser":{"id":"rnc", "major" : "engineering", "hobby" : "hiking", "favorite_character" : "spock"}, "_multi" : [{ "TAction":{"topic":"SkiConditions-VT"} }, { "TAction":{"topic":"HerbGarden"} }, { "TAction":{"topic":"BeyBlades"} }, { "TAction":{"topic":"NYCLiving"} }, { "TAction":{"topic":"MachineLearning"} }], "_slots" : [{ "_size":"large"}, { "_size":"medium" }, { "_size":"small" }]  })";
@@ -141,3 +189,30 @@ BOOST_AUTO_TEST_CASE(factory_with_empty_model) {
     BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
   }
 }
+
+BOOST_AUTO_TEST_CASE(factory_with_shared_weights) {
+  const auto json = R"({"a":{"0":1,"5":2},"_multi":[{"b":{"0":1}},{"b":{"0":2}},{"b":{"0":3}}]})";
+  std::vector<float> ranking_expected = { .8f, .1f, .1f };
+
+  model_management::model_data model_data;
+  get_model_data_from_raw((const char*)cb_data_5_model, cb_data_5_model_len, &model_data);
+
+  // all pooled instances are seeded from a single master
+  const auto factory = new safe_vw_factory(model_data);
+  factory->share_weights();
+  versioned_object_pool<safe_vw, safe_vw_factory> pool(factory, 2);
+
+  {
+    pooled_vw vw1(pool, pool.get_or_create());
+    pooled_vw vw2(pool, pool.get_or_create());
+    BOOST_CHECK(vw1.get() != vw2.get());
+
+    std::vector<int> actions;
+    std::vector<float> ranking;
+    vw1->rank(json, actions, ranking);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+
+    vw2->rank(json, actions, ranking);
+    BOOST_CHECK_EQUAL_COLLECTIONS(ranking.begin(), ranking.end(), ranking_expected.begin(), ranking_expected.end());
+  }
+}
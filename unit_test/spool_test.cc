@@ -0,0 +1,239 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include "logger/spool/segment_spool.h"
+#include "logger/spool/spool_sender.h"
+#include "api_status.h"
+#include "err_constants.h"
+#include "error_callback_fn.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace rl = reinforcement_learning;
+namespace rspool = reinforcement_learning::logger::spool;
+namespace rerr = reinforcement_learning::error_code;
+namespace rutil = reinforcement_learning::utility;
+
+namespace {
+  void clear_spool_directory(const std::string& directory) {
+    std::vector<std::string> names;
+    if (rspool::list_files(directory, "", names, nullptr) != rerr::success) return;
+    for (const auto& name : names) {
+      if (name != "." && name != "..") rspool::remove_file(directory + "/" + name);
+    }
+  }
+
+  std::string front_string(rspool::segment_spool& spool) {
+    const uint8_t* data;
+    size_t size;
+    if (!spool.front(data, size)) return "";
+    return std::string(reinterpret_cast<const char*>(data), size);
+  }
+
+  int append_string(rspool::segment_spool& spool, const std::string& record) {
+    return spool.append(reinterpret_cast<const uint8_t*>(record.data()), record.size(), nullptr);
+  }
+
+  rl::i_sender::buffer make_batch(const std::string& body) {
+    auto db = std::make_shared<rutil::data_buffer>(body.size());
+    std::copy(body.begin(), body.end(), db->body_begin());
+    db->set_body_endoffset(db->preamble_size() + body.size());
+    std::fill(db->preamble_begin(), db->body_begin(), static_cast<uint8_t>(body.size()));
+    return db;
+  }
+
+  std::string batch_bytes(const rl::i_sender::buffer& db) {
+    return std::string(reinterpret_cast<const char*>(db->preamble_begin()), db->buffer_filled_size());
+  }
+
+  // fails every send while down is set
+  class flaky_sender : public rl::i_sender {
+  public:
+    flaky_sender(std::atomic<bool>& down, std::mutex& mutex, std::vector<std::string>& sent)
+      : _down(down), _mutex(mutex), _sent(sent) {}
+    int init(const rutil::configuration&, rl::api_status*) override { return rerr::success; }
+
+  protected:
+    int v_send(const buffer& data, rl::api_status* status) override {
+      if (_down) {
+        RETURN_ERROR_LS(nullptr, status, http_bad_status_code) << " sender down";
+      }
+      std::lock_guard<std::mutex> lock(_mutex);
+      _sent.push_back(batch_bytes(data));
+      return rerr::success;
+    }
+
+  private:
+    std::atomic<bool>& _down;
+    std::mutex& _mutex;
+    std::vector<std::string>& _sent;
+  };
+
+  void count_errors(const rl::api_status&, void* counter) {
+    ++*static_cast<std::atomic<int>*>(counter);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(segment_spool_replay_order_and_recovery) {
+  const std::string directory("segment_spool_test");
+  rspool::make_directory(directory, nullptr);
+  clear_spool_directory(directory);
+  {
+    rspool::segment_spool spool(directory, "test", 64, 1024, nullptr);
+    BOOST_REQUIRE_EQUAL(spool.init(nullptr), rerr::success);
+    BOOST_CHECK(spool.empty());
+
+    BOOST_CHECK_EQUAL(append_string(spool, "first"), rerr::success);
+    BOOST_CHECK_EQUAL(append_string(spool, "second"), rerr::success);
+    // bigger than a segment
+    BOOST_CHECK_EQUAL(append_string(spool, std::string(100, 'x')), rerr::success);
+    BOOST_CHECK_EQUAL(append_string(spool, "fourth"), rerr::success);
+    BOOST_CHECK_EQUAL(spool.pending_bytes(), 117);
+
+    BOOST_CHECK_EQUAL(front_string(spool), "first");
+    spool.pop_front();
+    BOOST_CHECK_EQUAL(front_string(spool), "second");
+  }
+  {
+    // a new process resumes after the replayed records
+    rspool::segment_spool spool(directory, "test", 64, 1024, nullptr);
+    BOOST_REQUIRE_EQUAL(spool.init(nullptr), rerr::success);
+    BOOST_CHECK_EQUAL(front_string(spool), "second");
+    spool.pop_front();
+    BOOST_CHECK_EQUAL(front_string(spool), std::string(100, 'x'));
+    spool.pop_front();
+    BOOST_CHECK_EQUAL(append_string(spool, "fifth"), rerr::success);
+    BOOST_CHECK_EQUAL(front_string(spool), "fourth");
+    spool.pop_front();
+    BOOST_CHECK_EQUAL(front_string(spool), "fifth");
+    spool.pop_front();
+    BOOST_CHECK(spool.empty());
+    // only the segment being written is left
+    BOOST_CHECK_EQUAL(spool.disk_bytes(), 64);
+  }
+  {
+    // nothing left to replay, nothing left on disk
+    rspool::segment_spool spool(directory, "test", 64, 1024, nullptr);
+    BOOST_REQUIRE_EQUAL(spool.init(nullptr), rerr::success);
+    BOOST_CHECK(spool.empty());
+    BOOST_CHECK_EQUAL(spool.disk_bytes(), 0);
+  }
+  clear_spool_directory(directory);
+}
+
+BOOST_AUTO_TEST_CASE(segment_spool_disk_budget) {
+  const std::string directory("segment_spool_budget_test");
+  rspool::make_directory(directory, nullptr);
+  clear_spool_directory(directory);
+  {
+    rspool::segment_spool spool(directory, "test", 64, 128, nullptr);
+    BOOST_REQUIRE_EQUAL(spool.init(nullptr), rerr::success);
+    const std::string record(40, 'r');
+    BOOST_CHECK_EQUAL(append_string(spool, record), rerr::success);
+    BOOST_CHECK_EQUAL(append_string(spool, record), rerr::success);
+    rl::api_status status;
+    BOOST_CHECK_EQUAL(spool.append(reinterpret_cast<const uint8_t*>(record.data()), record.size(), &status), rerr::spool_full);
+
+    // replaying frees the disk
+    spool.pop_front();
+    BOOST_CHECK_EQUAL(append_string(spool, record), rerr::success);
+  }
+  clear_spool_directory(directory);
+}
+
+BOOST_AUTO_TEST_CASE(segment_spool_open_failure) {
+  const std::string directory("segment_spool_open_test");
+  rspool::make_directory(directory, nullptr);
+  clear_spool_directory(directory);
+  {
+    rspool::segment_spool spool(directory, "test", 64, 1024, nullptr);
+    BOOST_REQUIRE_EQUAL(spool.init(nullptr), rerr::success);
+    // a directory in the way of the next segment
+    rspool::make_directory(directory + "/test.0.spool", nullptr);
+    rl::api_status status;
+    const std::string record("record");
+    BOOST_CHECK_EQUAL(spool.append(reinterpret_cast<const uint8_t*>(record.data()), record.size(), &status), rerr::spool_error);
+    BOOST_CHECK(spool.empty());
+    BOOST_CHECK_EQUAL(spool.disk_bytes(), 0);
+  }
+  clear_spool_directory(directory);
+
+  // the sender reports the batch it can neither send nor spool and drops it
+  std::atomic<bool> down{ true };
+  std::mutex mutex;
+  std::vector<std::string> sent;
+  std::atomic<int> errors{ 0 };
+  rl::error_callback_fn error_cb(count_errors, &errors);
+
+  rutil::spool_config config;
+  config.directory = directory;
+  config.segment_size = 1024;
+  {
+    rspool::spool_sender sender(new flaky_sender(down, mutex, sent), config, "interaction", nullptr, &error_cb);
+    rutil::configuration cfg;
+    BOOST_REQUIRE_EQUAL(sender.init(cfg, nullptr), rerr::success);
+    rspool::make_directory(directory + "/interaction.0.spool", nullptr);
+    BOOST_CHECK_EQUAL(sender.send(make_batch("one")), rerr::success);
+    // the failed send and the failed spill
+    for (int i = 0; i < 200 && errors < 2; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL(errors, 2);
+  }
+  BOOST_CHECK(sent.empty());
+  clear_spool_directory(directory);
+}
+
+BOOST_AUTO_TEST_CASE(spool_sender_replays_after_sender_recovers) {
+  const std::string directory("spool_sender_test");
+  rspool::make_directory(directory, nullptr);
+  clear_spool_directory(directory);
+
+  std::atomic<bool> down{ true };
+  std::mutex mutex;
+  std::vector<std::string> sent;
+  std::atomic<int> errors{ 0 };
+  rl::error_callback_fn error_cb(count_errors, &errors);
+
+  rutil::spool_config config;
+  config.directory = directory;
+  config.segment_size = 1024;
+  config.replay_bytes_per_sec = 0;
+  const std::vector<std::string> bodies = { "one", "two", "three" };
+  {
+    rspool::spool_sender sender(new flaky_sender(down, mutex, sent), config, "interaction", nullptr, &error_cb);
+    rutil::configuration cfg;
+    BOOST_REQUIRE_EQUAL(sender.init(cfg, nullptr), rerr::success);
+    for (const auto& body : bodies) {
+      BOOST_CHECK_EQUAL(sender.send(make_batch(body)), rerr::success);
+    }
+    // every batch fails once and is spooled
+    for (int i = 0; i < 200 && errors < 3; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    BOOST_CHECK_EQUAL(errors, 3);
+
+    down = false;
+    for (int i = 0; i < 500; ++i) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (sent.size() == bodies.size()) break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+
+  BOOST_REQUIRE_EQUAL(sent.size(), bodies.size());
+  for (size_t i = 0; i < bodies.size(); ++i) {
+    BOOST_CHECK_EQUAL(sent[i], batch_bytes(make_batch(bodies[i])));
+  }
+  clear_spool_directory(directory);
+}
@@ -0,0 +1,80 @@
+#define BOOST_TEST_DYN_LINK
+#ifdef STAND_ALONE
+#   define BOOST_TEST_MODULE Main
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "utility/timer_queue.h"
+
+using namespace reinforcement_learning::utility;
+
+BOOST_AUTO_TEST_CASE(timer_queue_runs_tasks_in_deadline_order)
+{
+  std::mutex mutex;
+  std::vector<int> order;
+  std::promise<void> done;
+  timer_queue timer;
+  const auto record = [&mutex, &order](int i) {
+    std::lock_guard<std::mutex> lock(mutex);
+    order.push_back(i);
+  };
+
+  timer.schedule(std::chrono::milliseconds(60), [&record, &done] { record(3); done.set_value(); });
+  timer.schedule(std::chrono::milliseconds(20), [&record] { record(1); });
+  timer.schedule(std::chrono::milliseconds(40), [&record] { record(2); });
+  // due at the same time as the previous one, runs after it
+  timer.schedule(std::chrono::milliseconds(40), [&record] { record(21); });
+
+  BOOST_REQUIRE(done.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+  const std::vector<int> expected = { 1, 2, 21, 3 };
+  std::lock_guard<std::mutex> lock(mutex);
+  BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+  BOOST_CHECK_EQUAL(timer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(timer_queue_waits_for_the_delay)
+{
+  std::promise<timer_queue::clock::time_point> ran;
+  timer_queue timer;
+  const auto start = timer_queue::clock::now();
+  timer.schedule(std::chrono::milliseconds(50), [&ran] { ran.set_value(timer_queue::clock::now()); });
+  auto future = ran.get_future();
+  BOOST_REQUIRE(future.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+  BOOST_CHECK(future.get() - start >= std::chrono::milliseconds(50));
+}
+
+BOOST_AUTO_TEST_CASE(timer_queue_drops_waiting_tasks_at_destruction)
+{
+  std::atomic<int> count(0);
+  {
+    timer_queue timer;
+    timer.schedule(std::chrono::hours(1), [&count] { ++count; });
+    BOOST_CHECK_EQUAL(timer.size(), 1);
+  }
+  BOOST_CHECK_EQUAL(count, 0);
+}
+
+BOOST_AUTO_TEST_CASE(timer_queue_shared_while_held)
+{
+  auto first = timer_queue::shared();
+  auto second = timer_queue::shared();
+  BOOST_CHECK_EQUAL(first.get(), second.get());
+
+  std::promise<void> done;
+  first->schedule(std::chrono::milliseconds(0), [&done]() { done.set_value(); });
+  BOOST_CHECK(done.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+
+  // once released by every holder, the next user gets a running queue again
+  first.reset();
+  second.reset();
+  auto third = timer_queue::shared();
+  std::promise<void> again;
+  third->schedule(std::chrono::milliseconds(0), [&again]() { again.set_value(); });
+  BOOST_CHECK(again.get_future().wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+}